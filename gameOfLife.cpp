@@ -15,55 +15,282 @@
  are switched alive in a pattern that will begin that sequence. The program then goes
  through a loop of 100 updates of the Game.
 
- ** Input: User inputs the start position they would like to observe
+ ** Input: Command line options (see printUsage() in golOptions.cpp), then the user inputs
+ the start position they would like to observe, either a built in pattern or a
+ plaintext, RLE or Life 1.06 pattern file. With --pattern or --restore the menu is
+ skipped and that board is run once. A bounded board treats cells past the edge as
+ dead; a torus wraps them around to the other side. --rule runs another Life-like
+ rule in B/S notation (HighLife is B36/S23) instead of Conway's B3/S23.
+ GameOfLife --headless ... runs without menu, display or pauses and prints a JSON
+ report of the generation rate for benchmarking. A run ends early once the board
+ repeats (a still life, an oscillator or a dead board) and says which; --cycles sets
+ how many generations back a repeat is looked for, 0 turns this off.
+ --frames exports the generations as PBM, PGM or PNG files or a y4m video, cropped
+ and scaled with --crop and --frame-scale, from a background thread that drops frames
+ rather than ever hold the run up.
+ GameOfLife --census ... runs many random soups on every cpu until they settle and
+ prints a JSON count of the still lifes, oscillators and spaceships they leave.
+ GameOfLife --scaling [rows columns generations threads] instead prints how the
+ multithreaded stepper scales with the number of threads.
  ** Output: 1) Prompt for user input
- 2) 100 iterations of the chosen pattern
+ 2) 100 iterations of the chosen pattern (or --generations), drawn in place; arrows
+ or wasd pan, + and - zoom, f fits the board and q ends the run
  *******************************************************************************************************/
 
 
 #include <iostream>
 #include <string>
+#include <cstdlib>
+#include <stdexcept>
 #include <unistd.h>
 #include "golFunctions.hpp"
+#include "golEngine.hpp"
+#include "golParallel.hpp"
+#include "golOptions.hpp"
+#include "golHeadless.hpp"
+#include "golCensus.hpp"
+#include "golStats.hpp"
+#include "golCheckpoint.hpp"
+#include "golRender.hpp"
+#include "golFrames.hpp"
 
+/*********************************************************************
+ ** Function: Report Cycle
+ ** Description: after a run that stopped on a repeating board, says what the
+ board settled into and where
+ *********************************************************************/
+static void reportCycle(const Simulation &simulation, Engine &engine)
+{
+  const CycleDetector *cycles = simulation.cycles();
+  if (cycles == NULL || !cycles->found())
+    return;
+
+  if (engine.population() == 0)
+    std::cout << "The board died out";
+  else if (cycles->period() == 1)
+    std::cout << "The board is a still life";
+  else
+    std::cout << "The board repeats every " << cycles->period() << " generations";
+  std::cout << " from generation " << cycles->start() << "; stopped at generation "
+            << engine.generation() << std::endl;
+}
+
+/** finishes the frame export, if any, and says what did not make it out **/
+static void reportFrames(FrameExporter *frames)
+{
+  if (frames == NULL)
+    return;
+
+  frames->close();
+  if (frames->dropped() > 0 || frames->subsampled() > 0)
+    std::cout << frames->written() << " frames written; " << frames->dropped() + frames->subsampled()
+              << " skipped while the encoder caught up" << std::endl;
+  if (frames->failed() > 0)
+    std::cerr << frames->failed() << " frames failed: " << frames->lastError() << std::endl;
+}
 
-int main()
+int main(int argc, char *argv[])
 {
-  int choice = 1;
+  int choice = 1,
+      rows = ROWS,
+      columns = COLUMNS;
+
+  /** scaling report: threads 1, 2, 4 ... up to every cpu **/
+  if (argc >= 2 && std::string(argv[1]) == "--scaling")
+  {
+    int size = argc > 2 ? std::atoi(argv[2]) : 4096;
+    int width = argc > 3 ? std::atoi(argv[3]) : size;
+    long long generations = argc > 4 ? std::atoll(argv[4]) : 100;
+    int threads = argc > 5 ? std::atoi(argv[5]) : hardwareThreads();
+
+    if (size <= 0 || width <= 0 || generations <= 0 || threads <= 0)
+    {
+      std::cerr << "usage: GameOfLife --scaling [rows columns generations threads]" << std::endl;
+      return 1;
+    }
+    reportScaling(size, width, generations, threads, std::cout);
+    return 0;
+  }
+
+  Options options;
+  std::unique_ptr<StatsSession> stats;
+  try
+  {
+    options = parseOptions(argc, argv);
+    stats.reset(new StatsSession(options));
+    if (options.census)
+      return runCensus(options, std::cout);
+    if (options.headless)
+      return runHeadless(options, std::cout);
+  }
+  catch (const std::exception &error)
+  {
+    std::cerr << error.what() << std::endl;
+    if (dynamic_cast<const std::invalid_argument *>(&error) != NULL)
+      printUsage(std::cerr);
+    return 1;
+  }
 
-  /** define GameOfLife and temp arrays and initialize the game to NULL **/
-  char gameOfLife[ROWS][COLUMNS] = {},
-       temp[ROWS][COLUMNS] = {};
+  /** board size, engine, rule and edge may be picked at runtime, defaults to ROWSxCOLUMNS **/
+  if (options.rows > 0)
+  {
+    rows = options.rows;
+    columns = options.columns;
+  }
+  const long long generations = options.generations >= 0 ? options.generations : 100;
+
+  /**
+   ** a board given on the command line is read before the engine is made: a
+   ** checkpoint brings its own size and rule, and an RLE pattern may name a rule
+   **/
+  Rule rule;
+  BitGrid start;
+  CheckpointInfo info;
+  std::unique_ptr<Engine> engine;
+  try
+  {
+    if (!options.rule.empty())
+      rule = Rule::parse(options.rule);
+    if (!options.restore.empty())
+    {
+      start = loadCheckpoint(options.restore, &info);
+      if (!options.rule.empty() && info.rule != rule)
+        throw std::runtime_error(options.restore + ": checkpoint runs " + info.rule.notation()
+                                 + ", not the requested --rule");
+      rows = info.rows;
+      columns = info.columns;
+      rule = info.rule;
+    }
+    else if (options.pattern == "soup")
+    {
+      start = BitGrid(rows, columns);
+      fillSoup(start, options.density, options.seed);
+    }
+    else if (!options.pattern.empty())
+    {
+      start = BitGrid(rows, columns);
+      BitGridSink sink(start);
+      loadPattern(options.pattern, sink);
+      if (options.rule.empty() && !sink.patternRule().empty())
+        rule = Rule::parse(sink.patternRule());
+    }
+
+    if (!options.checkpoint.empty() && rule.states() > 2)
+      throw std::invalid_argument("--checkpoint: checkpoints cannot hold the dying states of "
+                                  + rule.notation());
+    engine = makeEngine(options.engine, rows, columns, options.threads, options.topology, rule,
+                        options.depth);
+  }
+  catch (const std::exception &error)
+  {
+    std::cerr << error.what() << std::endl;
+    return 1;
+  }
+
+  /** define the GameOfLife board the menu seeds **/
+  Grid gameOfLife(rows, columns);
+
+  /** the board is redrawn at --fps; the generations go by at --speed (10 a second) **/
+  Simulation simulation(*engine);
+  TerminalDisplay display(simulation, options.fps, options.speed >= 0 ? options.speed : 10);
+  simulation.addObserver(&display);
+  /** a board that repeats ends the run early (--cycles 0 runs every generation) **/
+  simulation.detectCycles((std::size_t)options.cycles, CYCLE_STOP);
+
+  std::unique_ptr<CheckpointWriter> writer;
+  if (!options.checkpoint.empty())
+  {
+    writer.reset(new CheckpointWriter(options.checkpoint, options.compress));
+    simulation.addObserver(writer.get(), options.checkpointEvery);
+  }
+  /** --frames exports every run in the background (each run restarts at generation 0) **/
+  std::unique_ptr<FrameExporter> frames;
+  if (!options.frames.empty())
+  {
+    try
+    {
+      frames.reset(new FrameExporter(options.frames, options.frameView, rows, columns,
+                                     options.frameRate));
+    }
+    catch (const std::exception &error)
+    {
+      std::cerr << error.what() << std::endl;
+      return 1;
+    }
+    simulation.addObserver(frames.get(), options.framesEvery);
+  }
+
+  if (!options.pattern.empty() || !options.restore.empty())
+  {
+    if (!options.restore.empty())
+    {
+      engine->adoptBits(start);
+      engine->setGeneration(info.generation);
+    }
+    else
+      engine->loadBits(start);
+    start = BitGrid();
+
+    display.open(*engine);
+    simulation.run(generations);
+    display.close(*engine);
+    reportCycle(simulation, *engine);
+    reportFrames(frames.get());
+    return 0;
+  }
+
+  const int fileChoice = patternCount() + 1;
 
   while (choice > 0) //loop as long as user desires
   {
 
+    std::cout << "\nPlease enter your choice in pattern\n";
+    for (int i = 0; i < patternCount(); i++)
+      std::cout << "\tEnter " << i + 1 << " for " << patternEntry(i).title << "\n";
     std::cout
-      << "\nPlease enter your choice in pattern\n"
-      << "\tEnter 1 for Pulsar\n"
-      << "\tEnter 2 for Gliders\n"
-      << "\tEnter 3 for Glider Cannon: Gosper's Glider Gun\n"
-      << "\tEnter 4 for Queen Bee Shuttle\n"
+      << "\tEnter " << fileChoice << " to load a pattern file (.cells, .rle, .lif)\n"
       << "\tEnter 0 to quit" << std::endl;
 
     std::cin >> choice; //get user's choice
 
-    if (choice > 0 && choice <= LAST_PATTERN )
+    if (choice == fileChoice)
+    {
+      std::string path;
+      std::cout << "Pattern file: ";
+      std::cin >> path;
+
+      gameOfLife.clear();
+      try
+      {
+        GridSink sink(gameOfLife);
+        loadPatternFile(path, sink);
+      }
+      catch (const std::exception &error)
+      {
+        std::cerr << error.what() << std::endl;
+        continue;
+      }
+      engine->load(gameOfLife);
+      display.open(*engine);
+      simulation.run(generations);
+      display.close(*engine);
+      reportCycle(simulation, *engine);
+    }
+    else if (choice > 0 && choice <= patternCount())
     {
       seedGameboard(gameOfLife, choice);
+      engine->load(gameOfLife);
       /*
-       ** for loop prints the board and updates the game 100 times
-       ** usleep() institues a pause that allows the changes to be followed
-       as they are printed.
+       ** run 100 generations (or --generations); the display redraws only the cells that
+       changed, and holds the run to --speed so the changes can be followed on screen.
        */
-      for (int i = 0; i < 100; i++)
-      {
-        printGame(gameOfLife);
-        SLEEP();
-        updateGame(gameOfLife, temp);
-      }
+      display.open(*engine);
+      simulation.run(generations);
+      display.close(*engine);
+      reportCycle(simulation, *engine);
     }
   }
 
+  reportFrames(frames.get());
   return 0;
 }
@@ -0,0 +1,123 @@
+/**************************************************************************************************
+ ** Program       Filename: GameOfLife
+ ** Current       File: golArena.cpp
+ ** Author:       Jordan Grant
+ ** Date:         10.17.26
+ ** Description: 	Size classed buffer arena (see golArena.hpp). Classes are 64, 128, 192
+ and 256 bytes, then four evenly spaced sizes in every power of two up to ARENA_LARGEST,
+ so a buffer never wastes more than a quarter of itself. Each thread keeps its own free
+ lists, so taking and returning a buffer needs no lock.
+ *****************************************************************************************************/
+
+#include "golArena.hpp"
+
+#include <new>
+
+/** 4 classes up to 256 bytes, then 4 per power of two from 512 to ARENA_LARGEST **/
+#define ARENA_CLASSES (4 + 4 * (63 - __builtin_clzll(ARENA_LARGEST) - 8))
+
+/*********************************************************************
+ ** Function: Size Class
+ ** Description: the class a request of bytes bytes falls in, and its size
+ ** Pre-Conditions: 0 < bytes <= ARENA_LARGEST
+ *********************************************************************/
+static int sizeClass(std::size_t bytes, std::size_t &classBytes)
+{
+  if (bytes <= 4 * CACHE_LINE)
+  {
+    std::size_t lines = (bytes + CACHE_LINE - 1) / CACHE_LINE;
+    classBytes = lines * CACHE_LINE;
+    return (int)lines - 1;
+  }
+
+  /** 2^power < bytes <= 2^(power + 1), split into four steps of 2^(power - 2) **/
+  int power = 63 - __builtin_clzll(bytes - 1);
+  std::size_t step = (std::size_t)1 << (power - 2);
+  std::size_t steps = (bytes + step - 1) / step;
+
+  classBytes = steps * step;
+  return 4 + 4 * (power - 8) + (int)steps - 5;
+}
+
+static void *systemAllocate(std::size_t bytes)
+{
+  return ::operator new(bytes, std::align_val_t(CACHE_LINE));
+}
+
+static void systemRelease(void *buffer)
+{
+  ::operator delete(buffer, std::align_val_t(CACHE_LINE));
+}
+
+/*********************************************************************
+ ** Struct: ArenaCache
+ ** Description: one thread's free buffers, returned to the system when the
+ thread exits
+ *********************************************************************/
+struct ArenaCache
+{
+  void *buffers[ARENA_CLASSES][ARENA_KEEP];
+  int counts[ARENA_CLASSES];
+  std::size_t keptBytes;
+
+  ArenaCache() : counts(), keptBytes(0) {}
+  ~ArenaCache();
+};
+
+static thread_local ArenaCache cache;
+/** set once the cache is gone, for boards freed by static destructors after it **/
+static thread_local bool cacheClosed = false;
+
+ArenaCache::~ArenaCache()
+{
+  for (int c = 0; c < ARENA_CLASSES; c++)
+    for (int i = 0; i < counts[c]; i++)
+      systemRelease(buffers[c][i]);
+  cacheClosed = true;
+}
+
+std::size_t arenaReserved(std::size_t bytes)
+{
+  std::size_t classBytes = bytes;
+
+  if (bytes > 0 && bytes <= ARENA_LARGEST)
+    sizeClass(bytes, classBytes);
+  return classBytes;
+}
+
+void *arenaAllocate(std::size_t bytes)
+{
+  if (bytes == 0 || bytes > ARENA_LARGEST || cacheClosed)
+    return systemAllocate(bytes > 0 ? bytes : 1);
+
+  std::size_t classBytes;
+  int c = sizeClass(bytes, classBytes);
+  if (cache.counts[c] > 0)
+  {
+    cache.keptBytes -= classBytes;
+    return cache.buffers[c][--cache.counts[c]];
+  }
+  return systemAllocate(classBytes);
+}
+
+void arenaRelease(void *buffer, std::size_t bytes)
+{
+  if (buffer == NULL)
+    return;
+  if (bytes == 0 || bytes > ARENA_LARGEST || cacheClosed)
+  {
+    systemRelease(buffer);
+    return;
+  }
+
+  std::size_t classBytes;
+  int c = sizeClass(bytes, classBytes);
+  if (cache.counts[c] == ARENA_KEEP || cache.keptBytes + classBytes > ARENA_KEEP_BYTES)
+  {
+    systemRelease(buffer);
+    return;
+  }
+
+  cache.buffers[c][cache.counts[c]++] = buffer;
+  cache.keptBytes += classBytes;
+}
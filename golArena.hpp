@@ -0,0 +1,114 @@
+/************************************************************************************************
+ ** Program       Filename: GameOfLife
+ ** Current       File: golArena.hpp
+ ** Author:       Jordan Grant
+ ** Date:         10.17.26
+ ** Description: 	Memory reuse for boards and engine structures. Board buffers come from
+ arenaAllocate(), which rounds a request up to a size class (four per power of two) and
+ serves it from a per-thread free list of buffers released earlier, so boards that are
+ made and dropped again (stored copies, hash scratch boards, census soups) stop reaching
+ the system allocator after the first time. Chunks and quadtree nodes come from a
+ BlockPool: fixed size items carved out of arena blocks and recycled through an
+ intrusive free list. Together they let a settled run step without any heap allocation.
+ **************************************************************************************************/
+
+
+#ifndef GOLARENA_HPP
+#define GOLARENA_HPP
+
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+#include "golGrid.hpp"
+
+/** buffers larger than this bypass the size classes and go straight to the system **/
+#define ARENA_LARGEST ((std::size_t)1 << 26)
+/** free buffers a thread keeps per size class, and in all **/
+#define ARENA_KEEP 4
+#define ARENA_KEEP_BYTES ((std::size_t)1 << 28)
+
+/*********************************************************************
+ ** Function: Arena Allocate / Arena Release
+ ** Description: a CACHE_LINE aligned buffer of at least bytes bytes, reused
+ from the calling thread's free list when one of the same size class is
+ there. A buffer may be released by any thread, with the size it was asked
+ for; it then joins that thread's list, unless the list is full.
+ ** Post-Conditions: arenaAllocate() throws std::bad_alloc when out of memory;
+ the buffer's contents are undefined
+ *********************************************************************/
+void *arenaAllocate(std::size_t bytes);
+void arenaRelease(void *buffer, std::size_t bytes);
+
+/** the bytes really set aside for a request of bytes bytes **/
+std::size_t arenaReserved(std::size_t bytes);
+
+/*********************************************************************
+ ** Class: BlockPool
+ ** Description: items of type T handed out BLOCK at a time from zeroed arena
+ blocks. Released items are chained through their LINK member and handed
+ out again before a new block is taken; blocks are only returned when the
+ pool is destroyed. block() exposes every item ever carved, in use or not,
+ for owners that sweep their items (HashLife's collection).
+ ** Pre-Conditions: T is trivially copyable; an all zero T is a valid unused item
+ *********************************************************************/
+template <class T, T *T::*LINK, std::size_t BLOCK>
+class BlockPool
+{
+public:
+  BlockPool() : freeItems(NULL) {}
+
+  ~BlockPool()
+  {
+    for (std::size_t i = 0; i < blocks.size(); i++)
+      arenaRelease(blocks[i], BLOCK * sizeof(T));
+  }
+
+  T *allocate()
+  {
+    if (freeItems == NULL)
+      grow();
+
+    T *item = freeItems;
+    freeItems = item->*LINK;
+    return item;
+  }
+
+  void release(T *item)
+  {
+    item->*LINK = freeItems;
+    freeItems = item;
+  }
+
+  std::size_t blockCount() const { return blocks.size(); }
+  T *block(std::size_t index) { return blocks[index]; }
+  std::size_t memoryBytes() const
+  {
+    return blocks.size() * arenaReserved(BLOCK * sizeof(T)) + blocks.capacity() * sizeof(T *);
+  }
+
+private:
+  BlockPool(const BlockPool &);
+  BlockPool &operator=(const BlockPool &);
+
+  static_assert(std::is_trivially_copyable<T>::value, "BlockPool items must be plain data");
+
+  void grow()
+  {
+    /** room for the block's pointer first, so the push_back below cannot throw **/
+    if (blocks.size() == blocks.capacity())
+      blocks.reserve(blocks.size() * 2 + 8);
+
+    T *block = static_cast<T *>(arenaAllocate(BLOCK * sizeof(T)));
+    std::memset(static_cast<void *>(block), 0, BLOCK * sizeof(T));
+    blocks.push_back(block);
+
+    for (std::size_t i = BLOCK; i-- > 0;)
+      release(&block[i]);
+  }
+
+  std::vector<T *> blocks;
+  T *freeItems;
+};
+
+#endif
@@ -0,0 +1,260 @@
+/**************************************************************************************************
+ ** Program       Filename: GameOfLife
+ ** Current       File: golBench.cpp
+ ** Author:       Jordan Grant
+ ** Date:         10.17.26
+ ** Description: 	Microbenchmark suite (Google Benchmark), built and run by `make bench`.
+ Covers the original char array functions (updateGame, neighbors + liveOrDie, copy) on
+ the fixed ROWSxCOLUMNS board, the Grid versions and every engine on square boards from
+ L1 resident (64x64) to far past the last level cache (16384x16384 is 256MB per char
+ buffer), each seeded with the four PATTERNS and a random soup; the distributed engine
+ runs BENCH_PROCESSES worker processes. Every result reports cells/sec (cell updates per
+ second) and bytes/cell (engine memory over board cells).
+ The rule/ benchmarks run the bit engine under each rule with a kernel of its own and
+ one (B36/S125) that takes the generic kernel, and the char and generations engines under
+ Generations rules of 3, 4 and 256 states.
+ Filter with --benchmark_filter=REGEX, e.g. --benchmark_filter='engine/bit/'.
+ *****************************************************************************************************/
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include "golFunctions.hpp"
+#include "golEngine.hpp"
+#include "golPattern.hpp"
+#include "golThreadPool.hpp"
+
+/** board sides: L1, L2, last level cache, and well past it **/
+static const int BENCH_SIZES[] = { 64, 512, 4096, 16384 };
+/** seeds: 0 is a soup, the rest are PATTERNS **/
+static const char *const SEED_NAMES[] = { "soup", "pulsar", "gliders", "gun", "queenbee" };
+#define SOUP_DENSITY 0.5
+#define SOUP_SEED 1
+/** largest soup given to hashlife; a random board does not compress and grows the node
+ ** table past the memory of most machines **/
+#define HASHLIFE_SOUP_LIMIT 4096
+/** worker processes of the distributed engine, fixed so its results compare across machines **/
+#define BENCH_PROCESSES 4
+
+static void reportCells(benchmark::State &state, double cells, double bytes,
+                        double generations = 1)
+{
+  state.counters["cells/sec"] = benchmark::Counter(cells * generations * (double)state.iterations(),
+                                                   benchmark::Counter::kIsRate);
+  state.counters["bytes/cell"] = bytes / cells;
+}
+
+static void seedChars(char board[ROWS][COLUMNS], int seed)
+{
+  if (seed > 0)
+  {
+    seedGameboard(board, seed);
+    return;
+  }
+
+  BitGrid soup(ROWS, COLUMNS);
+  fillSoup(soup, SOUP_DENSITY, SOUP_SEED);
+  for (int r = 0; r < ROWS; r++)
+    for (int c = 0; c < COLUMNS; c++)
+      board[r][c] = soup.get(r, c) ? 'x' : '-';
+}
+
+static BitGrid seedBits(int rows, int columns, int seed)
+{
+  BitGrid board(rows, columns);
+  if (seed == 0)
+    fillSoup(board, SOUP_DENSITY, SOUP_SEED);
+  else
+  {
+    Grid chars(rows, columns);
+    seedGameboard(chars, seed);
+    for (int r = 0; r < rows; r++)
+      for (int c = 0; c < columns; c++)
+        board.set(r, c, chars.get(r, c) != 0);
+  }
+  return board;
+}
+
+/*********************************************************************
+ ** Function: Original char array functions
+ ** Description: the ROWSxCOLUMNS array API; updateGame() includes its
+ conversion to and from a Grid
+ ** Parameters: range(0) = seed
+ *********************************************************************/
+static void benchUpdateGameArray(benchmark::State &state)
+{
+  char current[ROWS][COLUMNS], next[ROWS][COLUMNS];
+  seedChars(current, (int)state.range(0));
+
+  for (auto _ : state)
+  {
+    updateGame(current, next);
+    benchmark::DoNotOptimize(current);
+    benchmark::DoNotOptimize(next);
+  }
+  reportCells(state, ROWS * COLUMNS, sizeof(current) + sizeof(next));
+}
+
+static void benchNeighborsLiveOrDie(benchmark::State &state)
+{
+  char current[ROWS][COLUMNS];
+  seedChars(current, (int)state.range(0));
+
+  for (auto _ : state)
+  {
+    int live = 0;
+    for (int r = 0; r < ROWS; r++)
+      for (int c = 0; c < COLUMNS; c++)
+        live += liveOrDie(neighbors(current, r, c), current[r][c]);
+    benchmark::DoNotOptimize(live);
+  }
+  reportCells(state, ROWS * COLUMNS, sizeof(current));
+}
+
+static void benchCopyArray(benchmark::State &state)
+{
+  char current[ROWS][COLUMNS], next[ROWS][COLUMNS];
+  seedChars(next, 0);
+
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(next);
+    copy(current, next);
+    benchmark::DoNotOptimize(current);
+  }
+  reportCells(state, ROWS * COLUMNS, sizeof(current) + sizeof(next));
+}
+
+/*********************************************************************
+ ** Function: Grid functions
+ ** Parameters: range(0) = board side, range(1) = seed (updateGame only)
+ *********************************************************************/
+static void benchUpdateGameGrid(benchmark::State &state)
+{
+  const int side = (int)state.range(0);
+  Grid current(side, side), next(side, side);
+  if (state.range(1) > 0)
+    seedGameboard(current, (int)state.range(1));
+  else
+  {
+    BitGrid soup = seedBits(side, side, 0);
+    for (int r = 0; r < side; r++)
+      for (int c = 0; c < side; c++)
+        current.set(r, c, soup.get(r, c));
+  }
+
+  for (auto _ : state)
+  {
+    updateGame(current, next);
+    benchmark::ClobberMemory();
+  }
+  reportCells(state, (double)side * side, (double)(current.bufferBytes() + next.bufferBytes()));
+}
+
+static void benchCopyGrid(benchmark::State &state)
+{
+  const int side = (int)state.range(0);
+  Grid current(side, side), next(side, side);
+
+  for (auto _ : state)
+  {
+    copy(current, next);
+    benchmark::ClobberMemory();
+  }
+  reportCells(state, (double)side * side, (double)(current.bufferBytes() + next.bufferBytes()));
+}
+
+/*********************************************************************
+ ** Function: Engine benchmark
+ ** Description: stepGrain() generations per iteration (a whole pass of the
+ blocked engine, one generation for the rest), carrying on from the last, so
+ soups thin out over a long run the way they do in the program; cells/sec
+ counts every generation stepped. Rates use wall time: the parallel and
+ distributed engines' work is on their pool threads and worker processes.
+ *********************************************************************/
+static void benchEngine(benchmark::State &state, std::string engineName, int side, int seed,
+                        std::string rule)
+{
+  const int threads = engineName == "distributed" ? BENCH_PROCESSES : 0;
+  std::unique_ptr<Engine> engine = makeEngine(engineName, side, side, threads, TOPOLOGY_BOUNDED,
+                                              Rule::parse(rule));
+  engine->loadBits(seedBits(side, side, seed));
+  const int generations = engine->stepGrain() > 0 ? engine->stepGrain() : 1;
+
+  for (auto _ : state)
+    engine->step(generations);
+
+  state.counters["population"] = (double)engine->population();
+  state.counters["generations/iteration"] = generations;
+  reportCells(state, (double)side * side, (double)engine->memoryBytes(), generations);
+}
+
+static void registerBenchmarks()
+{
+  static const char *const engines[] = { "char", "bit", "parallel", "distributed", "blocked", "tiled",
+                                         "hashlife", "sparse" };
+  const int sizeCount = sizeof(BENCH_SIZES) / sizeof(BENCH_SIZES[0]);
+
+  benchmark::RegisterBenchmark("updateGame/array", benchUpdateGameArray)->DenseRange(0, LAST_PATTERN);
+  benchmark::RegisterBenchmark("neighbors+liveOrDie/array", benchNeighborsLiveOrDie)
+    ->DenseRange(0, LAST_PATTERN);
+  benchmark::RegisterBenchmark("copy/array", benchCopyArray);
+
+  for (int s = 0; s < sizeCount; s++)
+  {
+    benchmark::RegisterBenchmark("copy/grid", benchCopyGrid)->Arg(BENCH_SIZES[s]);
+    for (int seed = 0; seed <= LAST_PATTERN; seed++)
+      benchmark::RegisterBenchmark("updateGame/grid", benchUpdateGameGrid)
+        ->Args({ BENCH_SIZES[s], seed });
+  }
+
+  for (std::size_t e = 0; e < sizeof(engines) / sizeof(engines[0]); e++)
+    for (int s = 0; s < sizeCount; s++)
+      for (int seed = 0; seed <= LAST_PATTERN; seed++)
+      {
+        const std::string engine = engines[e];
+        if (engine == "hashlife" && seed == 0 && BENCH_SIZES[s] > HASHLIFE_SOUP_LIMIT)
+          continue;
+
+        std::string name = "engine/" + engine + "/" + std::to_string(BENCH_SIZES[s]) + "/"
+                           + SEED_NAMES[seed];
+        benchmark::RegisterBenchmark(name.c_str(), benchEngine, engine, BENCH_SIZES[s], seed,
+                                     std::string("B3/S23"))
+          ->Unit(benchmark::kMicrosecond)->UseRealTime();
+      }
+
+  static const char *const rules[] = { "B3/S23", "B36/S23", "B3678/S34678", "B2/S", "B36/S125" };
+  for (std::size_t r = 0; r < sizeof(rules) / sizeof(rules[0]); r++)
+  {
+    std::string name = std::string("rule/bit/4096/soup/") + rules[r];
+    benchmark::RegisterBenchmark(name.c_str(), benchEngine, std::string("bit"), 4096, 0,
+                                 std::string(rules[r]))
+      ->Unit(benchmark::kMicrosecond)->UseRealTime();
+  }
+
+  static const char *const generationsRules[] = { "B2/S/C3", "B2/S345/C4", "B3/S23/C256" };
+  static const char *const generationsEngines[] = { "char", "generations" };
+  for (std::size_t r = 0; r < sizeof(generationsRules) / sizeof(generationsRules[0]); r++)
+    for (std::size_t e = 0; e < 2; e++)
+    {
+      std::string name = std::string("rule/") + generationsEngines[e] + "/4096/soup/"
+                         + generationsRules[r];
+      benchmark::RegisterBenchmark(name.c_str(), benchEngine, std::string(generationsEngines[e]),
+                                   4096, 0, std::string(generationsRules[r]))
+        ->Unit(benchmark::kMicrosecond)->UseRealTime();
+    }
+}
+
+int main(int argc, char *argv[])
+{
+  registerBenchmarks();
+  benchmark::AddCustomContext("kernel", simdLevelName(activeSimdLevel()));
+  benchmark::AddCustomContext("threads", std::to_string(hardwareThreads()));
+
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv))
+    return 1;
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
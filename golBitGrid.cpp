@@ -0,0 +1,479 @@
+/**************************************************************************************************
+ ** Program       Filename: GameOfLife
+ ** Current       File: golBitGrid.cpp
+ ** Author:       Jordan Grant
+ ** Date:         10.17.26
+ ** Description: 	Bit packed game board (see golBitGrid.hpp). The buffer layout is:
+ one halo row, rows() interior rows, one halo row. Each row is stride() words long and
+ starts with LINE_WORDS words of padding whose last word is the left halo word, so the
+ first interior word of every row is cache line aligned. The portable scalar kernel
+ is instantiated here; the AVX kernels live in golBitKernelAvx2.cpp and
+ golBitKernelAvx512.cpp.
+ *****************************************************************************************************/
+
+#include "golBitGrid.hpp"
+#include "golArena.hpp"
+#include "golBitKernel.hpp"
+#include "golBitKernelImpl.hpp"
+#include "golCycle.hpp"
+#include "golStats.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <sys/mman.h>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+BitGrid::BitGrid()
+  : rowCount(0), columnCount(0), wordCount(0), rowStride(0), bufferWords(0), lastMask(0),
+    buffer(NULL), origin(NULL), mapped(false)
+{
+}
+
+BitGrid::BitGrid(int rows, int columns, bool zeroFill)
+  : rowCount(rows), columnCount(columns), wordCount(0), rowStride(0), bufferWords(0),
+    lastMask(0), buffer(NULL), origin(NULL), mapped(false)
+{
+  layout(rows, columns);
+
+  buffer = static_cast<uint64_t *>(arenaAllocate(bufferWords * sizeof(uint64_t)));
+
+  if (zeroFill)
+    std::memset(buffer, 0, bufferWords * sizeof(uint64_t));
+  origin = buffer + rowStride + LINE_WORDS;
+}
+
+/** sets the dimensions, row stride and buffer size of a rows x columns board **/
+void BitGrid::layout(int rows, int columns)
+{
+  if (rows <= 0 || columns <= 0)
+    throw std::invalid_argument("BitGrid dimensions must be positive");
+
+  rowCount = rows;
+  columnCount = columns;
+  wordCount = ((std::size_t)columns + WORD_BITS - 1) / WORD_BITS;
+  lastMask = columns % WORD_BITS ? ((uint64_t)1 << (columns % WORD_BITS)) - 1 : ~(uint64_t)0;
+
+  /** left padding line + interior words + right halo word, rounded to whole lines **/
+  rowStride = (LINE_WORDS + wordCount + 1 + LINE_WORDS - 1) / LINE_WORDS * LINE_WORDS;
+  bufferWords = rowStride * ((std::size_t)rows + 2);
+}
+
+BitGrid::BitGrid(const BitGrid &other)
+  : rowCount(other.rowCount), columnCount(other.columnCount), wordCount(other.wordCount),
+    rowStride(other.rowStride), bufferWords(other.bufferWords), lastMask(other.lastMask),
+    buffer(NULL), origin(NULL), mapped(false)
+{
+  if (other.buffer == NULL)
+    return;
+
+  buffer = static_cast<uint64_t *>(arenaAllocate(bufferWords * sizeof(uint64_t)));
+
+  std::memcpy(buffer, other.buffer, bufferWords * sizeof(uint64_t));
+  origin = buffer + (other.origin - other.buffer);
+}
+
+BitGrid::BitGrid(BitGrid &&other) noexcept
+  : rowCount(0), columnCount(0), wordCount(0), rowStride(0), bufferWords(0), lastMask(0),
+    buffer(NULL), origin(NULL), mapped(false)
+{
+  swap(other);
+}
+
+BitGrid &BitGrid::operator=(const BitGrid &other)
+{
+  if (this == &other)
+    return *this;
+  if (buffer != NULL && other.buffer != NULL && bufferWords == other.bufferWords
+      && rowStride == other.rowStride && rowCount == other.rowCount
+      && columnCount == other.columnCount)
+  {
+    std::memcpy(buffer, other.buffer, bufferWords * sizeof(uint64_t));
+    origin = buffer + (other.origin - other.buffer);
+    return *this;
+  }
+
+  BitGrid copy(other);
+  swap(copy);
+  return *this;
+}
+
+BitGrid &BitGrid::operator=(BitGrid &&other) noexcept
+{
+  BitGrid moved(std::move(other));
+  swap(moved);
+  return *this;
+}
+
+BitGrid::~BitGrid()
+{
+  if (mapped)
+    munmap(buffer, bufferWords * sizeof(uint64_t));
+  else
+    arenaRelease(buffer, bufferWords * sizeof(uint64_t));
+}
+
+/*********************************************************************
+ ** Function: BitGrid::adoptMapping
+ ** Description: wraps memory that already holds a board in this class's
+ layout (e.g. a MAP_PRIVATE mapping of a checkpoint) without copying it
+ ** Parameters: board size, page aligned writable mapping, its length
+ ** Pre-Conditions: bytes must be the bufferBytes() of a rows x columns board;
+ throws std::invalid_argument otherwise. The board takes ownership of the
+ mapping only if it returns normally.
+ *********************************************************************/
+BitGrid BitGrid::adoptMapping(int rows, int columns, void *mapping, std::size_t bytes)
+{
+  BitGrid board;
+
+  board.layout(rows, columns);
+  if (bytes != board.bufferWords * sizeof(uint64_t) || mapping == NULL
+      || (uintptr_t)mapping % CACHE_LINE != 0)
+    throw std::invalid_argument("BitGrid::adoptMapping: mapping does not fit the board");
+
+  board.buffer = static_cast<uint64_t *>(mapping);
+  board.origin = board.buffer + board.rowStride + LINE_WORDS;
+  board.mapped = true;
+  return board;
+}
+
+std::size_t BitGrid::bufferBytesFor(int rows, int columns)
+{
+  BitGrid board;
+
+  board.layout(rows, columns);
+  return board.bufferWords * sizeof(uint64_t);
+}
+
+/*********************************************************************
+ ** Function: BitGrid::clear
+ ** Description: kills every cell, including the halo
+ *********************************************************************/
+void BitGrid::clear()
+{
+  if (buffer != NULL)
+    std::memset(buffer, 0, bufferWords * sizeof(uint64_t));
+}
+
+void BitGrid::clearRows(int firstRow, int lastRow)
+{
+  if (buffer != NULL && lastRow > firstRow)
+    std::memset(row(firstRow) - LINE_WORDS, 0,
+                (std::size_t)(lastRow - firstRow) * rowStride * sizeof(uint64_t));
+}
+
+void BitGrid::clearHalo()
+{
+  if (buffer == NULL)
+    return;
+
+  clearRows(-1, 0);
+  clearRows(rowCount, rowCount + 1);
+  for (int r = 0; r < rowCount; r++)
+  {
+    uint64_t *words = row(r);
+    words[-1] = 0;
+    words[wordCount - 1] &= lastMask;
+    words[wordCount] = 0;
+  }
+}
+
+/*********************************************************************
+ ** Function: BitGrid::population
+ ** Description: returns the number of live cells (wrap bits in the padding of
+ the last word are not cells and are not counted)
+ *********************************************************************/
+long long BitGrid::population() const
+{
+  long long live = 0;
+
+  for (int r = 0; r < rowCount; r++)
+  {
+    const uint64_t *cells = row(r);
+    for (std::size_t w = 0; w + 1 < wordCount; w++)
+      live += __builtin_popcountll(cells[w]);
+    live += __builtin_popcountll(cells[wordCount - 1] & lastMask);
+  }
+
+  return live;
+}
+
+long long countBitRange(const uint64_t *words, long long first, long long last)
+{
+  long long firstWord = first / WORD_BITS,
+            lastWord = (last - 1) / WORD_BITS;
+  uint64_t head = ~(uint64_t)0 << (first % WORD_BITS),
+           tail = ~(uint64_t)0 >> (WORD_BITS - 1 - (last - 1) % WORD_BITS);
+
+  if (firstWord == lastWord)
+    return __builtin_popcountll(words[firstWord] & head & tail);
+
+  long long live = __builtin_popcountll(words[firstWord] & head)
+                   + __builtin_popcountll(words[lastWord] & tail);
+  for (long long w = firstWord + 1; w < lastWord; w++)
+    live += __builtin_popcountll(words[w]);
+  return live;
+}
+
+void BitGrid::swap(BitGrid &other) noexcept
+{
+  std::swap(rowCount, other.rowCount);
+  std::swap(columnCount, other.columnCount);
+  std::swap(wordCount, other.wordCount);
+  std::swap(rowStride, other.rowStride);
+  std::swap(bufferWords, other.bufferWords);
+  std::swap(lastMask, other.lastMask);
+  std::swap(buffer, other.buffer);
+  std::swap(origin, other.origin);
+  std::swap(mapped, other.mapped);
+}
+
+/*********************************************************************
+ ** Function: Wrap Bit Columns / Wrap Bit Rows
+ ** Description: the left halo bit of a row gets the row's last cell and the
+ bit just past the last cell (padding or right halo word) gets its first
+ cell; then the halo rows get copies of the opposite edge rows, corners
+ included
+ *********************************************************************/
+void wrapBitColumns(BitGrid &grid, int firstRow, int lastRow)
+{
+  const int columns = grid.columns();
+
+  for (int r = firstRow; r < lastRow; r++)
+  {
+    uint64_t *words = grid.row(r);
+    bool first = words[0] & 1;
+    bool last = (words[(columns - 1) / WORD_BITS] >> ((columns - 1) % WORD_BITS)) & 1;
+    uint64_t bit = (uint64_t)1 << (columns % WORD_BITS);
+
+    words[-1] = last ? (uint64_t)1 << (WORD_BITS - 1) : 0;
+    if (first)
+      words[columns / WORD_BITS] |= bit;
+    else
+      words[columns / WORD_BITS] &= ~bit;
+  }
+}
+
+void wrapBitRows(BitGrid &grid)
+{
+  const std::size_t bytes = (grid.words() + 2) * sizeof(uint64_t);
+
+  std::memcpy(grid.row(-1) - 1, grid.row(grid.rows() - 1) - 1, bytes);
+  std::memcpy(grid.row(grid.rows()) - 1, grid.row(0) - 1, bytes);
+}
+
+void wrapBitGrid(BitGrid &grid)
+{
+  wrapBitColumns(grid, 0, grid.rows());
+  wrapBitRows(grid);
+}
+
+void packGrid(const Grid &grid, BitGrid &bits)
+{
+  if (grid.rows() != bits.rows() || grid.columns() != bits.columns())
+    throw std::invalid_argument("packGrid: board dimensions differ");
+
+  for (int r = 0; r < grid.rows(); r++)
+  {
+    const unsigned char *cells = grid.row(r);
+    uint64_t *words = bits.row(r);
+
+    for (std::size_t w = 0; w < bits.words(); w++)
+    {
+      uint64_t word = 0;
+      int first = (int)w * WORD_BITS;
+      int count = grid.columns() - first < WORD_BITS ? grid.columns() - first : WORD_BITS;
+
+      for (int i = 0; i < count; i++)
+        word |= (uint64_t)(cells[first + i] == 1) << i;
+      words[w] = word;
+    }
+  }
+}
+
+void unpackGrid(const BitGrid &bits, Grid &grid)
+{
+  if (grid.rows() != bits.rows() || grid.columns() != bits.columns())
+    throw std::invalid_argument("unpackGrid: board dimensions differ");
+
+  for (int r = 0; r < grid.rows(); r++)
+  {
+    const uint64_t *words = bits.row(r);
+    unsigned char *cells = grid.row(r);
+
+    for (int c = 0; c < grid.columns(); c++)
+      cells[c] = (unsigned char)((words[c / WORD_BITS] >> (c % WORD_BITS)) & 1);
+  }
+}
+
+const BitSpanKernel stepSpanScalar[RULE_KERNELS] = SPAN_KERNELS(uint64_t);
+
+/*********************************************************************
+ ** Function: SIMD level selection
+ ** Description: the kernel is chosen once, the first time a board is stepped
+ *********************************************************************/
+SimdLevel detectSimdLevel()
+{
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f"))
+    return SIMD_AVX512;
+  if (__builtin_cpu_supports("avx2"))
+    return SIMD_AVX2;
+  return SIMD_SCALAR;
+}
+
+static SimdLevel requestedSimdLevel()
+{
+  SimdLevel level = detectSimdLevel();
+  const char *env = std::getenv("GOL_SIMD");
+
+  if (env != NULL)
+  {
+    std::string name(env);
+    if (name == "scalar")
+      level = SIMD_SCALAR;
+    else if (name == "avx2" && level >= SIMD_AVX2)
+      level = SIMD_AVX2;
+  }
+
+  return level;
+}
+
+static SimdLevel &currentSimdLevel()
+{
+  static SimdLevel level = requestedSimdLevel();
+  return level;
+}
+
+SimdLevel activeSimdLevel()
+{
+  return currentSimdLevel();
+}
+
+void setSimdLevel(SimdLevel level)
+{
+  SimdLevel supported = detectSimdLevel();
+  currentSimdLevel() = level > supported ? supported : level;
+}
+
+const char *simdLevelName(SimdLevel level)
+{
+  switch (level)
+  {
+    case SIMD_AVX512:
+      return "avx512";
+    case SIMD_AVX2:
+      return "avx2";
+    default:
+      return "scalar";
+  }
+}
+
+static BitSpanKernel activeKernel(const Rule &rule)
+{
+  switch (currentSimdLevel())
+  {
+    case SIMD_AVX512:
+      return stepSpanAvx512[rule.kernel()];
+    case SIMD_AVX2:
+      return stepSpanAvx2[rule.kernel()];
+    default:
+      return stepSpanScalar[rule.kernel()];
+  }
+}
+
+/*********************************************************************
+ ** Function: Step Bit Span
+ ** Description: the SIMD kernel handles every word but the last word of the
+ row; that one is stepped on its own so the bits past columns() can be masked
+ off before they are counted as changes. The hash is updated after the kernel,
+ while the row is still in cache, and only for the words that changed.
+ *********************************************************************/
+static void hashSpan(const BitGrid &current, const uint64_t *mid, const uint64_t *out, int row,
+                     std::size_t firstWord, std::size_t lastWord, uint64_t *hash)
+{
+  const uint64_t seed = hashRowSeed(row);
+  const std::size_t last = current.words() - 1;
+  uint64_t delta = 0;
+
+  for (std::size_t w = firstWord; w < lastWord; w++)
+  {
+    uint64_t before = w == last ? mid[w] & current.lastWordMask() : mid[w];
+    if (before != out[w])
+      delta ^= hashWordKey(seed, (long long)w, before) ^ hashWordKey(seed, (long long)w, out[w]);
+  }
+  *hash ^= delta;
+}
+
+static inline uint64_t stepSpan(BitSpanKernel kernel, const Rule &rule, const BitGrid &current,
+                                BitGrid &next, int row, std::size_t firstWord,
+                                std::size_t lastWord, uint64_t *hash)
+{
+  const std::size_t last = current.words() - 1;
+  const uint64_t *up = current.row(row - 1);
+  const uint64_t *mid = current.row(row);
+  const uint64_t *down = current.row(row + 1);
+  uint64_t *out = next.row(row);
+
+  const unsigned birth = rule.birth(), survival = rule.survival();
+
+  if (lastWord <= last)
+  {
+    uint64_t changed = kernel(up, mid, down, out, firstWord, lastWord, birth, survival);
+    if (hash != NULL && changed != 0)
+      hashSpan(current, mid, out, row, firstWord, lastWord, hash);
+    if (changed != 0)
+      GOL_STAT_COUNT_WORDS(mid, out, firstWord, lastWord);
+    return changed;
+  }
+
+  uint64_t changed = kernel(up, mid, down, out, firstWord, last, birth, survival);
+  kernel(up, mid, down, out, last, last + 1, birth, survival);
+  uint64_t tail = out[last] & current.lastWordMask();
+  uint64_t before = mid[last] & current.lastWordMask();
+  out[last] = tail;
+  changed |= tail ^ before;
+  if (hash != NULL && changed != 0)
+    hashSpan(current, mid, out, row, firstWord, lastWord, hash);
+  if (changed != 0)
+  {
+    GOL_STAT_COUNT_WORDS(mid, out, firstWord, last);
+    GOL_STAT_COUNT_WORDS(&before, &tail, 0, 1);
+  }
+  return changed;
+}
+
+uint64_t stepBitSpan(const BitGrid &current, BitGrid &next, int row,
+                     std::size_t firstWord, std::size_t lastWord, const Rule &rule,
+                     uint64_t *hash)
+{
+  return stepSpan(activeKernel(rule), rule, current, next, row, firstWord, lastWord, hash);
+}
+
+void stepBitWords(const uint64_t *up, const uint64_t *mid, const uint64_t *down, uint64_t *out,
+                  std::size_t words, uint64_t lastMask, const Rule &rule)
+{
+  activeKernel(rule)(up, mid, down, out, 0, words, rule.birth(), rule.survival());
+  out[words - 1] &= lastMask;
+}
+
+uint64_t stepBitRows(const BitGrid &current, BitGrid &next, int firstRow, int lastRow,
+                     const Rule &rule, uint64_t *hash)
+{
+  if (current.rows() != next.rows() || current.columns() != next.columns())
+    throw std::invalid_argument("stepBitRows: board dimensions differ");
+
+  BitSpanKernel kernel = activeKernel(rule);
+  uint64_t changed = 0;
+
+  for (int r = firstRow; r < lastRow; r++)
+    changed |= stepSpan(kernel, rule, current, next, r, 0, current.words(), hash);
+
+  return changed;
+}
+
+void stepBitGrid(const BitGrid &current, BitGrid &next, const Rule &rule)
+{
+  stepBitRows(current, next, 0, current.rows(), rule);
+}
@@ -0,0 +1,204 @@
+/************************************************************************************************
+ ** Program       Filename: GameOfLife
+ ** Current       File: golBitGrid.hpp
+ ** Author:       Jordan Grant
+ ** Date:         10.17.26
+ ** Description: 	Bit packed game board. Each row stores 64 cells per uint64_t (column c
+ is bit c % 64 of word c / 64) and the rule is applied to a whole word at a time with
+ bit-parallel adder logic instead of counting neighbors cell by cell. Like Grid, the
+ board is one cache-line-aligned buffer with a dead halo: one halo row above and below,
+ a cache line of padding in front of every row (whose last word is the left halo word)
+ and at least one halo word after it. The generation kernel is picked at runtime
+ between AVX-512, AVX2 and a portable scalar version.
+ **************************************************************************************************/
+
+
+#ifndef GOLBITGRID_HPP
+#define GOLBITGRID_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include "golGrid.hpp"
+#include "golRule.hpp"
+
+#define WORD_BITS 64
+#define LINE_WORDS (CACHE_LINE / 8)
+
+enum Topology {
+  TOPOLOGY_BOUNDED,    // cells past the edge are always dead
+  TOPOLOGY_TORUS       // the edges wrap around to the opposite side
+};
+
+enum SimdLevel {
+  SIMD_SCALAR,
+  SIMD_AVX2,
+  SIMD_AVX512
+};
+
+/*********************************************************************
+ ** Class: BitGrid
+ ** Description: rows x columns board packed 64 cells per word with a dead halo.
+ Bits past columns() in the last word of a row are always kept dead.
+ ** Pre-Conditions: rows and columns must be positive
+ ** Post-Conditions: all cells (and the halo) start dead. With zeroFill false the
+ memory is left untouched so the threads that own each row can fault in its
+ pages first (NUMA first-touch); every row must then be cleared by its owner.
+ A board made by adoptMapping() uses a writable mmap of exactly bufferBytes()
+ as its buffer, and unmaps it instead of freeing it. Copies are ordinary boards.
+ *********************************************************************/
+class BitGrid
+{
+public:
+  BitGrid();
+  BitGrid(int rows, int columns, bool zeroFill = true);
+  BitGrid(const BitGrid &other);
+  BitGrid(BitGrid &&other) noexcept;
+  /** reuses the buffer already held when the dimensions match, so copying a board out again allocates nothing **/
+  BitGrid &operator=(const BitGrid &other);
+  BitGrid &operator=(BitGrid &&other) noexcept;
+  ~BitGrid();
+
+  static BitGrid adoptMapping(int rows, int columns, void *mapping, std::size_t bytes);
+  /** the bufferBytes() of a rows x columns board, worked out without making one **/
+  static std::size_t bufferBytesFor(int rows, int columns);
+
+  int rows() const { return rowCount; }
+  int columns() const { return columnCount; }
+  /** words of cells in each row **/
+  std::size_t words() const { return wordCount; }
+  /** distance between rows, in words **/
+  std::size_t stride() const { return rowStride; }
+  /** mask of the cells in use in the last word of a row **/
+  uint64_t lastWordMask() const { return lastMask; }
+  /** the whole buffer, halo rows and padding included, as it is laid out in memory **/
+  const uint64_t *data() const { return buffer; }
+  std::size_t bufferBytes() const { return bufferWords * sizeof(uint64_t); }
+
+  uint64_t *row(int r) { return origin + (std::ptrdiff_t)r * (std::ptrdiff_t)rowStride; }
+  const uint64_t *row(int r) const
+  { return origin + (std::ptrdiff_t)r * (std::ptrdiff_t)rowStride; }
+
+  bool get(int r, int c) const { return (row(r)[c / WORD_BITS] >> (c % WORD_BITS)) & 1; }
+  void set(int r, int c, bool alive)
+  {
+    uint64_t bit = (uint64_t)1 << (c % WORD_BITS);
+    if (alive)
+      row(r)[c / WORD_BITS] |= bit;
+    else
+      row(r)[c / WORD_BITS] &= ~bit;
+  }
+
+  void clear();
+  /** clears whole rows [firstRow, lastRow), padding included; -1 and rows() are allowed **/
+  void clearRows(int firstRow, int lastRow);
+  /** kills the halo and the padding bits of every row, e.g. after wrapping **/
+  void clearHalo();
+  long long population() const;
+  void swap(BitGrid &other) noexcept;
+
+private:
+  void layout(int rows, int columns);
+
+  int rowCount;
+  int columnCount;
+  std::size_t wordCount;
+  std::size_t rowStride;
+  std::size_t bufferWords;
+  uint64_t lastMask;
+  uint64_t *buffer;
+  uint64_t *origin;
+  bool mapped;
+};
+
+/*********************************************************************
+ ** Function: Wrap Bit Grid
+ ** Description: fills the halo with the opposite edges of the board so the
+ next step treats it as a torus. wrapBitColumns() and wrapBitRows() are the
+ two halves, for callers that step the board in bands: every row's columns
+ must be wrapped before the halo rows are copied.
+ ** Post-Conditions: stepping the board now wraps around both axes
+ *********************************************************************/
+void wrapBitColumns(BitGrid &grid, int firstRow, int lastRow);
+void wrapBitRows(BitGrid &grid);
+void wrapBitGrid(BitGrid &grid);
+
+/** live cells in columns [first, last) of one row's words, first < last **/
+long long countBitRange(const uint64_t *words, long long first, long long last);
+
+/*********************************************************************
+ ** Function: Pack Grid / Unpack Grid
+ ** Description: convert between a byte per cell Grid and a BitGrid
+ ** Parameters: source board, destination board of the same size
+ ** Post-Conditions: destination holds the same live cells as the source (cells
+ in state 1; the dying states of a Generations board are dropped)
+ *********************************************************************/
+void packGrid(const Grid &grid, BitGrid &bits);
+void unpackGrid(const BitGrid &bits, Grid &grid);
+
+/*********************************************************************
+ ** Function: Step Bit Rows
+ ** Description: computes the next generation of rows [firstRow, lastRow) of
+ current into next with the active SIMD kernel for the rule. Only those rows
+ of next are written, so disjoint row bands can be stepped independently.
+ ** Parameters: current generation, next generation, first row, one past last
+ row, rule (Conway's B3/S23 by default), optional board hash (golCycle.hpp)
+ ** Pre-Conditions: both boards have the same dimensions and are not the same board
+ ** Post-Conditions: returns the OR of (next ^ current) over every word written,
+ which is zero when no cell in the band changed. If hash is not NULL it is
+ XORed with the change in hashBitGrid() over the words written, so a hash of
+ current becomes the hash of next.
+ *********************************************************************/
+uint64_t stepBitRows(const BitGrid &current, BitGrid &next, int firstRow, int lastRow,
+                     const Rule &rule = Rule(), uint64_t *hash = NULL);
+
+/*********************************************************************
+ ** Function: Step Bit Span
+ ** Description: computes words [firstWord, lastWord) of one row of the next
+ generation. stepBitRows() is this over whole rows; engines that only
+ recompute part of the board call it directly.
+ ** Parameters: current generation, next generation, row, first word, one past
+ last word (at most words())
+ ** Post-Conditions: returns the OR of (next ^ current) over the words written
+ and updates hash like stepBitRows()
+ *********************************************************************/
+uint64_t stepBitSpan(const BitGrid &current, BitGrid &next, int row,
+                     std::size_t firstWord, std::size_t lastWord, const Rule &rule = Rule(),
+                     uint64_t *hash = NULL);
+
+/*********************************************************************
+ ** Function: Step Bit Words
+ ** Description: computes one row of the next generation from three rows that
+ need not belong to a BitGrid, e.g. rows derived from another representation
+ on the fly. Each row holds words cells words and must be readable, like a
+ BitGrid row, one word before and one word after them.
+ ** Parameters: up, mid and down rows of the current generation, output row,
+ words per row, mask of the cells in use in the last word, rule
+ ** Post-Conditions: out holds the row's next generation with the bits past
+ the last cell cleared
+ *********************************************************************/
+void stepBitWords(const uint64_t *up, const uint64_t *mid, const uint64_t *down, uint64_t *out,
+                  std::size_t words, uint64_t lastMask, const Rule &rule = Rule());
+
+/*********************************************************************
+ ** Function: Step Bit Grid
+ ** Description: computes one generation of the whole board (stepBitRows() over
+ every row). Matches stepGrid() cell for cell under the same Life-like rule;
+ the dying states of a Generations rule are the GenerationsEngine's business.
+ ** Pre-Conditions: both boards have the same dimensions and are not the same board
+ ** Post-Conditions: next holds the following generation
+ *********************************************************************/
+void stepBitGrid(const BitGrid &current, BitGrid &next, const Rule &rule = Rule());
+
+/*********************************************************************
+ ** Function: SIMD level selection
+ ** Description: detectSimdLevel() returns the widest kernel this CPU can run.
+ activeSimdLevel() is the kernel in use: the detected one, unless the
+ GOL_SIMD environment variable (scalar, avx2, avx512) or setSimdLevel()
+ asks for a narrower one. Requests wider than the CPU supports are clamped.
+ *********************************************************************/
+SimdLevel detectSimdLevel();
+SimdLevel activeSimdLevel();
+void setSimdLevel(SimdLevel level);
+const char *simdLevelName(SimdLevel level);
+
+#endif
@@ -0,0 +1,39 @@
+/************************************************************************************************
+ ** Program       Filename: GameOfLife
+ ** Current       File: golBitKernel.hpp
+ ** Author:       Jordan Grant
+ ** Date:         10.17.26
+ ** Description: 	Word-span generation kernels behind stepBitRows(). One kernel is built
+ per instruction set and rule kernel (RuleKernel), each instruction set in its own
+ translation unit compiled with the matching -m flags, so the rest of the program never
+ runs AVX code on a CPU without it. The shared kernel body lives in golBitKernelImpl.hpp.
+ **************************************************************************************************/
+
+
+#ifndef GOLBITKERNEL_HPP
+#define GOLBITKERNEL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include "golRule.hpp"
+
+/*********************************************************************
+ ** Function: Span Kernels
+ ** Description: compute words [firstWord, lastWord) of one row of the next
+ generation from the up, mid and down rows of the current one. Each row
+ pointer must be readable one word before firstWord and one word after
+ lastWord (the halo words guarantee this). birth and survival are the rule's
+ masks; only the generic kernel reads them, the others have their rule built in.
+ Each instruction set has one kernel per RuleKernel, indexed by Rule::kernel().
+ ** Post-Conditions: returns the OR of (out ^ mid) over the words written
+ *********************************************************************/
+typedef uint64_t (*BitSpanKernel)(const uint64_t *up, const uint64_t *mid,
+                                  const uint64_t *down, uint64_t *out,
+                                  std::size_t firstWord, std::size_t lastWord,
+                                  unsigned birth, unsigned survival);
+
+extern const BitSpanKernel stepSpanScalar[RULE_KERNELS];
+extern const BitSpanKernel stepSpanAvx2[RULE_KERNELS];
+extern const BitSpanKernel stepSpanAvx512[RULE_KERNELS];
+
+#endif
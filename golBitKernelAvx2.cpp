@@ -0,0 +1,17 @@
+/**************************************************************************************************
+ ** Program       Filename: GameOfLife
+ ** Current       File: golBitKernelAvx2.cpp
+ ** Author:       Jordan Grant
+ ** Date:         10.17.26
+ ** Description: 	AVX2 instance of the bit-parallel generation kernel. This file is
+ compiled with -mavx2 and must only be called after detectSimdLevel() has confirmed
+ the CPU supports it.
+ *****************************************************************************************************/
+
+#include "golBitKernel.hpp"
+#include "golBitKernelImpl.hpp"
+
+/** 4 words (32 bytes) of cells per operation **/
+typedef uint64_t WordsAvx2 __attribute__((vector_size(32)));
+
+const BitSpanKernel stepSpanAvx2[RULE_KERNELS] = SPAN_KERNELS(WordsAvx2);
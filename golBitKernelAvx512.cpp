@@ -0,0 +1,17 @@
+/**************************************************************************************************
+ ** Program       Filename: GameOfLife
+ ** Current       File: golBitKernelAvx512.cpp
+ ** Author:       Jordan Grant
+ ** Date:         10.17.26
+ ** Description: 	AVX512 instance of the bit-parallel generation kernel. This file is
+ compiled with -mavx512f and must only be called after detectSimdLevel() has confirmed
+ the CPU supports it.
+ *****************************************************************************************************/
+
+#include "golBitKernel.hpp"
+#include "golBitKernelImpl.hpp"
+
+/** 8 words (64 bytes) of cells per operation **/
+typedef uint64_t WordsAvx512 __attribute__((vector_size(64)));
+
+const BitSpanKernel stepSpanAvx512[RULE_KERNELS] = SPAN_KERNELS(WordsAvx512);
@@ -0,0 +1,181 @@
+/************************************************************************************************
+ ** Program       Filename: GameOfLife
+ ** Current       File: golBitKernelImpl.hpp
+ ** Author:       Jordan Grant
+ ** Date:         10.17.26
+ ** Description: 	Body of the bit-parallel generation kernel. It is written once over a
+ word type W, which is either uint64_t or a GCC vector of uint64_t; the including
+ translation unit decides which instruction set the vector type compiles to.
+ Everything here is static so every translation unit keeps its own copy.
+
+ For every bit the eight neighbors are summed with full adders into a 4 bit count
+ (s3 s2 s1 s0) and the rule is applied to the count bits. The kernel is a template
+ parameter (RuleKernel), so the common rules reduce to a few fixed gates: B3/S23 becomes
+ alive next = count is 2 or 3, and count is 3 or the cell is already alive. The generic
+ kernel instead ORs together the counts set in the birth and survival masks.
+ **************************************************************************************************/
+
+
+#ifndef GOLBITKERNELIMPL_HPP
+#define GOLBITKERNELIMPL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include "golRule.hpp"
+
+template <class W>
+static inline W loadWords(const uint64_t *p)
+{
+  W w;
+  std::memcpy(&w, p, sizeof(W));
+  return w;
+}
+
+template <class W>
+static inline void storeWords(uint64_t *p, W w)
+{
+  std::memcpy(p, &w, sizeof(W));
+}
+
+template <class W>
+static inline uint64_t orLanes(W w)
+{
+  uint64_t lanes[sizeof(W) / sizeof(uint64_t)];
+  uint64_t result = 0;
+
+  std::memcpy(lanes, &w, sizeof(W));
+  for (std::size_t i = 0; i < sizeof(W) / sizeof(uint64_t); i++)
+    result |= lanes[i];
+  return result;
+}
+
+/*********************************************************************
+ ** Function: Apply Rule
+ ** Description: next state of every bit given its neighbor count s3 s2 s1 s0
+ and its current state b. A count of 8 is the only one with s3 set, so s3
+ implies the other three bits are clear.
+ *********************************************************************/
+template <class W, int KERNEL>
+static inline W applyRule(W s0, W s1, W s2, W s3, W b, unsigned birth, unsigned survival)
+{
+  switch (KERNEL)
+  {
+    case RULE_KERNEL_CONWAY:
+      /** B3/S23 **/
+      return s1 & ~s2 & ~s3 & (s0 | b);
+    case RULE_KERNEL_HIGHLIFE:
+      /** B36/S23: Conway plus birth on 6 **/
+      return (s1 & ~s2 & ~s3 & (s0 | b)) | (~b & s2 & s1 & ~s0);
+    case RULE_KERNEL_DAYNIGHT:
+      /** B3678/S34678: 3, 6, 7 or 8 either way, 4 only to survive **/
+      return s3 | (s2 & s1) | (~s2 & s1 & s0) | (b & s2 & ~s1 & ~s0);
+    case RULE_KERNEL_SEEDS:
+      /** B2/S: nothing survives **/
+      return ~b & ~s2 & s1 & ~s0;
+  }
+
+  W next;
+  std::memset(&next, 0, sizeof(W));
+  for (int n = 0; n <= 8; n++)
+  {
+    const bool born = (birth >> n) & 1, stays = (survival >> n) & 1;
+    if (!born && !stays)
+      continue;
+
+    W count = (n & 1 ? s0 : ~s0) & (n & 2 ? s1 : ~s1) & (n & 4 ? s2 : ~s2) & (n & 8 ? s3 : ~s3);
+    if (born && stays)
+      next |= count;
+    else if (born)
+      next |= count & ~b;
+    else
+      next |= count & b;
+  }
+  return next;
+}
+
+/*********************************************************************
+ ** Function: Life Words
+ ** Description: next generation of the cells in the W starting at mid. up and
+ down point at the same columns of the rows above and below. The words on
+ either side are read to carry the neighbors across word boundaries.
+ *********************************************************************/
+template <class W, int KERNEL>
+static inline W lifeWords(const uint64_t *up, const uint64_t *mid, const uint64_t *down,
+                          unsigned birth, unsigned survival)
+{
+  W a = loadWords<W>(up),
+    b = loadWords<W>(mid),
+    c = loadWords<W>(down);
+
+  /** west neighbor of bit i is bit i - 1, east neighbor is bit i + 1 **/
+  W aw = (a << 1) | (loadWords<W>(up - 1) >> 63),
+    ae = (a >> 1) | (loadWords<W>(up + 1) << 63),
+    bw = (b << 1) | (loadWords<W>(mid - 1) >> 63),
+    be = (b >> 1) | (loadWords<W>(mid + 1) << 63),
+    cw = (c << 1) | (loadWords<W>(down - 1) >> 63),
+    ce = (c >> 1) | (loadWords<W>(down + 1) << 63);
+
+  /** 2 bit sums of the row above, the row itself and the row below **/
+  W t0 = aw ^ a ^ ae,
+    t1 = (aw & a) | (ae & (aw ^ a)),
+    m0 = bw ^ be,
+    m1 = bw & be,
+    d0 = cw ^ c ^ ce,
+    d1 = (cw & c) | (ce & (cw ^ c));
+
+  /** add the three 2 bit sums into s3 s2 s1 s0 **/
+  W s0 = t0 ^ m0 ^ d0,
+    k1 = (t0 & m0) | (d0 & (t0 ^ m0)),
+    u0 = t1 ^ m1 ^ d1,
+    u1 = (t1 & m1) | (d1 & (t1 ^ m1)),
+    s1 = u0 ^ k1,
+    k2 = u0 & k1,
+    s2 = u1 ^ k2,
+    s3 = u1 & k2;
+
+  return applyRule<W, KERNEL>(s0, s1, s2, s3, b, birth, survival);
+}
+
+/*********************************************************************
+ ** Function: Step Span Words
+ ** Description: runs lifeWords() over [firstWord, lastWord) of one row, W
+ words at a time, finishing any remainder one uint64_t at a time.
+ ** Post-Conditions: returns the OR of (out ^ mid) over the words written
+ *********************************************************************/
+template <class W, int KERNEL>
+static uint64_t stepSpanWords(const uint64_t *up, const uint64_t *mid,
+                              const uint64_t *down, uint64_t *out,
+                              std::size_t firstWord, std::size_t lastWord,
+                              unsigned birth, unsigned survival)
+{
+  const std::size_t lanes = sizeof(W) / sizeof(uint64_t);
+  std::size_t w = firstWord;
+  W changed;
+
+  std::memset(&changed, 0, sizeof(W));
+  for (; w + lanes <= lastWord; w += lanes)
+  {
+    W next = lifeWords<W, KERNEL>(up + w, mid + w, down + w, birth, survival);
+    storeWords<W>(out + w, next);
+    changed |= next ^ loadWords<W>(mid + w);
+  }
+
+  uint64_t result = orLanes<W>(changed);
+  for (; w < lastWord; w++)
+  {
+    uint64_t next = lifeWords<uint64_t, KERNEL>(up + w, mid + w, down + w, birth, survival);
+    out[w] = next;
+    result |= next ^ mid[w];
+  }
+
+  return result;
+}
+
+/** one kernel per RuleKernel, in order, for an instruction set's kernel table **/
+#define SPAN_KERNELS(W) \
+  { stepSpanWords<W, RULE_KERNEL_CONWAY>, stepSpanWords<W, RULE_KERNEL_HIGHLIFE>, \
+    stepSpanWords<W, RULE_KERNEL_DAYNIGHT>, stepSpanWords<W, RULE_KERNEL_SEEDS>, \
+    stepSpanWords<W, RULE_KERNEL_GENERIC> }
+
+#endif
@@ -0,0 +1,591 @@
+/**************************************************************************************************
+ ** Program       Filename: GameOfLife
+ ** Current       File: golCensus.cpp
+ ** Author:       Jordan Grant
+ ** Date:         10.17.26
+ ** Description: 	Random soup census (see golCensus.hpp). Every thread takes soups
+ from a WorkStealer, runs each to a periodic population, merges the cells of the next
+ few generations to see which cells belong together, and names each group of cells
+ once: names are remembered per thread by the shape they were found in.
+ *****************************************************************************************************/
+
+#include "golCensus.hpp"
+#include "golCycle.hpp"
+#include "golPattern.hpp"
+#include "golStats.hpp"
+#include "golThreadPool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <stdexcept>
+
+#define CENSUS_ROWS 16
+#define CENSUS_COLUMNS 16
+#define CENSUS_SOUPS 10000
+#define CENSUS_GENERATIONS 20000
+/** the population is searched for a period every this many generations **/
+#define CENSUS_CHECK_EVERY 32
+/** a period has to hold for 8 periods and at least this many generations **/
+#define CENSUS_STABLE_GENERATIONS 64
+/** at least this many generations are merged into the objects, so oscillators whose
+ ** population never changes (a blinker) still bring their other phases **/
+#define CENSUS_MIN_SPREAD 4
+/** names remembered per thread before the memo is started over **/
+#define CENSUS_MEMO_LIMIT 65536
+
+static const char WECHSLER_DIGITS[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+
+static bool cellBefore(const LifeCell &a, const LifeCell &b)
+{
+  return a.y != b.y ? a.y < b.y : a.x < b.x;
+}
+
+static bool sameCells(const std::vector<LifeCell> &a, const std::vector<LifeCell> &b)
+{
+  if (a.size() != b.size())
+    return false;
+  for (std::size_t i = 0; i < a.size(); i++)
+    if (a[i].y != b[i].y || a[i].x != b[i].x)
+      return false;
+  return true;
+}
+
+/** moves cells so their bounding box starts at (0, 0), sorts them row by row and
+ ** returns where the top left corner was **/
+static LifeCell normalize(std::vector<LifeCell> &cells)
+{
+  LifeCell corner = cells[0];
+
+  for (std::size_t i = 1; i < cells.size(); i++)
+  {
+    corner.y = std::min(corner.y, cells[i].y);
+    corner.x = std::min(corner.x, cells[i].x);
+  }
+  for (std::size_t i = 0; i < cells.size(); i++)
+  {
+    cells[i].y -= corner.y;
+    cells[i].x -= corner.x;
+  }
+  std::sort(cells.begin(), cells.end(), cellBefore);
+  return corner;
+}
+
+/** shorter codes come first, then ASCII order **/
+static bool codeBefore(const std::string &a, const std::string &b)
+{
+  return a.size() != b.size() ? a.size() < b.size() : a < b;
+}
+
+std::string wechslerCode(const std::vector<LifeCell> &cells)
+{
+  long long top = cells[0].y, bottom = cells[0].y, left = cells[0].x, right = cells[0].x;
+
+  for (std::size_t i = 1; i < cells.size(); i++)
+  {
+    top = std::min(top, cells[i].y);
+    bottom = std::max(bottom, cells[i].y);
+    left = std::min(left, cells[i].x);
+    right = std::max(right, cells[i].x);
+  }
+
+  const long long height = bottom - top + 1, width = right - left + 1;
+  std::vector<unsigned char> columns((std::size_t)((height + 4) / 5 * width), 0);
+  for (std::size_t i = 0; i < cells.size(); i++)
+  {
+    long long y = cells[i].y - top;
+    columns[(std::size_t)(y / 5 * width + cells[i].x - left)] |= (unsigned char)(1 << (y % 5));
+  }
+
+  std::string code;
+  for (long long strip = 0; strip * 5 < height; strip++)
+  {
+    const unsigned char *column = &columns[(std::size_t)(strip * width)];
+    long long used = width;
+    while (used > 0 && column[used - 1] == 0)
+      used--;
+
+    if (strip > 0)
+      code += 'z';
+    for (long long c = 0; c < used;)
+    {
+      if (column[c] != 0)
+      {
+        code += WECHSLER_DIGITS[column[c++]];
+        continue;
+      }
+
+      /** the strip ends on a nonzero column, so the run stops before used **/
+      long long zeros = 0;
+      while (column[c + zeros] == 0)
+        zeros++;
+      c += zeros;
+      while (zeros >= 4)
+      {
+        long long run = std::min(zeros, 39LL);
+        code += 'y';
+        code += WECHSLER_DIGITS[run - 4];
+        zeros -= run;
+      }
+      if (zeros == 3)
+        code += 'x';
+      else if (zeros == 2)
+        code += 'w';
+      else if (zeros == 1)
+        code += '0';
+    }
+  }
+  return code;
+}
+
+/** orientation 0-7: bit 0 mirrors left to right, bit 1 top to bottom, bit 2 swaps rows and columns **/
+static void orient(const std::vector<LifeCell> &cells, int orientation, std::vector<LifeCell> &out)
+{
+  out.resize(cells.size());
+  for (std::size_t i = 0; i < cells.size(); i++)
+  {
+    long long y = orientation & 2 ? -cells[i].y : cells[i].y;
+    long long x = orientation & 1 ? -cells[i].x : cells[i].x;
+    out[i].y = orientation & 4 ? x : y;
+    out[i].x = orientation & 4 ? y : x;
+  }
+}
+
+std::string classifyObject(const std::vector<LifeCell> &cells, SparseLife &scratch)
+{
+  std::vector<std::vector<LifeCell> > phases(1, cells);
+  const LifeCell origin = normalize(phases[0]);
+
+  scratch.clear();
+  for (std::size_t i = 0; i < cells.size(); i++)
+    scratch.set(cells[i].y, cells[i].x, true);
+
+  int period = 0;
+  bool moving = false;
+  std::vector<LifeCell> now;
+  for (int t = 1; t <= CENSUS_MAX_PERIOD && period == 0; t++)
+  {
+    scratch.step(1);
+    now.clear();
+    scratch.liveCells(now);
+    if (now.empty())
+      break;
+
+    LifeCell corner = normalize(now);
+    if (sameCells(now, phases[0]))
+    {
+      period = t;
+      moving = corner.y != origin.y || corner.x != origin.x;
+    }
+    else
+      phases.push_back(now);
+  }
+  if (period == 0)
+    return "unknown";
+
+  std::string best;
+  std::vector<LifeCell> turned;
+  for (std::size_t p = 0; p < phases.size(); p++)
+    for (int orientation = 0; orientation < 8; orientation++)
+    {
+      orient(phases[p], orientation, turned);
+      std::string code = wechslerCode(turned);
+      if (best.empty() || codeBefore(code, best))
+        best = code;
+    }
+
+  if (period == 1 && !moving)
+    return "xs" + std::to_string(cells.size()) + "_" + best;
+  return (moving ? "xq" : "xp") + std::to_string(period) + "_" + best;
+}
+
+void CensusTable::add(const std::string &object, long long count)
+{
+  Stripe &stripe = stripes[std::hash<std::string>()(object) % CENSUS_STRIPES];
+  std::lock_guard<std::mutex> lock(stripe.lock);
+  stripe.counts[object] += count;
+}
+
+static bool countBefore(const std::pair<std::string, long long> &a,
+                        const std::pair<std::string, long long> &b)
+{
+  return a.second != b.second ? a.second > b.second : a.first < b.first;
+}
+
+std::vector<std::pair<std::string, long long> > CensusTable::sorted() const
+{
+  std::vector<std::pair<std::string, long long> > objects;
+
+  for (int i = 0; i < CENSUS_STRIPES; i++)
+  {
+    std::lock_guard<std::mutex> lock(stripes[i].lock);
+    objects.insert(objects.end(), stripes[i].counts.begin(), stripes[i].counts.end());
+  }
+  std::sort(objects.begin(), objects.end(), countBefore);
+  return objects;
+}
+
+/*********************************************************************
+ ** Struct: CensusJob
+ ** Description: what every census thread shares
+ *********************************************************************/
+struct CensusJob
+{
+  Rule rule;
+  int rows;
+  int columns;
+  double density;
+  uint64_t seed;
+  long long generations;
+  WorkStealer *work;
+  CensusTable *table;
+  std::atomic<long long> unstabilized;
+  std::atomic<long long> stepped;
+};
+
+/*********************************************************************
+ ** Struct: CensusWorker
+ ** Description: one thread's universes and buffers, reused from soup to soup
+ *********************************************************************/
+struct CensusWorker
+{
+  CensusWorker(const CensusJob &job)
+    : board(job.rows, job.columns), soup(job.rule), scratch(job.rule)
+  {
+  }
+
+  BitGrid board;
+  SparseLife soup;
+  SparseLife scratch;
+  std::vector<long long> populations;
+  std::vector<LifeCell> cells;
+  std::vector<LifeCell> spread;
+  std::vector<LifeCell> unique;
+  std::vector<std::size_t> parent;
+  std::unordered_map<uint64_t, std::size_t> index;
+  std::vector<std::vector<LifeCell> > groups;
+  std::vector<std::vector<LifeCell> > objects;
+  std::unordered_map<std::string, std::string> names;
+};
+
+/** the smallest period of the population's last generations, 0 if there is none yet **/
+static int populationPeriod(const std::vector<long long> &populations)
+{
+  const long long count = (long long)populations.size();
+
+  for (int period = 1; period <= CENSUS_MAX_PERIOD; period++)
+  {
+    long long window = std::max(8LL * period, (long long)CENSUS_STABLE_GENERATIONS);
+    if (window + period > count)
+      return 0;
+
+    bool periodic = true;
+    for (long long i = count - window; i < count && periodic; i++)
+      periodic = populations[i] == populations[i - period];
+    if (periodic)
+      return period;
+  }
+  return 0;
+}
+
+static inline uint64_t cellKey(const LifeCell &cell)
+{
+  return (uint64_t)(uint32_t)cell.y << 32 | (uint32_t)cell.x;
+}
+
+static std::size_t findRoot(std::vector<std::size_t> &parent, std::size_t i)
+{
+  while (parent[i] != i)
+    i = parent[i] = parent[parent[i]];
+  return i;
+}
+
+/** the cells of generations 1 to generations of cells run alone, each generation sorted **/
+static void runAlone(const std::vector<LifeCell> &cells, int generations, SparseLife &scratch,
+                     std::vector<std::vector<LifeCell> > &history)
+{
+  scratch.clear();
+  for (std::size_t i = 0; i < cells.size(); i++)
+    scratch.set(cells[i].y, cells[i].x, true);
+
+  history.resize((std::size_t)generations);
+  for (int t = 0; t < generations; t++)
+  {
+    scratch.step(1);
+    history[t].clear();
+    scratch.liveCells(history[t]);
+    std::sort(history[t].begin(), history[t].end(), cellBefore);
+  }
+}
+
+/** true if each part run alone, put together, gives the parts run together every generation **/
+static bool independent(const std::vector<std::vector<LifeCell> > &parts, int generations,
+                        SparseLife &scratch)
+{
+  std::vector<LifeCell> whole;
+  for (std::size_t p = 0; p < parts.size(); p++)
+    whole.insert(whole.end(), parts[p].begin(), parts[p].end());
+
+  std::vector<std::vector<LifeCell> > together, alone, sum((std::size_t)generations);
+  runAlone(whole, generations, scratch, together);
+  for (std::size_t p = 0; p < parts.size(); p++)
+  {
+    runAlone(parts[p], generations, scratch, alone);
+    for (int t = 0; t < generations; t++)
+      sum[t].insert(sum[t].end(), alone[t].begin(), alone[t].end());
+  }
+
+  for (int t = 0; t < generations; t++)
+  {
+    std::sort(sum[t].begin(), sum[t].end(), cellBefore);
+    if (!sameCells(sum[t], together[t]))
+      return false;
+  }
+  return true;
+}
+
+void separateObjects(const std::vector<LifeCell> &cells, int generations, SparseLife &scratch,
+                     std::vector<std::vector<LifeCell> > &objects)
+{
+  std::unordered_map<uint64_t, std::size_t> index;
+  std::vector<std::size_t> parent(cells.size());
+  for (std::size_t i = 0; i < cells.size(); i++)
+  {
+    index.emplace(cellKey(cells[i]), i);
+    parent[i] = i;
+  }
+  for (std::size_t i = 0; i < cells.size(); i++)
+    for (int dy = 0; dy <= 1; dy++)
+      for (int dx = -1; dx <= 1; dx++)
+      {
+        if (dy == 0 && dx <= 0)
+          continue;
+        LifeCell near = { cells[i].y + dy, cells[i].x + dx };
+        std::unordered_map<uint64_t, std::size_t>::const_iterator found = index.find(cellKey(near));
+        if (found != index.end())
+          parent[findRoot(parent, i)] = findRoot(parent, found->second);
+      }
+
+  std::unordered_map<std::size_t, std::size_t> numbers;
+  std::vector<std::vector<LifeCell> > parts;
+  for (std::size_t i = 0; i < cells.size(); i++)
+  {
+    std::size_t number = numbers.emplace(findRoot(parent, i), numbers.size()).first->second;
+    if (number >= parts.size())
+      parts.resize(number + 1);
+    parts[number].push_back(cells[i]);
+  }
+
+  /** two parts that change each other are one object; start over after every join **/
+  bool joined = true;
+  while (joined && parts.size() > 1)
+  {
+    joined = false;
+    for (std::size_t i = 0; i < parts.size() && !joined; i++)
+      for (std::size_t j = i + 1; j < parts.size() && !joined; j++)
+      {
+        std::vector<std::vector<LifeCell> > pair(1, parts[i]);
+        pair.push_back(parts[j]);
+        if (!independent(pair, generations, scratch))
+        {
+          parts[i].insert(parts[i].end(), parts[j].begin(), parts[j].end());
+          parts.erase(parts.begin() + (std::ptrdiff_t)j);
+          joined = true;
+        }
+      }
+  }
+
+  /** parts that only get along two at a time stay together **/
+  if (parts.size() > 1 && !independent(parts, generations, scratch))
+    objects.push_back(cells);
+  else
+    objects.insert(objects.end(), parts.begin(), parts.end());
+}
+
+/*********************************************************************
+ ** Function: Split Objects
+ ** Description: groups the live cells into objects. The cells of the next
+ spread generations are merged and any two within 2 cells of each other
+ (sharing a neighbor) joined, so nothing in one object can touch another
+ over that time; the cells live now are then sorted into their groups.
+ Cells that close can still be separate objects (a blinker beside a block),
+ so each group is handed to separateObjects() to be split again.
+ *********************************************************************/
+static void splitObjects(CensusWorker &worker, int spread)
+{
+  worker.cells.clear();
+  worker.soup.liveCells(worker.cells);
+  worker.spread = worker.cells;
+  for (int t = 1; t < spread; t++)
+  {
+    worker.soup.step(1);
+    worker.soup.liveCells(worker.spread);
+  }
+
+  worker.unique.clear();
+  worker.parent.clear();
+  worker.index.clear();
+  for (std::size_t i = 0; i < worker.spread.size(); i++)
+    if (worker.index.emplace(cellKey(worker.spread[i]), worker.unique.size()).second)
+    {
+      worker.parent.push_back(worker.unique.size());
+      worker.unique.push_back(worker.spread[i]);
+    }
+
+  for (std::size_t i = 0; i < worker.unique.size(); i++)
+    for (int dy = 0; dy <= 2; dy++)
+      for (int dx = -2; dx <= 2; dx++)
+      {
+        if (dy == 0 && dx <= 0)
+          continue;
+        LifeCell near = { worker.unique[i].y + dy, worker.unique[i].x + dx };
+        std::unordered_map<uint64_t, std::size_t>::const_iterator found =
+          worker.index.find(cellKey(near));
+        if (found != worker.index.end())
+          worker.parent[findRoot(worker.parent, i)] = findRoot(worker.parent, found->second);
+      }
+
+  /** objects are numbered in the order their first live cell comes up **/
+  std::unordered_map<std::size_t, std::size_t> numbers;
+  for (std::size_t i = 0; i < worker.objects.size(); i++)
+    worker.objects[i].clear();
+  for (std::size_t i = 0; i < worker.cells.size(); i++)
+  {
+    std::size_t root = findRoot(worker.parent, worker.index[cellKey(worker.cells[i])]);
+    std::size_t number = numbers.emplace(root, numbers.size()).first->second;
+    if (number >= worker.objects.size())
+      worker.objects.resize(number + 1);
+    worker.objects[number].push_back(worker.cells[i]);
+  }
+  worker.objects.resize(numbers.size());
+
+  worker.groups.swap(worker.objects);
+  worker.objects.clear();
+  for (std::size_t i = 0; i < worker.groups.size(); i++)
+    separateObjects(worker.groups[i], spread, worker.scratch, worker.objects);
+}
+
+/*********************************************************************
+ ** Function: Run Soup
+ ** Description: seeds soup number index, runs it until its population is
+ periodic and counts its objects. Returns false if the population is still
+ not periodic after the generation limit.
+ *********************************************************************/
+static bool runSoup(CensusJob &job, CensusWorker &worker, long long index, long long &stepped)
+{
+  fillSoup(worker.board, job.density, hashMix(job.seed + hashMix((uint64_t)index)));
+
+  /** centred in a chunk, a soup takes one chunk instead of four until it spreads **/
+  const int top = std::max(0, (CHUNK_SIZE - job.rows) / 2),
+            left = std::max(0, (CHUNK_SIZE - job.columns) / 2);
+  worker.soup.clear();
+  for (int r = 0; r < job.rows; r++)
+    for (int c = 0; c < job.columns; c++)
+      if (worker.board.get(r, c))
+        worker.soup.set(top + r, left + c, true);
+  worker.populations.clear();
+  worker.populations.push_back(worker.soup.population());
+
+  int period = 0;
+  long long generation = 0;
+  while (period == 0 && generation < job.generations)
+  {
+    worker.soup.step(1);
+    worker.populations.push_back(worker.soup.population());
+    generation++;
+    if (generation % CENSUS_CHECK_EVERY == 0 || generation == job.generations)
+      period = populationPeriod(worker.populations);
+  }
+  stepped += generation;
+  GOL_STAT_ADD(STAT_SOUPS, 1);
+  if (period == 0)
+    return false;
+
+  splitObjects(worker, std::max(period, CENSUS_MIN_SPREAD));
+  for (std::size_t i = 0; i < worker.objects.size(); i++)
+  {
+    std::string shape = wechslerCode(worker.objects[i]);
+    std::unordered_map<std::string, std::string>::const_iterator known = worker.names.find(shape);
+    if (known == worker.names.end())
+    {
+      if (worker.names.size() >= CENSUS_MEMO_LIMIT)
+        worker.names.clear();
+      known = worker.names.emplace(shape, classifyObject(worker.objects[i], worker.scratch)).first;
+    }
+    job.table->add(known->second);
+  }
+  return true;
+}
+
+static void censusTask(void *context, int worker)
+{
+  CensusJob &job = *static_cast<CensusJob *>(context);
+  CensusWorker state(job);
+  long long index, stepped = 0, unstabilized = 0;
+
+  while (job.work->next(worker, index))
+    if (!runSoup(job, state, index, stepped))
+      unstabilized++;
+
+  job.stepped += stepped;
+  job.unstabilized += unstabilized;
+}
+
+int runCensus(const Options &options, std::ostream &out)
+{
+  Rule rule;
+  if (!options.rule.empty())
+    rule = Rule::parse(options.rule);
+  if (rule.states() > 2)
+    throw std::invalid_argument("--census: soups run on the sparse engine, which cannot run the Generations rule "
+                                + rule.notation());
+
+  const long long soups = options.soups > 0 ? options.soups : CENSUS_SOUPS;
+  const int threads = options.threads > 0 ? options.threads : hardwareThreads();
+  CensusTable table;
+  WorkStealer work(soups, threads);
+
+  CensusJob job;
+  job.rule = rule;
+  job.rows = options.rows > 0 ? options.rows : CENSUS_ROWS;
+  job.columns = options.columns > 0 ? options.columns : CENSUS_COLUMNS;
+  job.density = options.density;
+  job.seed = options.seed;
+  job.generations = options.generations >= 0 ? options.generations : CENSUS_GENERATIONS;
+  job.work = &work;
+  job.table = &table;
+  job.unstabilized = 0;
+  job.stepped = 0;
+
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  {
+    ThreadPool pool(threads, false);
+    pool.run(censusTask, &job);
+  }
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  std::vector<std::pair<std::string, long long> > objects = table.sorted();
+  long long total = 0;
+  for (std::size_t i = 0; i < objects.size(); i++)
+    total += objects[i].second;
+
+  out << "{\"rule\": \"" << rule.notation() << "\""
+      << ", \"soups\": " << soups
+      << ", \"rows\": " << job.rows << ", \"columns\": " << job.columns
+      << ", \"density\": " << job.density
+      << ", \"seed\": " << job.seed
+      << ", \"threads\": " << threads
+      << ", \"seconds\": " << seconds
+      << ", \"soups_per_second\": " << (seconds > 0 ? soups / seconds : 0)
+      << ", \"generations_per_second\": " << (seconds > 0 ? job.stepped / seconds : 0)
+      << ", \"steals\": " << work.stolen()
+      << ", \"unstabilized\": " << job.unstabilized
+      << ", \"objects\": " << total
+      << ", \"census\": {";
+  for (std::size_t i = 0; i < objects.size(); i++)
+    out << (i > 0 ? ", " : "") << "\"" << objects[i].first << "\": " << objects[i].second;
+  out << "}}" << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,107 @@
+/************************************************************************************************
+ ** Program       Filename: GameOfLife
+ ** Current       File: golCensus.hpp
+ ** Author:       Jordan Grant
+ ** Date:         10.17.26
+ ** Description: 	Random soup census. Many small soups are each run on an unbounded
+ SparseLife until their population turns periodic, and what they settle into is split
+ into separate objects, each named by a canonical code and counted. Soup i is seeded
+ from the run's seed and i alone, so a census is the same however the soups are shared
+ out between threads.
+ **************************************************************************************************/
+
+
+#ifndef GOLCENSUS_HPP
+#define GOLCENSUS_HPP
+
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "golOptions.hpp"
+#include "golSparse.hpp"
+
+/** longest period looked for, both in a soup's population and in a single object **/
+#define CENSUS_MAX_PERIOD 60
+#define CENSUS_STRIPES 64
+
+/*********************************************************************
+ ** Function: Wechsler Code
+ ** Description: the extended Wechsler code of cells as they lie: rows in
+ strips of 5, each column of a strip one character 0-9a-v, runs of empty
+ columns shortened to w (2), x (3) or y0-yz (4 to 39), strips joined by z.
+ Cells are moved so the top left of their bounding box is (0, 0) first.
+ ** Pre-Conditions: cells is not empty
+ *********************************************************************/
+std::string wechslerCode(const std::vector<LifeCell> &cells);
+
+/*********************************************************************
+ ** Function: Classify Object
+ ** Description: names a single object apgcode style: xs<cells>_ for a still
+ life, xp<period>_ for an oscillator, xq<period>_ for a spaceship, followed
+ by the smallest Wechsler code (shortest, then first in ASCII order) over
+ every phase and the 8 rotations and reflections, so the name does not
+ depend on how the object lies or which phase it was found in. Objects that
+ do not come back to their shape within CENSUS_MAX_PERIOD generations
+ when run alone are "unknown".
+ ** Parameters: the object's live cells, a universe running the census rule
+ to run it in (cleared first)
+ *********************************************************************/
+std::string classifyObject(const std::vector<LifeCell> &cells, SparseLife &scratch);
+
+/*********************************************************************
+ ** Function: Separate Objects
+ ** Description: splits a group of cells that lie close together into the
+ objects it is made of. The group is cut into its touching (8-connected)
+ pieces; two pieces that change each other within generations generations
+ are joined, and the pieces left are kept apart only if, run alone and put
+ back together, they give the group's own cells every generation. Otherwise
+ the group is one object.
+ ** Parameters: the cells, generations to run them (at least the period), a
+ universe running the census rule (cleared), objects to append to
+ *********************************************************************/
+void separateObjects(const std::vector<LifeCell> &cells, int generations, SparseLife &scratch,
+                     std::vector<std::vector<LifeCell> > &objects);
+
+/*********************************************************************
+ ** Class: CensusTable
+ ** Description: object counts shared by every census thread. The names are
+ spread over CENSUS_STRIPES maps by hash, each behind its own lock, so
+ threads only wait for each other when they count names in the same stripe.
+ *********************************************************************/
+class CensusTable
+{
+public:
+  void add(const std::string &object, long long count = 1);
+
+  /** every object and its count, most common first and then by name **/
+  std::vector<std::pair<std::string, long long> > sorted() const;
+
+private:
+  struct alignas(64) Stripe
+  {
+    mutable std::mutex lock;
+    std::unordered_map<std::string, long long> counts;
+  };
+
+  Stripe stripes[CENSUS_STRIPES];
+};
+
+/*********************************************************************
+ ** Function: Run Census
+ ** Description: runs options.soups soups (default 10000) of rows x columns
+ cells (default 16x16) at options.density, one thread per cpu unless
+ options.threads says otherwise, each for at most options.generations
+ generations (default 20000), and writes one line of JSON:
+ {"rule": ..., "soups": ..., "seconds": ..., "soups_per_second": ...,
+  "unstabilized": ..., "objects": ..., "census": {"xs4_33": ..., ...}}
+ Soups still changing at the limit are counted as unstabilized and left
+ out of the census.
+ ** Post-Conditions: returns the exit status; throws std::invalid_argument
+ for a Generations rule
+ *********************************************************************/
+int runCensus(const Options &options, std::ostream &out);
+
+#endif
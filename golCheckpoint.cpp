@@ -0,0 +1,444 @@
+/**************************************************************************************************
+ ** Program       Filename: GameOfLife
+ ** Current       File: golCheckpoint.cpp
+ ** Author:       Jordan Grant
+ ** Date:         10.17.26
+ ** Description: 	Binary checkpoints (see golCheckpoint.hpp).
+ *****************************************************************************************************/
+
+#include "golCheckpoint.hpp"
+#include "golPattern.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+/** words buffered by the compressed writer before each write() **/
+#define ENCODE_BUFFER_WORDS 8192
+
+/** zero runs shorter than this stay inside a literal run; a record costs two words **/
+#define MIN_ZERO_RUN 3
+
+static void fileError(const std::string &path, int error)
+{
+  throw std::runtime_error(path + ": " + std::strerror(error));
+}
+
+static void writeAll(int fd, const std::string &path, const void *data, std::size_t bytes)
+{
+  const char *p = static_cast<const char *>(data);
+
+  while (bytes > 0)
+  {
+    ssize_t done = write(fd, p, bytes);
+    if (done < 0)
+    {
+      if (errno == EINTR)
+        continue;
+      fileError(path, errno);
+    }
+    p += done;
+    bytes -= (std::size_t)done;
+  }
+}
+
+/*********************************************************************
+ ** Function: Write Compressed
+ ** Description: zero run encodes words[0, count) to fd
+ ** Post-Conditions: returns the number of bytes written
+ *********************************************************************/
+static uint64_t writeCompressed(int fd, const std::string &path, const uint64_t *words,
+                                std::size_t count)
+{
+  std::vector<uint64_t> out;
+  uint64_t bytes = 0;
+  std::size_t w = 0;
+
+  out.reserve(ENCODE_BUFFER_WORDS);
+  while (w < count)
+  {
+    std::size_t zeros = 0;
+    while (w + zeros < count && words[w + zeros] == 0)
+      zeros++;
+    w += zeros;
+
+    /** a literal run ends at the first zero run long enough to be worth a record **/
+    std::size_t literals = 0, gap = 0;
+    while (w + literals + gap < count)
+    {
+      if (words[w + literals + gap] != 0)
+      {
+        literals += gap + 1;
+        gap = 0;
+      }
+      else if (++gap == MIN_ZERO_RUN)
+        break;
+    }
+
+    if (out.size() + 2 + literals > ENCODE_BUFFER_WORDS)
+    {
+      writeAll(fd, path, out.data(), out.size() * sizeof(uint64_t));
+      bytes += out.size() * sizeof(uint64_t);
+      out.clear();
+    }
+
+    out.push_back(zeros);
+    out.push_back(literals);
+    if (literals + 2 <= ENCODE_BUFFER_WORDS)
+      out.insert(out.end(), words + w, words + w + literals);
+    else
+    {
+      writeAll(fd, path, out.data(), out.size() * sizeof(uint64_t));
+      bytes += out.size() * sizeof(uint64_t);
+      out.clear();
+      writeAll(fd, path, words + w, literals * sizeof(uint64_t));
+      bytes += literals * sizeof(uint64_t);
+    }
+    w += literals;
+  }
+
+  writeAll(fd, path, out.data(), out.size() * sizeof(uint64_t));
+  return bytes + out.size() * sizeof(uint64_t);
+}
+
+void saveCheckpoint(const std::string &path, const BitGrid &board, long long generation,
+                    const Rule &rule, bool compress)
+{
+  if (board.data() == NULL)
+    throw std::invalid_argument("saveCheckpoint: empty board");
+  if (rule.states() > 2)
+    throw std::invalid_argument("saveCheckpoint: checkpoints hold live and dead cells only, not "
+                                "the dying states of " + rule.notation());
+
+  const std::string temporary = path + ".tmp";
+  int fd = open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0)
+    fileError(temporary, errno);
+
+  try
+  {
+    static char page[CHECKPOINT_HEADER_BYTES];
+    CheckpointHeader header;
+
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, CHECKPOINT_MAGIC, sizeof(header.magic));
+    header.version = CHECKPOINT_VERSION;
+    header.flags = compress ? CHECKPOINT_COMPRESSED : 0;
+    header.rows = board.rows();
+    header.columns = board.columns();
+    header.generation = generation;
+    header.population = board.population();
+    header.words = board.words();
+    header.stride = board.stride();
+    header.boardBytes = board.bufferBytes();
+    std::strncpy(header.rule, rule.notation().c_str(), sizeof(header.rule) - 1);
+
+    /** the header page goes in last, once the payload size is known **/
+    writeAll(fd, temporary, page, sizeof(page));
+    if (compress)
+      header.payloadBytes = writeCompressed(fd, temporary, board.data(),
+                                            board.bufferBytes() / sizeof(uint64_t));
+    else
+    {
+      writeAll(fd, temporary, board.data(), board.bufferBytes());
+      header.payloadBytes = board.bufferBytes();
+    }
+
+    if (pwrite(fd, &header, sizeof(header), 0) != (ssize_t)sizeof(header) || fsync(fd) != 0)
+      fileError(temporary, errno);
+  }
+  catch (...)
+  {
+    close(fd);
+    unlink(temporary.c_str());
+    throw;
+  }
+
+  if (close(fd) != 0)
+  {
+    int error = errno;
+    unlink(temporary.c_str());
+    fileError(temporary, error);
+  }
+  if (rename(temporary.c_str(), path.c_str()) != 0)
+  {
+    int error = errno;
+    unlink(temporary.c_str());
+    fileError(path, error);
+  }
+}
+
+static void badCheckpoint(const std::string &path, const char *what)
+{
+  throw std::runtime_error(path + ": " + what);
+}
+
+/*********************************************************************
+ ** Function: Check Checkpoint Board
+ ** Description: a board as saved has a dead halo and dead padding, which the
+ engines step from without clearing, and the live cells the header counted.
+ A damaged or edited file that breaks either is refused rather than stepped.
+ *********************************************************************/
+static void checkCheckpointBoard(const std::string &path, const CheckpointHeader &header,
+                                 const BitGrid &board)
+{
+  const std::size_t stride = board.stride(), words = board.words();
+
+  for (int r = -1; r <= board.rows(); r++)
+  {
+    const uint64_t *line = board.row(r) - LINE_WORDS;
+    const bool halo = r < 0 || r == board.rows();
+
+    for (std::size_t w = 0; w < stride; w++)
+    {
+      uint64_t dead = ~(uint64_t)0;
+      if (!halo && w >= LINE_WORDS && w - LINE_WORDS < words)
+        dead = w - LINE_WORDS == words - 1 ? ~board.lastWordMask() : 0;
+      if (line[w] & dead)
+        badCheckpoint(path, "board has live cells in its halo or padding");
+    }
+  }
+  if (board.population() != header.population)
+    badCheckpoint(path, "board population does not match the header");
+}
+
+/*********************************************************************
+ ** Function: Decode Checkpoint
+ ** Description: expands a zero run encoded payload into board's buffer
+ *********************************************************************/
+static void decodeCheckpoint(const std::string &path, const CheckpointHeader &header,
+                             BitGrid &board)
+{
+  MappedFile file(path);
+  const uint64_t *in = reinterpret_cast<const uint64_t *>(file.begin() + CHECKPOINT_HEADER_BYTES);
+  const uint64_t inWords = header.payloadBytes / sizeof(uint64_t);
+  const uint64_t outWords = board.bufferBytes() / sizeof(uint64_t);
+  uint64_t *out = board.row(-1) - LINE_WORDS;
+  uint64_t i = 0, o = 0;
+
+  if (header.payloadBytes % sizeof(uint64_t) != 0)
+    badCheckpoint(path, "compressed payload is not whole words");
+
+  while (i < inWords)
+  {
+    if (inWords - i < 2)
+      badCheckpoint(path, "compressed payload ends mid record");
+
+    uint64_t zeros = in[i], literals = in[i + 1];
+    i += 2;
+    if (zeros > outWords - o || literals > outWords - o - zeros || literals > inWords - i)
+      badCheckpoint(path, "compressed record overruns the board");
+
+    std::memset(out + o, 0, zeros * sizeof(uint64_t));
+    o += zeros;
+    std::memcpy(out + o, in + i, literals * sizeof(uint64_t));
+    o += literals;
+    i += literals;
+  }
+
+  /** trailing zero words need no record **/
+  std::memset(out + o, 0, (outWords - o) * sizeof(uint64_t));
+}
+
+BitGrid loadCheckpoint(const std::string &path, CheckpointInfo *info)
+{
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+    fileError(path, errno);
+
+  CheckpointHeader header;
+  struct stat status;
+  BitGrid board;
+  Rule rule;
+
+  try
+  {
+    if (fstat(fd, &status) != 0)
+      fileError(path, errno);
+    if (pread(fd, &header, sizeof(header), 0) != (ssize_t)sizeof(header))
+      badCheckpoint(path, "too short for a checkpoint header");
+
+    header.rule[sizeof(header.rule) - 1] = '\0';
+    if (std::memcmp(header.magic, CHECKPOINT_MAGIC, sizeof(header.magic)) != 0)
+      badCheckpoint(path, "not a checkpoint file");
+    if (header.version != CHECKPOINT_VERSION)
+      badCheckpoint(path, "unsupported checkpoint version");
+    try
+    {
+      rule = Rule::parse(header.rule);
+    }
+    catch (const std::invalid_argument &)
+    {
+      badCheckpoint(path, "checkpoint uses an unsupported rule");
+    }
+    if (header.rows <= 0 || header.columns <= 0)
+      badCheckpoint(path, "bad board dimensions");
+    if ((uint64_t)status.st_size < CHECKPOINT_HEADER_BYTES
+        || (uint64_t)status.st_size - CHECKPOINT_HEADER_BYTES != header.payloadBytes)
+      badCheckpoint(path, "file size does not match the header");
+
+    if (header.flags & CHECKPOINT_COMPRESSED)
+    {
+      board = BitGrid(header.rows, header.columns);
+      if (board.bufferBytes() != header.boardBytes || board.words() != header.words
+          || board.stride() != header.stride)
+        badCheckpoint(path, "board layout does not match this build");
+      decodeCheckpoint(path, header, board);
+      checkCheckpointBoard(path, header, board);
+    }
+    else
+    {
+      if (header.payloadBytes != header.boardBytes)
+        badCheckpoint(path, "payload size does not match the board");
+
+      void *mapping = mmap(NULL, header.boardBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd,
+                           CHECKPOINT_HEADER_BYTES);
+      if (mapping == MAP_FAILED)
+        fileError(path, errno);
+      try
+      {
+        board = BitGrid::adoptMapping(header.rows, header.columns, mapping, header.boardBytes);
+      }
+      catch (const std::invalid_argument &)
+      {
+        munmap(mapping, header.boardBytes);
+        badCheckpoint(path, "board layout does not match this build");
+      }
+      if (board.words() != header.words || board.stride() != header.stride)
+        badCheckpoint(path, "board layout does not match this build");
+      checkCheckpointBoard(path, header, board);
+    }
+  }
+  catch (...)
+  {
+    close(fd);
+    throw;
+  }
+  close(fd);
+
+  if (info != NULL)
+  {
+    info->rows = header.rows;
+    info->columns = header.columns;
+    info->generation = header.generation;
+    info->population = header.population;
+    info->compressed = (header.flags & CHECKPOINT_COMPRESSED) != 0;
+    info->rule = rule;
+  }
+  return board;
+}
+
+void saveCheckpoint(const std::string &path, const Engine &engine, bool compress)
+{
+  BitGrid board(engine.rows(), engine.columns());
+
+  engine.storeBits(board);
+  saveCheckpoint(path, board, engine.generation(), engine.rule(), compress);
+}
+
+void restoreCheckpoint(const std::string &path, Engine &engine)
+{
+  CheckpointInfo info;
+  BitGrid board = loadCheckpoint(path, &info);
+
+  if (info.rows != engine.rows() || info.columns != engine.columns())
+    throw std::runtime_error(path + ": checkpoint board size differs from the engine's");
+  if (info.rule != engine.rule())
+    throw std::runtime_error(path + ": checkpoint runs " + info.rule.notation() + ", the engine "
+                             + engine.rule().notation());
+
+  engine.adoptBits(board);
+  engine.setGeneration(info.generation);
+}
+
+CheckpointWriter::CheckpointWriter(const std::string &path, bool compress)
+  : path(path), compress(compress), snapshotGeneration(0), busy(false), writtenCount(0),
+    skippedCount(0), stopping(false)
+{
+  writer = std::thread(&CheckpointWriter::writerLoop, this);
+}
+
+CheckpointWriter::~CheckpointWriter()
+{
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (busy)
+      idle.wait(lock);
+    stopping = true;
+  }
+  wake.notify_one();
+  writer.join();
+}
+
+/*********************************************************************
+ ** Function: CheckpointWriter::observe
+ ** Description: the snapshot belongs to the writer thread while busy is set,
+ so it is only refilled once the previous checkpoint is on disk
+ *********************************************************************/
+void CheckpointWriter::observe(const Engine &engine)
+{
+  if (busy.load(std::memory_order_acquire))
+  {
+    skippedCount++;
+    return;
+  }
+
+  engine.storeBits(snapshot);
+  snapshotGeneration = engine.generation();
+  snapshotRule = engine.rule();
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    busy = true;
+  }
+  wake.notify_one();
+}
+
+void CheckpointWriter::flush()
+{
+  std::unique_lock<std::mutex> lock(mutex);
+  while (busy)
+    idle.wait(lock);
+}
+
+std::string CheckpointWriter::lastError()
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return error;
+}
+
+void CheckpointWriter::writerLoop()
+{
+  std::unique_lock<std::mutex> lock(mutex);
+
+  for (;;)
+  {
+    while (!busy && !stopping)
+      wake.wait(lock);
+    if (!busy)
+      return;
+
+    lock.unlock();
+    std::string failure;
+    try
+    {
+      saveCheckpoint(path, snapshot, snapshotGeneration, snapshotRule, compress);
+    }
+    catch (const std::exception &problem)
+    {
+      failure = problem.what();
+    }
+    lock.lock();
+
+    if (failure.empty())
+      writtenCount++;
+    else
+      error = failure;
+    busy = false;
+    idle.notify_all();
+  }
+}
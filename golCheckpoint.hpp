@@ -0,0 +1,151 @@
+/************************************************************************************************
+ ** Program       Filename: GameOfLife
+ ** Current       File: golCheckpoint.hpp
+ ** Author:       Jordan Grant
+ ** Date:         10.17.26
+ ** Description: 	Binary checkpoints. A checkpoint file is one 4096 byte header page followed
+ by the board's BitGrid buffer exactly as it sits in memory (halo rows and row padding
+ included), so restoring an uncompressed checkpoint is a single MAP_PRIVATE mmap of the
+ payload that BitGrid adopts as its buffer: nothing is parsed or copied up front, and
+ the mapping is only read once, to check that the halo and padding are dead and the
+ population matches the header. Sparse boards may instead be
+ written with zero runs squeezed out, which costs one decoding pass on restore.
+ Files are written to "<path>.tmp" and renamed into place, so a crash mid write never
+ leaves a torn checkpoint behind. Numbers are stored in native byte order.
+ **************************************************************************************************/
+
+
+#ifndef GOLCHECKPOINT_HPP
+#define GOLCHECKPOINT_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "golBitGrid.hpp"
+#include "golEngine.hpp"
+
+#define CHECKPOINT_MAGIC "GOLCKPT1"
+#define CHECKPOINT_VERSION 1
+#define CHECKPOINT_HEADER_BYTES 4096
+
+enum CheckpointFlags
+{
+  CHECKPOINT_COMPRESSED = 1    // payload is zero run encoded
+};
+
+/*********************************************************************
+ ** Struct: CheckpointHeader
+ ** Description: start of the header page; the rest of the page is zero.
+ A compressed payload is a sequence of records, each two words (zero words
+ to skip, literal words that follow) and then the literal words themselves,
+ covering boardBytes of board buffer in order.
+ *********************************************************************/
+struct CheckpointHeader
+{
+  char magic[8];
+  uint32_t version;
+  uint32_t flags;
+  int32_t rows;
+  int32_t columns;
+  int64_t generation;
+  int64_t population;
+  uint64_t words;           // words of cells per row
+  uint64_t stride;          // words between rows
+  uint64_t boardBytes;      // BitGrid::bufferBytes()
+  uint64_t payloadBytes;    // bytes after the header page
+  char rule[32];            // B/S notation, e.g. "B3/S23"
+};
+
+struct CheckpointInfo
+{
+  int rows;
+  int columns;
+  long long generation;
+  long long population;
+  bool compressed;
+  Rule rule;
+};
+
+/*********************************************************************
+ ** Function: Save Checkpoint
+ ** Description: writes board as generation to path (via path.tmp and a rename)
+ ** Parameters: file path, board, its generation number, the rule it runs,
+ whether to zero run encode the payload
+ ** Post-Conditions: throws std::runtime_error if the file cannot be written;
+ an existing checkpoint at path is then left as it was. A Generations rule is
+ a std::invalid_argument: a checkpoint has no room for the dying states.
+ *********************************************************************/
+void saveCheckpoint(const std::string &path, const BitGrid &board, long long generation,
+                    const Rule &rule, bool compress);
+
+/*********************************************************************
+ ** Function: Load Checkpoint
+ ** Description: reads a checkpoint. Uncompressed payloads are mapped, not read.
+ ** Parameters: file path, optional place for the header fields
+ ** Post-Conditions: returns the board; throws std::runtime_error if the file
+ cannot be read or is not a valid checkpoint, including a board with live
+ halo or padding bits or a population other than the header's
+ *********************************************************************/
+BitGrid loadCheckpoint(const std::string &path, CheckpointInfo *info = NULL);
+
+/*********************************************************************
+ ** Function: Save / Restore Checkpoint (engine)
+ ** Description: checkpoint an engine's current generation and rule, or load
+ one back into an engine of the same size and rule with its generation
+ number. The bit engine adopts a mapped board without copying it.
+ ** Post-Conditions: restoreCheckpoint() throws std::runtime_error if the size
+ or rule differ from the engine's
+ *********************************************************************/
+void saveCheckpoint(const std::string &path, const Engine &engine, bool compress);
+void restoreCheckpoint(const std::string &path, Engine &engine);
+
+/*********************************************************************
+ ** Class: CheckpointWriter
+ ** Description: observer that checkpoints the board in the background. On each
+ observed generation the board is copied into a snapshot (storeBits()) and
+ handed to a writer thread, so the stepping thread only pays for the copy. If
+ the previous checkpoint is still being written the generation is skipped
+ rather than waited for. Attach it with Simulation::addObserver(writer, every).
+ ** Post-Conditions: the destructor waits for a checkpoint in flight
+ *********************************************************************/
+class CheckpointWriter : public GenerationObserver
+{
+public:
+  CheckpointWriter(const std::string &path, bool compress);
+  ~CheckpointWriter();
+
+  void observe(const Engine &engine);
+  /** waits until no checkpoint is being written **/
+  void flush();
+
+  long long written() const { return writtenCount; }
+  long long skipped() const { return skippedCount; }
+  /** message of the last failed write, empty if none failed **/
+  std::string lastError();
+
+private:
+  CheckpointWriter(const CheckpointWriter &);
+  CheckpointWriter &operator=(const CheckpointWriter &);
+
+  void writerLoop();
+
+  std::string path;
+  bool compress;
+  BitGrid snapshot;
+  long long snapshotGeneration;
+  Rule snapshotRule;
+  std::atomic<bool> busy;
+  std::atomic<long long> writtenCount;
+  long long skippedCount;
+  bool stopping;
+  std::string error;
+  std::mutex mutex;
+  std::condition_variable wake;
+  std::condition_variable idle;
+  std::thread writer;
+};
+
+#endif
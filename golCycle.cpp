@@ -0,0 +1,144 @@
+/**************************************************************************************************
+ ** Program       Filename: GameOfLife
+ ** Current       File: golCycle.cpp
+ ** Author:       Jordan Grant
+ ** Date:         10.17.26
+ ** Description: 	Board hashing and cycle detection (see golCycle.hpp).
+ *****************************************************************************************************/
+
+#include "golCycle.hpp"
+
+#include <stdexcept>
+
+uint64_t hashBitGrid(const BitGrid &board)
+{
+  uint64_t hash = 0;
+
+  for (int r = 0; r < board.rows(); r++)
+  {
+    const uint64_t *words = board.row(r);
+    const uint64_t seed = hashRowSeed(r);
+    const std::size_t last = board.words() - 1;
+
+    for (std::size_t w = 0; w < last; w++)
+      hash ^= hashWordKey(seed, (long long)w, words[w]);
+    hash ^= hashWordKey(seed, (long long)last, words[last] & board.lastWordMask());
+  }
+  return hash;
+}
+
+uint64_t hashGrid(const Grid &board, int planes)
+{
+  const std::size_t words = (std::size_t)(board.columns() + WORD_BITS - 1) / WORD_BITS;
+  uint64_t hash = 0;
+
+  for (int plane = 0; plane < planes; plane++)
+    for (int r = 0; r < board.rows(); r++)
+    {
+      const unsigned char *cells = board.row(r);
+      const uint64_t seed = hashRowSeed((long long)plane * board.rows() + r);
+
+      for (std::size_t w = 0; w < words; w++)
+      {
+        int first = (int)w * WORD_BITS;
+        int count = board.columns() - first < WORD_BITS ? board.columns() - first : WORD_BITS;
+        uint64_t word = 0;
+
+        for (int i = 0; i < count; i++)
+          word |= (uint64_t)((cells[first + i] >> plane) & 1) << i;
+        hash ^= hashWordKey(seed, (long long)w, word);
+      }
+    }
+  return hash;
+}
+
+CycleDetector::CycleDetector(std::size_t history)
+  : hashes(history), recorded(0), firstGeneration(0), cyclePeriod(0), cycleStart(0)
+{
+  if (history == 0)
+    throw std::invalid_argument("CycleDetector: history must be positive");
+
+  /** at most history entries, so the table is never more than half full **/
+  std::size_t slots = 16;
+  while (slots < 2 * history)
+    slots *= 2;
+  Seen empty = { 0, -1 };
+  seen.assign(slots, empty);
+}
+
+void CycleDetector::reset()
+{
+  for (std::size_t i = 0; i < seen.size(); i++)
+    seen[i].generation = -1;
+  recorded = 0;
+  cyclePeriod = cycleStart = 0;
+}
+
+/** the slot holding hash, or the empty slot where it would go (linear probing) **/
+std::size_t CycleDetector::find(uint64_t hash) const
+{
+  const std::size_t mask = seen.size() - 1;
+  std::size_t slot = (std::size_t)hash & mask;
+
+  while (seen[slot].generation >= 0 && seen[slot].hash != hash)
+    slot = (slot + 1) & mask;
+  return slot;
+}
+
+/** empties slot, pulling later entries of its probe run back (backward shift deletion) **/
+void CycleDetector::erase(std::size_t slot)
+{
+  const std::size_t mask = seen.size() - 1;
+  std::size_t hole = slot;
+
+  for (std::size_t next = (hole + 1) & mask; seen[next].generation >= 0; next = (next + 1) & mask)
+  {
+    std::size_t home = (std::size_t)seen[next].hash & mask;
+    if (((next - home) & mask) >= ((next - hole) & mask))
+    {
+      seen[hole] = seen[next];
+      hole = next;
+    }
+  }
+  seen[hole].generation = -1;
+}
+
+/*********************************************************************
+ ** Function: CycleDetector::record
+ ** Description: the history is a ring indexed by generation; the generation
+ that falls out of it is dropped from the lookup table unless its hash has
+ been seen again since (the table keeps the latest generation of a hash)
+ *********************************************************************/
+bool CycleDetector::record(long long generation, uint64_t hash)
+{
+  if (found())
+    return true;
+  if (recorded == 0)
+    firstGeneration = generation;
+
+  const std::size_t size = hashes.size();
+  std::size_t slot = find(hash);
+  if (seen[slot].generation >= 0)
+  {
+    cyclePeriod = generation - seen[slot].generation;
+    cycleStart = seen[slot].generation;
+    return true;
+  }
+
+  if ((std::size_t)recorded >= size)
+  {
+    long long oldest = generation - (long long)size;
+    std::size_t old = find(hashes[(std::size_t)(oldest - firstGeneration) % size]);
+    if (seen[old].generation == oldest)
+    {
+      erase(old);
+      slot = find(hash);
+    }
+  }
+
+  hashes[(std::size_t)(generation - firstGeneration) % size] = hash;
+  seen[slot].hash = hash;
+  seen[slot].generation = generation;
+  recorded++;
+  return false;
+}
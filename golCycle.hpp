@@ -0,0 +1,110 @@
+/************************************************************************************************
+ ** Program       Filename: GameOfLife
+ ** Current       File: golCycle.hpp
+ ** Author:       Jordan Grant
+ ** Date:         10.17.26
+ ** Description: 	Board hashing and cycle detection. A board's hash is the XOR of one
+ key per 64 cell word, Zobrist style, except that the key of a word is mixed from its
+ position and its cells instead of being looked up in a table of random keys (a table
+ would be as big as the board). Because the keys are XORed, a step that rewrites a word
+ only has to XOR out the old key and XOR in the new one, so engines keep the hash up
+ to date from the words they change while stepping. A CycleDetector keeps a bounded
+ history of those hashes and reports the first generation that repeats one: a still
+ life (or a dead board) is period 1, an oscillator its period.
+ **************************************************************************************************/
+
+
+#ifndef GOLCYCLE_HPP
+#define GOLCYCLE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "golBitGrid.hpp"
+
+/** the splitmix64 finalizer **/
+static inline uint64_t hashMix(uint64_t x)
+{
+  x ^= x >> 30;
+  x *= 0xbf58476d1ce4e5b9ULL;
+  x ^= x >> 27;
+  x *= 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+/** per row part of a word key, computed once per row **/
+static inline uint64_t hashRowSeed(long long row)
+{
+  return hashMix((uint64_t)row * 0x9e3779b97f4a7c15ULL + 0x632be59bd9b4e019ULL);
+}
+
+/** key of the word at (row, word) holding cells; an empty word has key 0 **/
+static inline uint64_t hashWordKey(uint64_t rowSeed, long long word, uint64_t cells)
+{
+  return cells ? hashMix((cells ^ rowSeed) + (uint64_t)word * 0xd6e8feb86659fd93ULL) : 0;
+}
+
+/*********************************************************************
+ ** Function: Hash Bit Grid
+ ** Description: the hash of a whole board, the XOR of the keys of its words
+ (bits past columns() are not cells and are left out). stepBitRows() can
+ keep this up to date instead of it being recomputed.
+ *********************************************************************/
+uint64_t hashBitGrid(const BitGrid &board);
+
+/*********************************************************************
+ ** Function: Hash Grid
+ ** Description: the hash of a byte per cell board. Bit i of every cell's
+ value is hashed as a board of its own, placed below the others (rows
+ i * rows() on), so a 0 / 1 Grid hashes like its BitGrid and a Generations
+ board like the GenerationsEngine's bit planes.
+ ** Parameters: board, bits of each cell to hash (Rule::stateBits())
+ *********************************************************************/
+uint64_t hashGrid(const Grid &board, int planes = 1);
+
+/*********************************************************************
+ ** Class: CycleDetector
+ ** Description: the hashes of the last history() generations, looked up by
+ hash. record() is given every generation in order; when a hash comes back
+ the board has entered a cycle: period() generations long, first seen at
+ start(). Periods longer than the history are not seen. The lookup table is
+ open addressed and sized for the history up front, so recording never
+ allocates.
+ ** Pre-Conditions: history must be positive. Generations must be recorded
+ one after another and are not negative; anything else (e.g. a new board)
+ needs a reset() first.
+ *********************************************************************/
+class CycleDetector
+{
+public:
+  explicit CycleDetector(std::size_t history = 1024);
+
+  /** returns true if the board at generation repeats one in the history **/
+  bool record(long long generation, uint64_t hash);
+  void reset();
+
+  std::size_t history() const { return hashes.size(); }
+  bool found() const { return cyclePeriod > 0; }
+  long long period() const { return cyclePeriod; }
+  long long start() const { return cycleStart; }
+
+private:
+  /** a hash and the latest generation it was seen in; empty slots hold generation -1 **/
+  struct Seen
+  {
+    uint64_t hash;
+    long long generation;
+  };
+
+  std::size_t find(uint64_t hash) const;
+  void erase(std::size_t slot);
+
+  std::vector<uint64_t> hashes;
+  std::vector<Seen> seen;
+  long long recorded;
+  long long firstGeneration;
+  long long cyclePeriod;
+  long long cycleStart;
+};
+
+#endif
@@ -0,0 +1,607 @@
+/**************************************************************************************************
+ ** Program       Filename: GameOfLife
+ ** Current       File: golDistributed.cpp
+ ** Author:       Jordan Grant
+ ** Date:         10.17.26
+ ** Description: 	Multi-process slab stepping (see golDistributed.hpp). The shared mapping
+ holds one mailbox per worker: a counter of the generations it has posted and, for
+ each generation parity, a copy of its top and bottom rows (with their halo words, so
+ a torus's wrapped columns travel with them). Two parities are enough: a worker can
+ only post generation g + 2 after it has read its neighbors' generation g + 1 rows,
+ which they post only after they have read its generation g rows. A control line in
+ front of the mailboxes holds an abort flag: a worker waiting on a neighbor gives up
+ when it is set, or when the front end that forked it has gone, so no worker spins on
+ for a neighbor that will never post. The front end waits for replies on every
+ worker's socket at once, so a worker that dies mid step is noticed straight away.
+ *****************************************************************************************************/
+
+#include "golDistributed.hpp"
+#include "golCycle.hpp"
+
+#include <atomic>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <cerrno>
+#include <signal.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+enum SlabCommand
+{
+  SLAB_LOAD,
+  SLAB_STORE,
+  SLAB_STEP,
+  SLAB_POPULATION,
+  SLAB_HASH,
+  SLAB_QUIT
+};
+
+/** the edge rows in a mailbox **/
+#define EDGE_TOP 0
+#define EDGE_BOTTOM 1
+
+struct SlabMessage
+{
+  int command;
+  long long argument;
+};
+
+/** sends or receives exactly bytes bytes; false if the other end has gone **/
+static bool sendAll(int socket, const void *data, std::size_t bytes)
+{
+  const char *next = static_cast<const char *>(data);
+
+  while (bytes > 0)
+  {
+    ssize_t count = ::send(socket, next, bytes, MSG_NOSIGNAL);
+    if (count <= 0)
+      return false;
+    next += count;
+    bytes -= (std::size_t)count;
+  }
+  return true;
+}
+
+static bool receiveAll(int socket, void *data, std::size_t bytes)
+{
+  char *next = static_cast<char *>(data);
+
+  while (bytes > 0)
+  {
+    ssize_t count = ::recv(socket, next, bytes, MSG_WAITALL);
+    if (count <= 0)
+      return false;
+    next += count;
+    bytes -= (std::size_t)count;
+  }
+  return true;
+}
+
+/** words in one posted edge row (halo words included), padded to whole cache lines **/
+static std::size_t edgeWords(int columns)
+{
+  std::size_t words = ((std::size_t)columns + WORD_BITS - 1) / WORD_BITS + 2;
+  return (words + LINE_WORDS - 1) / LINE_WORDS * LINE_WORDS;
+}
+
+/** a counter line followed by two parities of top and bottom rows **/
+static std::size_t mailboxWords(int columns)
+{
+  return LINE_WORDS + 4 * edgeWords(columns);
+}
+
+/** set once any worker has failed; the rest stop waiting for their neighbors **/
+static std::atomic<int> &abortFlag(void *shared)
+{
+  return *static_cast<std::atomic<int> *>(shared);
+}
+
+/** the mailboxes follow the control line **/
+static uint64_t *firstMailbox(void *shared)
+{
+  return static_cast<uint64_t *>(shared) + LINE_WORDS;
+}
+
+/** spins, and generations, between checks that the front end is still there **/
+#define PARENT_CHECK_SPINS 4096
+#define PARENT_CHECK_STEPS 1024
+
+/*********************************************************************
+ ** Class: SlabWorker
+ ** Description: the loop a forked worker runs: it owns rows [first, first +
+ rows) of the board in two BitGrids and answers commands from its socket
+ until it is told to quit or the front end goes away. The BitGrids take over
+ the two slab mappings the front end made before the fork, so the worker
+ never allocates: another thread of the front end may have held the heap's
+ lock at the moment of the fork, and only the forking thread is copied.
+ *********************************************************************/
+class SlabWorker
+{
+public:
+  SlabWorker(int index, int first, int rows, int columns, int up, int down, Topology topology,
+             const Rule &rule, void *shared, pid_t frontEnd, int socket, void *const slabs[2])
+    : index(index), first(first), up(up), down(down), topology(topology), rule(rule),
+      aborted(abortFlag(shared)), base(firstMailbox(shared)), mailboxSize(mailboxWords(columns)),
+      edgeSize(edgeWords(columns)), frontEnd(frontEnd), socket(socket), current(0), tick(0)
+  {
+    const std::size_t bytes = BitGrid::bufferBytesFor(rows, columns);
+    grids[0] = BitGrid::adoptMapping(rows, columns, slabs[0], bytes);
+    grids[1] = BitGrid::adoptMapping(rows, columns, slabs[1], bytes);
+  }
+
+  int run();
+
+private:
+  std::atomic<long long> &posted(int worker)
+  {
+    return *reinterpret_cast<std::atomic<long long> *>(base + (std::size_t)worker * mailboxSize);
+  }
+
+  uint64_t *edge(int worker, int parity, int side)
+  {
+    return base + (std::size_t)worker * mailboxSize + LINE_WORDS
+           + (std::size_t)(parity * 2 + side) * edgeSize;
+  }
+
+  bool stepOnce();
+  uint64_t hash() const;
+
+  const int index;
+  const int first;
+  const int up;
+  const int down;
+  const Topology topology;
+  const Rule rule;
+  std::atomic<int> &aborted;
+  uint64_t *const base;
+  const std::size_t mailboxSize;
+  const std::size_t edgeSize;
+  const pid_t frontEnd;
+  const int socket;
+  BitGrid grids[2];
+  int current;
+  /** generations stepped since the worker started, the same in every worker **/
+  long long tick;
+};
+
+/*********************************************************************
+ ** Function: SlabWorker::stepOnce
+ ** Description: posts the edge rows, steps the interior, then takes the
+ neighbors' edge rows into the halo and steps the two edge rows. A worker
+ with no neighbor on a side (the bounded edge of the board) keeps that halo
+ row dead. Returns false, mid step, if the abort flag is set or the front end
+ has gone while it waits; run() also looks for the front end every
+ PARENT_CHECK_STEPS generations, for the workers that seldom wait.
+ *********************************************************************/
+bool SlabWorker::stepOnce()
+{
+  BitGrid &from = grids[current];
+  BitGrid &to = grids[current ^ 1];
+  const int rows = from.rows();
+  const int parity = (int)(tick & 1);
+  const std::size_t bytes = (from.words() + 2) * sizeof(uint64_t);
+
+  if (topology == TOPOLOGY_TORUS)
+    wrapBitColumns(from, 0, rows);
+
+  std::memcpy(edge(index, parity, EDGE_TOP), from.row(0) - 1, bytes);
+  std::memcpy(edge(index, parity, EDGE_BOTTOM), from.row(rows - 1) - 1, bytes);
+  posted(index).store(tick + 1, std::memory_order_release);
+
+  if (rows > 2)
+    stepBitRows(from, to, 1, rows - 1, rule);
+
+  const int neighbors[2] = { up, down };
+  for (int side = 0; side < 2; side++)
+  {
+    if (neighbors[side] < 0)
+      continue;
+
+    std::atomic<long long> &ready = posted(neighbors[side]);
+    for (int spins = 0; ready.load(std::memory_order_acquire) <= tick; spins++)
+      if (spins >= 128)
+      {
+        std::this_thread::yield();
+        if (aborted.load(std::memory_order_relaxed)
+            || (spins % PARENT_CHECK_SPINS == 0 && getppid() != frontEnd))
+          return false;
+      }
+
+    /** the row above comes from the bottom of the slab above, and the other way round **/
+    if (side == 0)
+      std::memcpy(from.row(-1) - 1, edge(up, parity, EDGE_BOTTOM), bytes);
+    else
+      std::memcpy(from.row(rows) - 1, edge(down, parity, EDGE_TOP), bytes);
+  }
+
+  stepBitRows(from, to, 0, 1, rule);
+  if (rows > 1)
+    stepBitRows(from, to, rows - 1, rows, rule);
+
+  current ^= 1;
+  tick++;
+  return true;
+}
+
+/** the slab's share of hashBitGrid(): its rows are hashed as the board rows they are **/
+uint64_t SlabWorker::hash() const
+{
+  const BitGrid &board = grids[current];
+  const std::size_t last = board.words() - 1;
+  uint64_t result = 0;
+
+  for (int r = 0; r < board.rows(); r++)
+  {
+    const uint64_t *words = board.row(r);
+    const uint64_t seed = hashRowSeed(first + r);
+
+    for (std::size_t w = 0; w < last; w++)
+      result ^= hashWordKey(seed, (long long)w, words[w]);
+    result ^= hashWordKey(seed, (long long)last, words[last] & board.lastWordMask());
+  }
+  return result;
+}
+
+/** returns the worker's exit status **/
+int SlabWorker::run()
+{
+  const std::size_t rowBytes = grids[0].words() * sizeof(uint64_t);
+  long long memory = (long long)(grids[0].bufferBytes() + grids[1].bufferBytes());
+
+  if (!sendAll(socket, &memory, sizeof(memory)))
+    return 1;
+
+  for (;;)
+  {
+    SlabMessage message;
+    if (!receiveAll(socket, &message, sizeof(message)))
+      return 1;
+
+    BitGrid &board = grids[current];
+    long long answer = 0;
+    switch (message.command)
+    {
+      case SLAB_LOAD:
+        board.clear();
+        for (int r = 0; r < board.rows(); r++)
+        {
+          if (!receiveAll(socket, board.row(r), rowBytes))
+            return 1;
+          board.row(r)[board.words() - 1] &= board.lastWordMask();
+        }
+        break;
+      case SLAB_STORE:
+        for (int r = 0; r < board.rows(); r++)
+          if (!sendAll(socket, board.row(r), rowBytes))
+            return 1;
+        break;
+      case SLAB_STEP:
+        for (long long g = 0; g < message.argument; g++)
+          if (!stepOnce() || (g % PARENT_CHECK_STEPS == 0 && getppid() != frontEnd))
+            return 1;
+        break;
+      case SLAB_POPULATION:
+        answer = board.population();
+        break;
+      case SLAB_HASH:
+        answer = (long long)hash();
+        break;
+      case SLAB_QUIT:
+        return 0;
+      default:
+        return 1;
+    }
+
+    if (!sendAll(socket, &answer, sizeof(answer)))
+      return 1;
+  }
+}
+
+DistributedStepper::DistributedStepper(int rows, int columns, int processes, Topology topology,
+                                       const Rule &rule)
+  : rowCount(rows), columnCount(columns), mailboxes(MAP_FAILED), mailboxBytes(0), slabBytes(0),
+    broken(false)
+{
+  if (rows <= 0 || columns <= 0 || processes <= 0)
+    throw std::invalid_argument("DistributedStepper: rows, columns and processes must be positive");
+  if (processes > rows)
+    processes = rows;
+
+  slabStart.resize(processes + 1);
+  for (int i = 0; i <= processes; i++)
+    slabStart[i] = (int)((long long)rows * i / processes);
+
+  mailboxBytes = (LINE_WORDS + (std::size_t)processes * mailboxWords(columns)) * sizeof(uint64_t);
+  mailboxes = mmap(NULL, mailboxBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  if (mailboxes == MAP_FAILED)
+    throw std::runtime_error("DistributedStepper: cannot map the mailboxes");
+  new (mailboxes) std::atomic<int>(0);
+  for (int i = 0; i < processes; i++)
+    new (firstMailbox(mailboxes) + (std::size_t)i * mailboxWords(columns))
+      std::atomic<long long>(0);
+
+  const pid_t frontEnd = getpid();
+  workers.reserve(processes);
+  polls.resize(processes);
+  for (int i = 0; i < processes; i++)
+  {
+    /** the worker's slab, mapped here and only paged in by the worker that steps it **/
+    const std::size_t bytes = BitGrid::bufferBytesFor(slabStart[i + 1] - slabStart[i], columns);
+    void *slabs[2];
+    slabs[0] = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    slabs[1] = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (slabs[0] == MAP_FAILED || slabs[1] == MAP_FAILED)
+    {
+      for (int g = 0; g < 2; g++)
+        if (slabs[g] != MAP_FAILED)
+          munmap(slabs[g], bytes);
+      shutdown(true);
+      throw std::runtime_error("DistributedStepper: cannot map a worker's slab");
+    }
+
+    int pair[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, pair) != 0)
+    {
+      munmap(slabs[0], bytes);
+      munmap(slabs[1], bytes);
+      shutdown(true);
+      throw std::runtime_error("DistributedStepper: cannot make a socket for a worker");
+    }
+
+    pid_t pid = fork();
+    if (pid < 0)
+    {
+      munmap(slabs[0], bytes);
+      munmap(slabs[1], bytes);
+      close(pair[0]);
+      close(pair[1]);
+      shutdown(true);
+      throw std::runtime_error("DistributedStepper: cannot fork a worker");
+    }
+
+    if (pid == 0)
+    {
+      /** the worker keeps only its own end of its own socket **/
+      for (std::size_t w = 0; w < workers.size(); w++)
+        close(workers[w].socket);
+      close(pair[0]);
+
+      int status = 1;
+      try
+      {
+        int up = i > 0 ? i - 1 : (topology == TOPOLOGY_TORUS ? processes - 1 : -1);
+        int down = i + 1 < processes ? i + 1 : (topology == TOPOLOGY_TORUS ? 0 : -1);
+        SlabWorker worker(i, slabStart[i], slabStart[i + 1] - slabStart[i], columns, up, down,
+                          topology, rule, mailboxes, frontEnd, pair[1], slabs);
+        status = worker.run();
+      }
+      catch (...)
+      {
+      }
+      /** a worker that fails lets its neighbors stop waiting for it **/
+      if (status != 0)
+        abortFlag(mailboxes).store(1);
+      _exit(status);
+    }
+
+    munmap(slabs[0], bytes);
+    munmap(slabs[1], bytes);
+    close(pair[1]);
+    Worker worker = { pid, pair[0] };
+    workers.push_back(worker);
+    polls[i].fd = pair[0];
+    polls[i].events = POLLIN;
+  }
+
+  try
+  {
+    for (int i = 0; i < processes; i++)
+      slabBytes += (std::size_t)reply(i);
+  }
+  catch (...)
+  {
+    shutdown(true);
+    throw;
+  }
+}
+
+DistributedStepper::~DistributedStepper()
+{
+  shutdown(broken);
+}
+
+/** asks every worker to quit (or, with force, kills it) and waits for it **/
+void DistributedStepper::shutdown(bool force)
+{
+  for (std::size_t i = 0; i < workers.size(); i++)
+  {
+    if (force)
+      kill(workers[i].pid, SIGKILL);
+    else
+    {
+      SlabMessage message = { SLAB_QUIT, 0 };
+      sendAll(workers[i].socket, &message, sizeof(message));
+    }
+    close(workers[i].socket);
+  }
+  for (std::size_t i = 0; i < workers.size(); i++)
+    waitpid(workers[i].pid, NULL, 0);
+  workers.clear();
+
+  if (mailboxes != MAP_FAILED)
+    munmap(mailboxes, mailboxBytes);
+  mailboxes = MAP_FAILED;
+}
+
+/*********************************************************************
+ ** Function: DistributedStepper::fail
+ ** Description: a worker has stopped: the others are told to stop waiting
+ for their neighbors and killed, and every later call throws as well
+ *********************************************************************/
+void DistributedStepper::fail(int worker) const
+{
+  if (!broken)
+  {
+    broken = true;
+    abortFlag(mailboxes).store(1);
+    for (std::size_t i = 0; i < workers.size(); i++)
+      kill(workers[i].pid, SIGKILL);
+  }
+  throw std::runtime_error("DistributedStepper: worker " + std::to_string(worker)
+                           + " has stopped");
+}
+
+void DistributedStepper::send(int worker, int command, long long argument) const
+{
+  SlabMessage message = { command, argument };
+
+  if (broken || !sendAll(workers[worker].socket, &message, sizeof(message)))
+    fail(worker);
+}
+
+/*********************************************************************
+ ** Function: DistributedStepper::reply
+ ** Description: waits for worker's answer while watching every worker's
+ socket: a worker that dies while the others are stepping hangs up its
+ socket, and its neighbors would otherwise keep the one waited on from ever
+ answering
+ *********************************************************************/
+long long DistributedStepper::reply(int worker) const
+{
+  long long answer;
+
+  for (;;)
+  {
+    for (std::size_t i = 0; i < polls.size(); i++)
+      polls[i].revents = 0;
+    if (poll(polls.data(), polls.size(), -1) < 0)
+    {
+      if (errno == EINTR)
+        continue;
+      fail(worker);
+    }
+
+    for (std::size_t i = 0; i < polls.size(); i++)
+      if (polls[i].revents & (POLLHUP | POLLERR | POLLNVAL))
+        fail((int)i);
+    if (polls[worker].revents & POLLIN)
+      break;
+  }
+
+  if (!receiveAll(workers[worker].socket, &answer, sizeof(answer)))
+    fail(worker);
+  return answer;
+}
+
+void DistributedStepper::load(const BitGrid &board)
+{
+  if (board.rows() != rowCount || board.columns() != columnCount)
+    throw std::invalid_argument("DistributedStepper::load: board dimensions differ");
+
+  const std::size_t rowBytes = board.words() * sizeof(uint64_t);
+  for (int i = 0; i < processes(); i++)
+  {
+    send(i, SLAB_LOAD, 0);
+    for (int r = slabStart[i]; r < slabStart[i + 1]; r++)
+      if (!sendAll(workers[i].socket, board.row(r), rowBytes))
+        fail(i);
+  }
+  for (int i = 0; i < processes(); i++)
+    reply(i);
+}
+
+/** one worker at a time, so a worker's rows never wait behind another's in its socket **/
+void DistributedStepper::store(BitGrid &board) const
+{
+  if (board.rows() != rowCount || board.columns() != columnCount)
+    board = BitGrid(rowCount, columnCount);
+  else
+    board.clear();
+
+  const std::size_t rowBytes = board.words() * sizeof(uint64_t);
+  for (int i = 0; i < processes(); i++)
+  {
+    send(i, SLAB_STORE, 0);
+    for (int r = slabStart[i]; r < slabStart[i + 1]; r++)
+      if (!receiveAll(workers[i].socket, board.row(r), rowBytes))
+        fail(i);
+    reply(i);
+  }
+}
+
+void DistributedStepper::step(long long generations)
+{
+  if (generations <= 0)
+    return;
+
+  for (int i = 0; i < processes(); i++)
+    send(i, SLAB_STEP, generations);
+  for (int i = 0; i < processes(); i++)
+    reply(i);
+}
+
+long long DistributedStepper::population() const
+{
+  long long total = 0;
+
+  for (int i = 0; i < processes(); i++)
+    send(i, SLAB_POPULATION, 0);
+  for (int i = 0; i < processes(); i++)
+    total += reply(i);
+  return total;
+}
+
+uint64_t DistributedStepper::hash() const
+{
+  uint64_t total = 0;
+
+  for (int i = 0; i < processes(); i++)
+    send(i, SLAB_HASH, 0);
+  for (int i = 0; i < processes(); i++)
+    total ^= (uint64_t)reply(i);
+  return total;
+}
+
+DistributedEngine::DistributedEngine(int rows, int columns, int processes, Topology topology,
+                                     const Rule &rule)
+  : Engine(rows, columns, rule), stepper(rows, columns, processes, topology, rule)
+{
+}
+
+void DistributedEngine::loadBits(const BitGrid &board)
+{
+  stepper.load(board);
+  generationCount = 0;
+}
+
+void DistributedEngine::storeBits(BitGrid &board) const
+{
+  stepper.store(board);
+}
+
+void DistributedEngine::step(long long generations)
+{
+  stepper.step(generations);
+  generationCount += generations > 0 ? generations : 0;
+}
+
+long long DistributedEngine::population() const
+{
+  return stepper.population();
+}
+
+std::size_t DistributedEngine::memoryBytes() const
+{
+  return stepper.memoryBytes();
+}
+
+uint64_t DistributedEngine::hash()
+{
+  return stepper.hash();
+}
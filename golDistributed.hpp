@@ -0,0 +1,117 @@
+/************************************************************************************************
+ ** Program       Filename: GameOfLife
+ ** Current       File: golDistributed.hpp
+ ** Author:       Jordan Grant
+ ** Date:         10.17.26
+ ** Description: 	Multi-process stepping of a bit packed board. The board is split into
+ slabs of whole rows and each slab is owned by a worker process forked for it, so
+ no process ever holds more than its own slab while stepping. Neighboring slabs trade
+ their edge rows every generation through mailboxes in a shared mapping. A worker
+ posts its edge rows, steps its interior rows (which need nothing from anyone) while
+ its neighbors do the same, and only then waits for their rows to step its own two
+ edge rows. Workers wait on their neighbors only, never on a global barrier, and the
+ front end talks to each worker over a Unix socket: commands, and the rows of the
+ board when it is loaded or stored.
+ **************************************************************************************************/
+
+
+#ifndef GOLDISTRIBUTED_HPP
+#define GOLDISTRIBUTED_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <poll.h>
+#include <sys/types.h>
+#include "golEngine.hpp"
+
+/*********************************************************************
+ ** Class: DistributedStepper
+ ** Description: forks processes() workers that own the slabs of a rows x
+ columns board and steps them in lock step with their neighbors. On a torus
+ the first and last slabs are neighbors too.
+ ** Pre-Conditions: rows, columns and processes must be positive; there are at
+ most rows processes, one row each. The stepper must be destroyed in the
+ process that made it. It may be made while other threads run: the workers
+ only use memory mapped before they were forked. Throws std::runtime_error if
+ a worker cannot be started or stops answering, even mid step; the other
+ workers are then killed, and every later call throws too.
+ *********************************************************************/
+class DistributedStepper
+{
+public:
+  DistributedStepper(int rows, int columns, int processes,
+                     Topology topology = TOPOLOGY_BOUNDED, const Rule &rule = Rule());
+  ~DistributedStepper();
+
+  int processes() const { return (int)workers.size(); }
+  /** the process id of worker i **/
+  pid_t workerProcess(int i) const { return workers[i].pid; }
+
+  void load(const BitGrid &board);
+  void store(BitGrid &board) const;
+  void step(long long generations);
+  long long population() const;
+  /** hashBitGrid() of the board, each slab hashed by its own worker **/
+  uint64_t hash() const;
+  /** the slabs of every worker plus the mailboxes **/
+  std::size_t memoryBytes() const { return slabBytes + mailboxBytes; }
+
+private:
+  DistributedStepper(const DistributedStepper &);
+  DistributedStepper &operator=(const DistributedStepper &);
+
+  struct Worker
+  {
+    pid_t pid;
+    int socket;
+  };
+
+  void fail(int worker) const;
+  void send(int worker, int command, long long argument) const;
+  long long reply(int worker) const;
+  void shutdown(bool force);
+
+  int rowCount;
+  int columnCount;
+  std::vector<int> slabStart;
+  std::vector<Worker> workers;
+  /** every worker's socket, for reply() to poll **/
+  mutable std::vector<pollfd> polls;
+  void *mailboxes;                         // the control line, then a mailbox per worker
+  std::size_t mailboxBytes;
+  std::size_t slabBytes;
+  /** set when a worker failed mid command; the rest are then killed, not asked to quit **/
+  mutable bool broken;
+};
+
+/*********************************************************************
+ ** Class: DistributedEngine
+ ** Description: Engine front end for a DistributedStepper; threads is the
+ number of worker processes
+ *********************************************************************/
+class DistributedEngine : public Engine
+{
+public:
+  DistributedEngine(int rows, int columns, int processes, Topology topology = TOPOLOGY_BOUNDED,
+                    const Rule &rule = Rule());
+
+  const char *name() const { return "distributed"; }
+  void loadBits(const BitGrid &board);
+  void storeBits(BitGrid &board) const;
+  void step(long long generations);
+  long long population() const;
+  std::size_t memoryBytes() const;
+  uint64_t hash();
+  /** a hash is a round trip to every worker; asking every generation would
+   ** stop the slabs running ahead of each other **/
+  bool tracksHash() const { return false; }
+
+  int processes() const { return stepper.processes(); }
+  pid_t workerProcess(int i) const { return stepper.workerProcess(i); }
+
+private:
+  DistributedStepper stepper;
+};
+
+#endif
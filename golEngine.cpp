@@ -0,0 +1,459 @@
+/**************************************************************************************************
+ ** Program       Filename: GameOfLife
+ ** Current       File: golEngine.cpp
+ ** Author:       Jordan Grant
+ ** Date:         10.17.26
+ ** Description: 	Engine implementations, the engine factory and the Simulation driver
+ (see golEngine.hpp).
+ *****************************************************************************************************/
+
+#include "golEngine.hpp"
+#include "golTiles.hpp"
+#include "golHashLife.hpp"
+#include "golSparse.hpp"
+#include "golGenerations.hpp"
+#include "golCycle.hpp"
+#include "golDistributed.hpp"
+#include "golTemporal.hpp"
+#include "golStats.hpp"
+
+#include <stdexcept>
+
+Engine::Engine(int rows, int columns, const Rule &rule)
+  : rowCount(rows), columnCount(columns), generationCount(0), lifeRule(rule), hashing(false),
+    boardHash(0)
+{
+}
+
+Engine::~Engine()
+{
+}
+
+void Engine::adoptBits(BitGrid &board)
+{
+  loadBits(board);
+}
+
+uint64_t Engine::hash()
+{
+  BitGrid board(rowCount, columnCount);
+
+  storeBits(board);
+  return hashBitGrid(board);
+}
+
+void Engine::load(const Grid &board)
+{
+  BitGrid bits(board.rows(), board.columns());
+
+  packGrid(board, bits);
+  loadBits(bits);
+}
+
+void Engine::store(Grid &board) const
+{
+  BitGrid bits(rowCount, columnCount);
+
+  storeBits(bits);
+  if (board.rows() != rowCount || board.columns() != columnCount)
+    board = Grid(rowCount, columnCount);
+  unpackGrid(bits, board);
+}
+
+CharEngine::CharEngine(int rows, int columns, Topology topology, const Rule &rule)
+  : Engine(rows, columns, rule), current(0), topology(topology)
+{
+  grids[0] = Grid(rows, columns);
+  grids[1] = Grid(rows, columns);
+}
+
+void CharEngine::loadBits(const BitGrid &board)
+{
+  unpackGrid(board, grids[current]);
+  generationCount = 0;
+}
+
+void CharEngine::storeBits(BitGrid &board) const
+{
+  if (board.rows() != rowCount || board.columns() != columnCount)
+    board = BitGrid(rowCount, columnCount);
+  packGrid(grids[current], board);
+}
+
+void CharEngine::load(const Grid &board)
+{
+  if (board.rows() != rowCount || board.columns() != columnCount)
+    throw std::invalid_argument("CharEngine::load: board dimensions differ");
+
+  grids[current] = board;
+  generationCount = 0;
+}
+
+void CharEngine::store(Grid &board) const
+{
+  board = grids[current];
+}
+
+/** computed in full each time; the dying states of a Generations rule are hashed too **/
+uint64_t CharEngine::hash()
+{
+  return hashGrid(grids[current], lifeRule.stateBits());
+}
+
+void CharEngine::step(long long generations)
+{
+  for (long long g = 0; g < generations; g++)
+  {
+    if (topology == TOPOLOGY_TORUS)
+      wrapGrid(grids[current]);
+    stepGrid(grids[current], grids[current ^ 1], lifeRule);
+    current ^= 1;
+  }
+  generationCount += generations > 0 ? generations : 0;
+}
+
+long long CharEngine::population() const
+{
+  return grids[current].population();
+}
+
+std::size_t CharEngine::memoryBytes() const
+{
+  return grids[0].bufferBytes() + grids[1].bufferBytes();
+}
+
+BitEngine::BitEngine(int rows, int columns, Topology topology, const Rule &rule)
+  : Engine(rows, columns, rule), current(0), topology(topology)
+{
+  grids[0] = BitGrid(rows, columns);
+  grids[1] = BitGrid(rows, columns);
+}
+
+void BitEngine::loadBits(const BitGrid &board)
+{
+  if (board.rows() != rowCount || board.columns() != columnCount)
+    throw std::invalid_argument("BitEngine::loadBits: board dimensions differ");
+
+  grids[current] = board;
+  grids[current].clearHalo();
+  generationCount = 0;
+  hashing = false;
+}
+
+/*********************************************************************
+ ** Function: BitEngine::adoptBits
+ ** Description: takes board's buffer as the current generation. The halo is
+ trusted to be dead (storeBits() output always is, and loadCheckpoint()
+ refuses a file where it is not) and is not cleared, so a mapped checkpoint
+ is never copied.
+ *********************************************************************/
+void BitEngine::adoptBits(BitGrid &board)
+{
+  if (board.rows() != rowCount || board.columns() != columnCount)
+    throw std::invalid_argument("BitEngine::adoptBits: board dimensions differ");
+
+  grids[current].swap(board);
+  generationCount = 0;
+  hashing = false;
+}
+
+void BitEngine::storeBits(BitGrid &board) const
+{
+  board = grids[current];
+  board.clearHalo();
+}
+
+void BitEngine::step(long long generations)
+{
+  for (long long g = 0; g < generations; g++)
+  {
+    if (topology == TOPOLOGY_TORUS)
+      wrapBitGrid(grids[current]);
+    stepBitRows(grids[current], grids[current ^ 1], 0, rowCount, lifeRule,
+                hashing ? &boardHash : NULL);
+    current ^= 1;
+  }
+  generationCount += generations > 0 ? generations : 0;
+}
+
+long long BitEngine::population() const
+{
+  return grids[current].population();
+}
+
+std::size_t BitEngine::memoryBytes() const
+{
+  return grids[0].bufferBytes() + grids[1].bufferBytes();
+}
+
+uint64_t BitEngine::hash()
+{
+  if (!hashing)
+  {
+    boardHash = hashBitGrid(grids[current]);
+    hashing = true;
+  }
+  return boardHash;
+}
+
+ParallelEngine::ParallelEngine(int rows, int columns, int threads, Topology topology,
+                               const Rule &rule)
+  : Engine(rows, columns, rule), stepper(rows, columns, threads, true, topology, rule)
+{
+}
+
+void ParallelEngine::loadBits(const BitGrid &board)
+{
+  stepper.load(board);
+  generationCount = 0;
+  hashing = false;
+}
+
+void ParallelEngine::storeBits(BitGrid &board) const
+{
+  stepper.store(board);
+}
+
+void ParallelEngine::step(long long generations)
+{
+  stepper.step(generations, hashing ? &boardHash : NULL);
+  generationCount += generations > 0 ? generations : 0;
+}
+
+long long ParallelEngine::population() const
+{
+  return stepper.board().population();
+}
+
+std::size_t ParallelEngine::memoryBytes() const
+{
+  return stepper.memoryBytes();
+}
+
+uint64_t ParallelEngine::hash()
+{
+  if (!hashing)
+  {
+    boardHash = hashBitGrid(stepper.board());
+    hashing = true;
+  }
+  return boardHash;
+}
+
+Topology parseTopology(const std::string &name)
+{
+  if (name == "bounded")
+    return TOPOLOGY_BOUNDED;
+  if (name == "torus")
+    return TOPOLOGY_TORUS;
+  throw std::invalid_argument("unknown topology: " + name);
+}
+
+const char *topologyName(Topology topology)
+{
+  return topology == TOPOLOGY_TORUS ? "torus" : "bounded";
+}
+
+std::unique_ptr<Engine> makeEngine(const std::string &name, int rows, int columns, int threads,
+                                   Topology topology, const Rule &rule, int depth)
+{
+  if (threads <= 0)
+    threads = hardwareThreads();
+
+  if (name == "char")
+    return std::unique_ptr<Engine>(new CharEngine(rows, columns, topology, rule));
+  if (name == "generations")
+    return std::unique_ptr<Engine>(new GenerationsEngine(rows, columns, topology, rule));
+  if (rule.states() > 2)
+    throw std::invalid_argument(name + " engine does not run Generations rules such as "
+                                + rule.notation() + "; use the generations or char engine");
+  if (name == "bit")
+    return std::unique_ptr<Engine>(new BitEngine(rows, columns, topology, rule));
+  if (name == "parallel")
+    return std::unique_ptr<Engine>(new ParallelEngine(rows, columns, threads, topology, rule));
+  if (name == "distributed")
+    return std::unique_ptr<Engine>(new DistributedEngine(rows, columns, threads, topology, rule));
+  if (name == "blocked")
+    return std::unique_ptr<Engine>(new BlockedEngine(rows, columns, depth, topology, rule));
+
+  if (topology != TOPOLOGY_BOUNDED)
+    throw std::invalid_argument(name + " engine does not support the " + topologyName(topology)
+                                + " topology");
+  if (name == "tiled")
+    return std::unique_ptr<Engine>(new TiledEngine(rows, columns, rule));
+  if (name == "hashlife")
+    return std::unique_ptr<Engine>(new HashLifeEngine(rows, columns, rule));
+  if (name == "sparse")
+    return std::unique_ptr<Engine>(new SparseEngine(rows, columns, rule));
+
+  throw std::invalid_argument("unknown engine: " + name);
+}
+
+GenerationObserver::~GenerationObserver()
+{
+}
+
+Simulation::Simulation(Engine &engine)
+  : engine(engine), stopping(false), found(NULL), cycleAction(CYCLE_SKIP), chunk(1),
+    steppedCount(0)
+{
+}
+
+/*********************************************************************
+ ** Function: Simulation::detectCycles
+ ** Description: periods of up to history generations are found. A chunk hash
+ only comes back once a whole number of periods fits in whole chunks, up to
+ period chunks later, so the chunk history is as long as the generation
+ history; the replay sees at most two chunks and a period.
+ *********************************************************************/
+void Simulation::detectCycles(std::size_t history, CycleAction action)
+{
+  const long long grain = engine.stepGrain() > 0 ? engine.stepGrain() : 1;
+
+  chunk = engine.unbounded() ? 1 : (CYCLE_CHUNK + grain - 1) / grain * grain;
+  cycleAction = action;
+  detector.reset(history > 0 ? new CycleDetector(history) : NULL);
+  replay.reset(history > 0 && chunk > 1 ? new CycleDetector(history + 2 * (std::size_t)chunk)
+                                        : NULL);
+  found = detector.get();
+}
+
+void Simulation::addObserver(GenerationObserver *observer, long long every)
+{
+  Entry entry = { observer, every > 0 ? every : 1 };
+  observers.push_back(entry);
+}
+
+/** true once the board repeats, unless the run ends on that generation anyway **/
+bool Simulation::cycleFound(long long end)
+{
+  return detector->record(engine.generation(), engine.hash()) && engine.generation() < end;
+}
+
+/** every step of a run goes through here, so a GOL_STATS build can time it **/
+void Simulation::advance(long long generations)
+{
+  {
+    GOL_STAT_SCOPE("step", generations);
+    engine.step(generations);
+  }
+  GOL_STAT_ENGINE(engine);
+}
+
+void Simulation::notify()
+{
+  for (std::size_t i = 0; i < observers.size(); i++)
+    if (engine.generation() % observers[i].every == 0)
+      observers[i].observer->observe(engine);
+}
+
+/*********************************************************************
+ ** Function: Simulation::replayCycle
+ ** Description: the chunk hashes put the cycle's start after the chunk before
+ the repeated one (a board there that repeated would have been seen a chunk
+ earlier), so the run is replayed from the board it began with: one step to
+ that chunk, then a generation at a time until a hash comes back, which gives
+ the exact start and period. The engine is then moved on to the board of the
+ generation the repeat was seen at.
+ ** Post-Conditions: returns the generations the replay stepped
+ *********************************************************************/
+long long Simulation::replayCycle(long long start)
+{
+  const long long seen = engine.generation();
+  const long long from = detector->start() - chunk > start ? detector->start() - chunk : start;
+
+  if (engine.rule().states() > 2)
+    engine.load(startCells);
+  else
+    engine.loadBits(startBits);
+  engine.setGeneration(start);
+  advance(from - start);
+
+  replay->reset();
+  replay->record(from, engine.hash());
+  do
+    advance(1);
+  while (!replay->record(engine.generation(), engine.hash()));
+  found = replay.get();
+
+  const long long ahead = (seen - engine.generation()) % replay->period();
+  advance(ahead);
+  const long long replayed = engine.generation() - start;
+  engine.setGeneration(seen);
+  return replayed;
+}
+
+/*********************************************************************
+ ** Function: Simulation::run
+ ** Description: steps straight to the next generation any observer wants to
+ see (or the next chunk to hash), so observers only cost anything on the
+ generations they watch
+ *********************************************************************/
+void Simulation::run(long long generations)
+{
+  const long long start = engine.generation();
+  const long long end = start + generations;
+
+  stopping = false;
+  found = detector.get();
+  const bool detecting = detector && engine.tracksHash();
+  if (detector)
+    detector->reset();
+  if (detecting)
+  {
+    if (chunk > 1 && engine.rule().states() > 2)
+      engine.store(startCells);
+    else if (chunk > 1)
+      engine.storeBits(startBits);
+    detector->record(start, engine.hash());
+  }
+  else if (observers.empty())
+  {
+    advance(generations);
+    steppedCount = engine.generation() - start;
+    return;
+  }
+
+  notify();
+  while (engine.generation() < end && !stopping)
+  {
+    long long next = detecting ? ((engine.generation() - start) / chunk + 1) * chunk + start : end;
+    if (next > end)
+      next = end;
+    for (std::size_t i = 0; i < observers.size(); i++)
+    {
+      long long every = observers[i].every;
+      long long due = (engine.generation() / every + 1) * every;
+      if (due < next)
+        next = due;
+    }
+
+    advance(next - engine.generation());
+    if (detecting && (engine.generation() - start) % chunk == 0 && cycleFound(end))
+    {
+      steppedCount = engine.generation() - start;
+      if (chunk > 1)
+        steppedCount += replayCycle(start);
+      if (cycleAction == CYCLE_SKIP)
+      {
+        long long remaining = (end - engine.generation()) % found->period();
+        advance(remaining);
+        steppedCount += remaining;
+        engine.setGeneration(end);
+      }
+      for (std::size_t i = 0; i < observers.size(); i++)
+        observers[i].observer->observe(engine);
+      return;
+    }
+
+    if (engine.generation() == end)
+    {
+      /** the final generation is always shown, even off the interval **/
+      for (std::size_t i = 0; i < observers.size(); i++)
+        observers[i].observer->observe(engine);
+    }
+    else
+      notify();
+  }
+  steppedCount = engine.generation() - start;
+}
@@ -0,0 +1,279 @@
+/************************************************************************************************
+ ** Program       Filename: GameOfLife
+ ** Current       File: golEngine.hpp
+ ** Author:       Jordan Grant
+ ** Date:         10.17.26
+ ** Description: 	Common stepping interface for every way of running the Game of Life.
+ An Engine owns its generation buffers and advances them in place: the current and
+ next buffers swap roles after each generation, so nothing is copied per step, and
+ step(n) runs n generations back to back with no per-generation callbacks. Boards
+ move in and out of an engine as BitGrids (or Grids, converted on the way).
+ **************************************************************************************************/
+
+
+#ifndef GOLENGINE_HPP
+#define GOLENGINE_HPP
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "golGrid.hpp"
+#include "golBitGrid.hpp"
+#include "golParallel.hpp"
+#include "golCycle.hpp"
+
+/*********************************************************************
+ ** Class: Engine
+ ** Description: abstract Game of Life engine for a rows x columns board that
+ runs one rule (Conway's B3/S23 unless another is given)
+ ** Pre-Conditions: loadBits() must be given a board of the engine's size
+ ** Post-Conditions: generation() counts the generations stepped since the
+ last load
+ *********************************************************************/
+class Engine
+{
+public:
+  Engine(int rows, int columns, const Rule &rule = Rule());
+  virtual ~Engine();
+
+  virtual const char *name() const = 0;
+  virtual void loadBits(const BitGrid &board) = 0;
+  virtual void storeBits(BitGrid &board) const = 0;
+  virtual void step(long long generations) = 0;
+  virtual long long population() const = 0;
+  /** bytes the engine holds for the board, including halos and bookkeeping **/
+  virtual std::size_t memoryBytes() const = 0;
+
+  /**
+   ** hash of the whole board (golCycle.hpp), or the whole universe for the
+   ** unbounded engines; equal boards hash equal. The first call computes it,
+   ** and engines that can then keep it up to date from the words they change
+   ** while stepping, so runs that never ask pay nothing
+   **/
+  virtual uint64_t hash();
+  /** false if hash() is too slow to ask every generation; Simulation then skips cycle detection **/
+  virtual bool tracksHash() const { return true; }
+  /** step(n) runs fastest when n is a multiple of this, e.g. the blocked engine's pass depth **/
+  virtual int stepGrain() const { return 1; }
+  /**
+   ** true for engines with no edge, whose universe runs past the board that
+   ** storeBits() shows, so the board cannot be put back with loadBits()
+   **/
+  virtual bool unbounded() const { return false; }
+
+  /**
+   ** like loadBits() but the engine may take board's buffer instead of copying
+   ** it (board is then left with the engine's old buffer, or unchanged); used to
+   ** restore mapped checkpoints
+   **/
+  virtual void adoptBits(BitGrid &board);
+
+  int rows() const { return rowCount; }
+  int columns() const { return columnCount; }
+  long long generation() const { return generationCount; }
+  const Rule &rule() const { return lifeRule; }
+  /** renumbers the current generation, e.g. after restoring a checkpoint **/
+  void setGeneration(long long generation) { generationCount = generation; }
+
+  /**
+   ** a byte per cell board in and out; through loadBits()/storeBits() unless the
+   ** engine keeps the dying states of a Generations rule, which travel as the
+   ** cell values
+   **/
+  virtual void load(const Grid &board);
+  virtual void store(Grid &board) const;
+
+protected:
+  int rowCount;
+  int columnCount;
+  long long generationCount;
+  Rule lifeRule;
+  /** set once hash() has been called; engines that track the hash keep boardHash
+   ** current while it is set and clear it when a board is loaded **/
+  bool hashing;
+  uint64_t boardHash;
+};
+
+/*********************************************************************
+ ** Class: CharEngine
+ ** Description: one byte per cell, stepGrid(); runs Generations rules too
+ *********************************************************************/
+class CharEngine : public Engine
+{
+public:
+  CharEngine(int rows, int columns, Topology topology = TOPOLOGY_BOUNDED,
+             const Rule &rule = Rule());
+
+  const char *name() const { return "char"; }
+  void loadBits(const BitGrid &board);
+  void storeBits(BitGrid &board) const;
+  void load(const Grid &board);
+  void store(Grid &board) const;
+  void step(long long generations);
+  long long population() const;
+  std::size_t memoryBytes() const;
+  uint64_t hash();
+
+private:
+  Grid grids[2];
+  int current;
+  Topology topology;
+};
+
+/*********************************************************************
+ ** Class: BitEngine
+ ** Description: 64 cells per word, single threaded stepBitGrid()
+ *********************************************************************/
+class BitEngine : public Engine
+{
+public:
+  BitEngine(int rows, int columns, Topology topology = TOPOLOGY_BOUNDED,
+            const Rule &rule = Rule());
+
+  const char *name() const { return "bit"; }
+  void loadBits(const BitGrid &board);
+  void storeBits(BitGrid &board) const;
+  void adoptBits(BitGrid &board);
+  void step(long long generations);
+  long long population() const;
+  std::size_t memoryBytes() const;
+  uint64_t hash();
+
+private:
+  BitGrid grids[2];
+  int current;
+  Topology topology;
+};
+
+/*********************************************************************
+ ** Class: ParallelEngine
+ ** Description: 64 cells per word, row bands stepped by a ParallelStepper
+ *********************************************************************/
+class ParallelEngine : public Engine
+{
+public:
+  ParallelEngine(int rows, int columns, int threads, Topology topology = TOPOLOGY_BOUNDED,
+                 const Rule &rule = Rule());
+
+  const char *name() const { return "parallel"; }
+  void loadBits(const BitGrid &board);
+  void storeBits(BitGrid &board) const;
+  void step(long long generations);
+  long long population() const;
+  std::size_t memoryBytes() const;
+  uint64_t hash();
+
+private:
+  ParallelStepper stepper;
+};
+
+/*********************************************************************
+ ** Function: Make Engine
+ ** Description: builds an engine by name: "char", "bit", "parallel",
+ "distributed", "blocked", "tiled", "hashlife", "sparse" or "generations". The
+ grid engines (char, bit, parallel, distributed, blocked, generations) have an
+ edge: bounded (dead outside) or a torus. hashlife and sparse are unbounded, and tiled is
+ bounded only. Every engine runs any Life-like rule; Generations rules (more
+ than 2 states) run on char and generations only.
+ ** Parameters: engine name, board size, worker threads (worker processes for
+ distributed; 0 = one per cpu; ignored by single threaded engines), topology
+ of the board edge, rule, generations per pass of the blocked engine (0 =
+ fit its ring in the cache)
+ ** Post-Conditions: returns the engine, or throws std::invalid_argument for an
+ unknown name or a topology or rule the engine does not support
+ *********************************************************************/
+std::unique_ptr<Engine> makeEngine(const std::string &name, int rows, int columns, int threads,
+                                   Topology topology = TOPOLOGY_BOUNDED,
+                                   const Rule &rule = Rule(), int depth = 0);
+
+/*********************************************************************
+ ** Function: Topology names
+ ** Description: "bounded" / "torus" to and from Topology; parseTopology()
+ throws std::invalid_argument for anything else
+ *********************************************************************/
+Topology parseTopology(const std::string &name);
+const char *topologyName(Topology topology);
+
+/*********************************************************************
+ ** Class: GenerationObserver
+ ** Description: something that wants to see the board as a Simulation runs,
+ e.g. the terminal display
+ *********************************************************************/
+class GenerationObserver
+{
+public:
+  virtual ~GenerationObserver();
+  virtual void observe(const Engine &engine) = 0;
+};
+
+/*********************************************************************
+ ** Class: Simulation
+ ** Description: drives an Engine and calls each observer on every generation
+ that is a multiple of its interval, including the first and last
+ generation of a run. Between observations the engine is stepped with one
+ step(n) call; with no observers a run is a single step(n). With cycle
+ detection on, the hash is recorded every CYCLE_CHUNK generations (rounded up
+ to a multiple of the engine's stepGrain()), so detection does not break the
+ engine's big steps up. Once a recorded board repeats, the board the run began
+ with is loaded again and the run replayed, in one step up to the chunk before
+ the repeated one and then a generation at a time, to find the exact start and
+ period. The run then either stops at the generation the repeat was seen or
+ skips to its last generation, which lands on the same board as stepping
+ would: only the remaining generations modulo the period are stepped. Engines
+ that are unbounded() record every generation and need no replay.
+ *********************************************************************/
+/** generations between the hashes cycle detection records **/
+#define CYCLE_CHUNK 64
+
+enum CycleAction {
+  CYCLE_STOP,    // end the run at the generation the repeat is seen
+  CYCLE_SKIP     // finish the run analytically
+};
+
+class Simulation
+{
+public:
+  explicit Simulation(Engine &engine);
+
+  void addObserver(GenerationObserver *observer, long long every = 1);
+  /** history generations of hashes are kept; 0 turns detection off **/
+  void detectCycles(std::size_t history, CycleAction action = CYCLE_SKIP);
+  void run(long long generations);
+  /** makes a run in progress return after the current step, e.g. from an observer **/
+  void stop() { stopping = true; }
+
+  /** the last run's cycle (exact, after any replay), NULL when detection is off **/
+  const CycleDetector *cycles() const { return found; }
+  /**
+   ** generations the last run actually stepped: fewer than asked after a skip
+   ** or a stop(), and including any replay
+   **/
+  long long stepped() const { return steppedCount; }
+
+private:
+  struct Entry
+  {
+    GenerationObserver *observer;
+    long long every;
+  };
+
+  void advance(long long generations);
+  void notify();
+  bool cycleFound(long long end);
+  long long replayCycle(long long start);
+
+  Engine &engine;
+  std::vector<Entry> observers;
+  bool stopping;
+  std::unique_ptr<CycleDetector> detector;   // one hash per chunk
+  std::unique_ptr<CycleDetector> replay;     // one hash per generation, for the replay
+  const CycleDetector *found;
+  CycleAction cycleAction;
+  long long chunk;
+  long long steppedCount;
+  /** the board the run began with, bits or (Generations rules) states **/
+  BitGrid startBits;
+  Grid startCells;
+};
+
+#endif
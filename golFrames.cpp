@@ -0,0 +1,744 @@
+/**************************************************************************************************
+ ** Program       Filename: GameOfLife
+ ** Current       File: golFrames.cpp
+ ** Author:       Jordan Grant
+ ** Date:         10.17.26
+ ** Description: 	Frame export (see golFrames.hpp).
+ *****************************************************************************************************/
+
+#include "golFrames.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdexcept>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/** longest the encoder sleeps on an empty ring if a wakeup slips past it **/
+#define FRAME_NAP_MS 10
+/** widest spacing the exporter backs off to, in observed generations **/
+#define MAX_FRAME_SPACING (1LL << 20)
+#define MAX_FRAME_PIXELS (1LL << 30)
+#define MAX_PIXELS_PER_CELL 64
+
+/** deflate: LZ77 window, match lengths and hash table size **/
+#define DEFLATE_WINDOW 32768
+#define MIN_MATCH 3
+#define MAX_MATCH 258
+#define MATCH_HASH_BITS 15
+
+FrameView fullView()
+{
+  FrameView view = { 0, 0, 0, 0, 1, 1 };
+  return view;
+}
+
+static long long parseFrameNumber(const std::string &flag, const std::string &text,
+                                  long long low, long long high)
+{
+  char *end = NULL;
+  errno = 0;
+  long long value = std::strtoll(text.c_str(), &end, 10);
+
+  if (text.empty() || *end != '\0' || errno != 0 || value < low || value > high)
+    throw std::invalid_argument(flag + ": expected a whole number from " + std::to_string(low)
+                                + " to " + std::to_string(high) + ", got '" + text + "'");
+  return value;
+}
+
+void parseCrop(const std::string &flag, const std::string &text, FrameView &view)
+{
+  std::size_t x = text.find('x'),
+              plus = text.find('+', x == std::string::npos ? 0 : x);
+  if (x == std::string::npos)
+    throw std::invalid_argument(flag + ": expected ROWSxCOLUMNS+TOP+LEFT, got '" + text + "'");
+
+  std::string rows = text.substr(0, x),
+              columns = text.substr(x + 1, plus == std::string::npos ? std::string::npos : plus - x - 1),
+              top = "0",
+              left = "0";
+  if (plus != std::string::npos)
+  {
+    std::size_t second = text.find('+', plus + 1);
+    if (second == std::string::npos)
+      throw std::invalid_argument(flag + ": expected ROWSxCOLUMNS+TOP+LEFT, got '" + text + "'");
+    top = text.substr(plus + 1, second - plus - 1);
+    left = text.substr(second + 1);
+  }
+
+  view.rows = (int)parseFrameNumber(flag, rows, -(1 << 30), 1 << 30);
+  view.columns = (int)parseFrameNumber(flag, columns, -(1 << 30), 1 << 30);
+  view.top = (int)parseFrameNumber(flag, top, 0, 1 << 30);
+  view.left = (int)parseFrameNumber(flag, left, 0, 1 << 30);
+}
+
+void parseFrameScale(const std::string &flag, const std::string &text, FrameView &view)
+{
+  if (text.compare(0, 2, "1/") == 0)
+  {
+    view.pixels = 1;
+    view.cells = (int)parseFrameNumber(flag, text.substr(2), 1, 1 << 20);
+  }
+  else
+  {
+    view.pixels = (int)parseFrameNumber(flag, text, 1, MAX_PIXELS_PER_CELL);
+    view.cells = 1;
+  }
+}
+
+FrameView resolveView(const FrameView &view, int boardRows, int boardColumns)
+{
+  FrameView resolved = view;
+
+  resolved.top = view.top < boardRows ? view.top : boardRows;
+  resolved.left = view.left < boardColumns ? view.left : boardColumns;
+  long long rows = view.rows > 0 ? view.rows : (long long)boardRows - resolved.top + view.rows,
+            columns = view.columns > 0 ? view.columns
+                                       : (long long)boardColumns - resolved.left + view.columns;
+
+  if (rows > boardRows - resolved.top)
+    rows = boardRows - resolved.top;
+  if (columns > boardColumns - resolved.left)
+    columns = boardColumns - resolved.left;
+  resolved.rows = rows > 0 ? (int)rows : 0;
+  resolved.columns = columns > 0 ? (int)columns : 0;
+  return resolved;
+}
+
+/*********************************************************************
+ ** Function: Render Frame
+ ** Description: each row of blocks is drawn into its first pixel row once,
+ then copied down for the rest of a magnified cell
+ *********************************************************************/
+void renderFrame(const BitGrid &board, const FrameView &view, std::vector<unsigned char> &pixels)
+{
+  const int width = frameWidth(view),
+            height = frameHeight(view);
+  const int blockRows = (view.rows + view.cells - 1) / view.cells,
+            blockColumns = (view.columns + view.cells - 1) / view.cells;
+
+  pixels.resize((std::size_t)width * height);
+  for (int b = 0; b < blockRows; b++)
+  {
+    unsigned char *line = &pixels[(std::size_t)b * view.pixels * width];
+    const int firstRow = view.top + b * view.cells,
+              lastRow = std::min(firstRow + view.cells, view.top + view.rows);
+
+    for (int k = 0; k < blockColumns; k++)
+    {
+      const int firstColumn = view.left + k * view.cells,
+                lastColumn = std::min(firstColumn + view.cells, view.left + view.columns);
+      unsigned char value;
+
+      if (view.cells == 1)
+        value = board.get(firstRow, firstColumn) ? 255 : 0;
+      else
+      {
+        long long live = 0,
+                  area = (long long)(lastRow - firstRow) * (lastColumn - firstColumn);
+        for (int r = firstRow; r < lastRow; r++)
+          live += countBitRange(board.row(r), firstColumn, lastColumn);
+        /** rounded up, so a block with any life in it is never black **/
+        value = (unsigned char)((live * 255 + area - 1) / area);
+      }
+      std::memset(line + (std::size_t)k * view.pixels, value, (std::size_t)view.pixels);
+    }
+    for (int p = 1; p < view.pixels; p++)
+      std::memcpy(line + (std::size_t)p * width, line, (std::size_t)width);
+  }
+}
+
+static void appendText(std::vector<unsigned char> &out, const char *text)
+{
+  out.insert(out.end(), text, text + std::strlen(text));
+}
+
+void encodePbm(const unsigned char *pixels, int width, int height, std::vector<unsigned char> &out)
+{
+  char header[64];
+  std::snprintf(header, sizeof(header), "P4\n%d %d\n", width, height);
+  appendText(out, header);
+
+  /** rows are padded to whole bytes, most significant bit first; 1 is black **/
+  for (int r = 0; r < height; r++)
+  {
+    const unsigned char *line = pixels + (std::size_t)r * width;
+    for (int c = 0; c < width; c += 8)
+    {
+      unsigned char bits = 0;
+      for (int i = 0; i < 8; i++)
+        if (c + i >= width || line[c + i] == 0)
+          bits |= (unsigned char)(0x80 >> i);
+      out.push_back(bits);
+    }
+  }
+}
+
+void encodePgm(const unsigned char *pixels, int width, int height, std::vector<unsigned char> &out)
+{
+  char header[64];
+  std::snprintf(header, sizeof(header), "P5\n%d %d\n255\n", width, height);
+  appendText(out, header);
+  out.insert(out.end(), pixels, pixels + (std::size_t)width * height);
+}
+
+/*********************************************************************
+ ** Class: DeflateWriter
+ ** Description: packs deflate's bit stream, least significant bit first,
+ and knows the fixed Huffman codes of RFC 1951 section 3.2.6
+ *********************************************************************/
+class DeflateWriter
+{
+public:
+  explicit DeflateWriter(std::vector<unsigned char> &out) : out(out), bits(0), count(0) {}
+
+  void put(uint32_t value, int length)
+  {
+    bits |= (uint64_t)value << count;
+    count += length;
+    while (count >= 8)
+    {
+      out.push_back((unsigned char)bits);
+      bits >>= 8;
+      count -= 8;
+    }
+  }
+
+  /** Huffman codes go out most significant bit first **/
+  void putCode(uint32_t code, int length)
+  {
+    uint32_t reversed = 0;
+    for (int i = 0; i < length; i++)
+      reversed |= ((code >> i) & 1) << (length - 1 - i);
+    put(reversed, length);
+  }
+
+  void literal(int symbol)
+  {
+    if (symbol < 144)
+      putCode(0x30 + symbol, 8);
+    else if (symbol < 256)
+      putCode(0x190 + symbol - 144, 9);
+    else if (symbol < 280)
+      putCode(symbol - 256, 7);
+    else
+      putCode(0xc0 + symbol - 280, 8);
+  }
+
+  void match(int length, int distance)
+  {
+    static const int lengthBase[29] =
+      { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99,
+        115, 131, 163, 195, 227, 258 };
+    static const int lengthExtra[29] =
+      { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+    static const int distanceBase[30] =
+      { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025,
+        1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+    static const int distanceExtra[30] =
+      { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11,
+        12, 12, 13, 13 };
+
+    int l = 28;
+    while (lengthBase[l] > length)
+      l--;
+    literal(257 + l);
+    put((uint32_t)(length - lengthBase[l]), lengthExtra[l]);
+
+    int d = 29;
+    while (distanceBase[d] > distance)
+      d--;
+    putCode((uint32_t)d, 5);
+    put((uint32_t)(distance - distanceBase[d]), distanceExtra[d]);
+  }
+
+  void finish()
+  {
+    if (count > 0)
+      out.push_back((unsigned char)bits);
+    bits = 0;
+    count = 0;
+  }
+
+private:
+  std::vector<unsigned char> &out;
+  uint64_t bits;
+  int count;
+};
+
+static inline uint32_t matchHash(const unsigned char *p)
+{
+  return ((uint32_t)p[0] << 16 | (uint32_t)p[1] << 8 | p[2]) * 2654435761u >> (32 - MATCH_HASH_BITS);
+}
+
+/*********************************************************************
+ ** Function: Deflate
+ ** Description: data as one final fixed Huffman block. Each position is
+ matched against the last position with the same three byte hash and
+ against the same position a row back; the longer match wins.
+ *********************************************************************/
+static void deflate(const unsigned char *data, std::size_t size, std::size_t rowBytes,
+                    std::vector<unsigned char> &out)
+{
+  std::vector<long long> last((std::size_t)1 << MATCH_HASH_BITS, -1);
+  DeflateWriter writer(out);
+
+  writer.put(1, 1);    // final block
+  writer.put(1, 2);    // fixed Huffman codes
+
+  std::size_t i = 0;
+  while (i < size)
+  {
+    std::size_t bestLength = 0, bestDistance = 0;
+
+    if (i + MIN_MATCH <= size)
+    {
+      const std::size_t limit = std::min<std::size_t>(MAX_MATCH, size - i);
+      const uint32_t h = matchHash(data + i);
+      const long long candidates[2] = { last[h], (long long)i - (long long)rowBytes };
+      last[h] = (long long)i;
+
+      for (int k = 0; k < 2; k++)
+      {
+        const long long from = candidates[k];
+        if (from < 0 || i - (std::size_t)from > DEFLATE_WINDOW)
+          continue;
+        std::size_t length = 0;
+        while (length < limit && data[from + length] == data[i + length])
+          length++;
+        if (length > bestLength)
+        {
+          bestLength = length;
+          bestDistance = i - (std::size_t)from;
+        }
+      }
+    }
+
+    if (bestLength >= MIN_MATCH)
+    {
+      writer.match((int)bestLength, (int)bestDistance);
+      for (std::size_t j = i + 1; j < i + bestLength && j + MIN_MATCH <= size; j++)
+        last[matchHash(data + j)] = (long long)j;
+      i += bestLength;
+    }
+    else
+      writer.literal(data[i++]);
+  }
+  writer.literal(256);
+  writer.finish();
+}
+
+/** the CRC-32 table PNG chunks use, built on first use **/
+struct CrcTable
+{
+  uint32_t entries[256];
+
+  CrcTable()
+  {
+    for (uint32_t n = 0; n < 256; n++)
+    {
+      uint32_t c = n;
+      for (int k = 0; k < 8; k++)
+        c = c & 1 ? 0xedb88320u ^ (c >> 1) : c >> 1;
+      entries[n] = c;
+    }
+  }
+};
+
+static uint32_t crc32(const unsigned char *data, std::size_t size)
+{
+  static const CrcTable table;
+  uint32_t crc = 0xffffffffu;
+
+  for (std::size_t i = 0; i < size; i++)
+    crc = table.entries[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+  return ~crc;
+}
+
+static uint32_t adler32(const unsigned char *data, std::size_t size)
+{
+  uint32_t a = 1, b = 0;
+
+  /** 5552 bytes is the most that can be summed before the mod is due **/
+  for (std::size_t i = 0; i < size;)
+  {
+    const std::size_t end = std::min<std::size_t>(size, i + 5552);
+    for (; i < end; i++)
+    {
+      a += data[i];
+      b += a;
+    }
+    a %= 65521;
+    b %= 65521;
+  }
+  return b << 16 | a;
+}
+
+static void appendBigEndian(std::vector<unsigned char> &out, uint32_t value)
+{
+  for (int shift = 24; shift >= 0; shift -= 8)
+    out.push_back((unsigned char)(value >> shift));
+}
+
+/** a chunk whose type and data are already at out[start]; the length goes in front **/
+static void closeChunk(std::vector<unsigned char> &out, std::size_t start)
+{
+  const uint32_t length = (uint32_t)(out.size() - start - 4);
+  appendBigEndian(out, crc32(&out[start], out.size() - start));
+
+  unsigned char bytes[4] = { (unsigned char)(length >> 24), (unsigned char)(length >> 16),
+                             (unsigned char)(length >> 8), (unsigned char)length };
+  out.insert(out.begin() + (std::ptrdiff_t)start, bytes, bytes + 4);
+}
+
+void encodePng(const unsigned char *pixels, int width, int height, std::vector<unsigned char> &out)
+{
+  static const unsigned char signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+  out.insert(out.end(), signature, signature + 8);
+
+  std::size_t start = out.size();
+  appendText(out, "IHDR");
+  appendBigEndian(out, (uint32_t)width);
+  appendBigEndian(out, (uint32_t)height);
+  const unsigned char header[5] = { 8, 0, 0, 0, 0 };   // 8 bit gray, deflate, no interlace
+  out.insert(out.end(), header, header + 5);
+  closeChunk(out, start);
+
+  /** every row starts with filter type 0; the matcher finds repeats on its own **/
+  const std::size_t rowBytes = (std::size_t)width + 1;
+  std::vector<unsigned char> raw(rowBytes * height);
+  for (int r = 0; r < height; r++)
+  {
+    raw[r * rowBytes] = 0;
+    std::memcpy(&raw[r * rowBytes + 1], pixels + (std::size_t)r * width, (std::size_t)width);
+  }
+
+  start = out.size();
+  appendText(out, "IDAT");
+  out.push_back(0x78);    // zlib: deflate with a 32K window
+  out.push_back(0x01);
+  deflate(raw.data(), raw.size(), rowBytes, out);
+  appendBigEndian(out, adler32(raw.data(), raw.size()));
+  closeChunk(out, start);
+
+  start = out.size();
+  appendText(out, "IEND");
+  closeChunk(out, start);
+}
+
+FrameFormat frameFormat(const std::string &target)
+{
+  if (!target.empty() && target[0] == '|')
+    return FRAME_Y4M;
+
+  static const struct { const char *extension; FrameFormat format; } formats[] =
+  {
+    { ".pbm", FRAME_PBM }, { ".pgm", FRAME_PGM }, { ".png", FRAME_PNG }, { ".y4m", FRAME_Y4M }
+  };
+  for (std::size_t i = 0; i < sizeof(formats) / sizeof(formats[0]); i++)
+  {
+    const std::size_t length = std::strlen(formats[i].extension);
+    if (target.size() > length
+        && target.compare(target.size() - length, length, formats[i].extension) == 0)
+      return formats[i].format;
+  }
+  throw std::invalid_argument("--frames: expected a .pbm, .pgm, .png or .y4m path or |command, got '"
+                              + target + "'");
+}
+
+/*********************************************************************
+ ** Function: Start Pipe
+ ** Description: runs command under /bin/sh with its standard input reading
+ from the returned descriptor
+ ** Post-Conditions: throws std::runtime_error if the pipe or the process
+ cannot be made
+ *********************************************************************/
+static int startPipe(const std::string &command, pid_t &child)
+{
+  int ends[2];
+  if (pipe(ends) != 0)
+    throw std::runtime_error("--frames: pipe: " + std::string(std::strerror(errno)));
+
+  child = fork();
+  if (child < 0)
+  {
+    int error = errno;
+    ::close(ends[0]);
+    ::close(ends[1]);
+    throw std::runtime_error("--frames: fork: " + std::string(std::strerror(error)));
+  }
+  if (child == 0)
+  {
+    dup2(ends[0], STDIN_FILENO);
+    ::close(ends[0]);
+    ::close(ends[1]);
+    execl("/bin/sh", "sh", "-c", command.c_str(), (char *)NULL);
+    _exit(127);
+  }
+
+  ::close(ends[0]);
+  fcntl(ends[1], F_SETFD, FD_CLOEXEC);
+  return ends[1];
+}
+
+FrameExporter::FrameExporter(const std::string &target, const FrameView &view, int boardRows,
+                             int boardColumns, double framesPerSecond, int slots)
+  : target(target), frameFormatKind(frameFormat(target)),
+    frameView(resolveView(view, boardRows, boardColumns)), framesPerSecond(framesPerSecond),
+    stream(-1), child(-1), ring(slots > 0 ? slots : 1), head(0), tail(0),
+    encoderWaiting(false), stopping(false), closed(false), spacing(1), sinceKept(0),
+    droppedCount(0), subsampledCount(0), writtenCount(0), failedCount(0)
+{
+  if (frameView.rows == 0 || frameView.columns == 0)
+    throw std::invalid_argument("--crop: no cell of the " + std::to_string(boardRows) + "x"
+                                + std::to_string(boardColumns) + " board is in view");
+  if ((long long)frameWidth(frameView) * frameHeight(frameView) > MAX_FRAME_PIXELS)
+    throw std::invalid_argument("--frame-scale: frames of " + std::to_string(frameWidth(frameView))
+                                + "x" + std::to_string(frameHeight(frameView))
+                                + " pixels are too large");
+  if (!(framesPerSecond > 0))
+    throw std::invalid_argument("--frame-rate: expected a positive rate");
+
+  if (frameFormatKind != FRAME_Y4M)
+    framePath(0);
+  else if (target[0] == '|')
+    stream = startPipe(target.substr(1), child);
+  else
+  {
+    stream = open(target.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (stream < 0)
+      throw std::runtime_error(target + ": " + std::strerror(errno));
+  }
+
+  encoder = std::thread(&FrameExporter::encoderLoop, this);
+}
+
+FrameExporter::~FrameExporter()
+{
+  close();
+}
+
+/*********************************************************************
+ ** Function: FrameExporter::observe
+ ** Description: the only work on the stepping thread: a board copy into the
+ slot at head, published with a release store. The slot is only reused once
+ the encoder has moved tail past it, so nothing here ever waits.
+ *********************************************************************/
+void FrameExporter::observe(const Engine &engine)
+{
+  if (closed)
+    return;
+  if (++sinceKept < spacing)
+  {
+    subsampledCount++;
+    return;
+  }
+  sinceKept = 0;
+
+  const unsigned long long at = head.load(std::memory_order_relaxed),
+                           done = tail.load(std::memory_order_acquire);
+  if (at - done == ring.size())
+  {
+    droppedCount++;
+    if (spacing < MAX_FRAME_SPACING)
+      spacing *= 2;
+    return;
+  }
+  if (at == done && spacing > 1)
+    spacing /= 2;
+
+  Slot &slot = ring[at % ring.size()];
+  engine.storeBits(slot.board);
+  slot.generation = engine.generation();
+  head.store(at + 1, std::memory_order_seq_cst);
+  if (encoderWaiting.load(std::memory_order_seq_cst))
+    wake.notify_one();
+}
+
+void FrameExporter::close()
+{
+  if (closed)
+    return;
+  closed = true;
+
+  stopping.store(true, std::memory_order_seq_cst);
+  wake.notify_one();
+  encoder.join();
+
+  if (stream >= 0)
+  {
+    if (::close(stream) != 0)
+      fail(target + ": " + std::strerror(errno));
+    stream = -1;
+  }
+  if (child > 0)
+  {
+    int status = 0;
+    while (waitpid(child, &status, 0) < 0 && errno == EINTR)
+      continue;
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+      fail(target.substr(1) + ": did not exit cleanly");
+    child = -1;
+  }
+}
+
+std::string FrameExporter::lastError()
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return error;
+}
+
+void FrameExporter::fail(const std::string &message)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  error = message;
+  failedCount++;
+}
+
+/** the target with its %d (or %06d and the like) replaced by generation **/
+std::string FrameExporter::framePath(long long generation) const
+{
+  const std::size_t percent = target.find('%');
+  std::size_t end = percent + 1;
+  bool zeros = false;
+
+  if (percent != std::string::npos && end < target.size() && target[end] == '0')
+  {
+    zeros = true;
+    end++;
+  }
+  int width = 0;
+  while (percent != std::string::npos && end < target.size() && target[end] >= '0'
+         && target[end] <= '9' && width < 100)
+    width = width * 10 + (target[end++] - '0');
+  if (percent == std::string::npos || end >= target.size() || target[end] != 'd'
+      || target.find('%', end) != std::string::npos)
+    throw std::invalid_argument("--frames: " + target
+                                + " needs one %d for the generation, e.g. frame%06d.png");
+
+  char number[128];
+  std::snprintf(number, sizeof(number), zeros ? "%0*lld" : "%*lld", width, generation);
+  return target.substr(0, percent) + number + target.substr(end + 1);
+}
+
+void FrameExporter::writeStream(const void *data, std::size_t bytes)
+{
+  const char *p = static_cast<const char *>(data);
+
+  while (bytes > 0)
+  {
+    ssize_t done = write(stream, p, bytes);
+    if (done < 0)
+    {
+      if (errno == EINTR)
+        continue;
+      throw std::runtime_error(target + ": " + std::strerror(errno));
+    }
+    p += done;
+    bytes -= (std::size_t)done;
+  }
+}
+
+/*********************************************************************
+ ** Function: FrameExporter::encode
+ ** Description: one frame out, on the encoder thread. The pixel and file
+ buffers are kept between frames.
+ *********************************************************************/
+void FrameExporter::encode(const Slot &slot)
+{
+  const int width = frameWidth(frameView),
+            height = frameHeight(frameView);
+
+  renderFrame(slot.board, frameView, pixels);
+  if (frameFormatKind == FRAME_Y4M)
+  {
+    writeStream("FRAME\n", 6);
+    writeStream(pixels.data(), pixels.size());
+    return;
+  }
+
+  encoded.clear();
+  if (frameFormatKind == FRAME_PBM)
+    encodePbm(pixels.data(), width, height, encoded);
+  else if (frameFormatKind == FRAME_PGM)
+    encodePgm(pixels.data(), width, height, encoded);
+  else
+    encodePng(pixels.data(), width, height, encoded);
+
+  const std::string path = framePath(slot.generation);
+  std::FILE *file = std::fopen(path.c_str(), "wb");
+  if (file == NULL)
+    throw std::runtime_error(path + ": " + std::strerror(errno));
+  const bool whole = std::fwrite(encoded.data(), 1, encoded.size(), file) == encoded.size();
+  if (std::fclose(file) != 0 || !whole)
+    throw std::runtime_error(path + ": " + std::strerror(errno));
+}
+
+/*********************************************************************
+ ** Function: FrameExporter::encoderLoop
+ ** Description: encodes the slot at tail and then releases it by moving tail
+ on. With the ring empty it sets encoderWaiting and looks once more before
+ sleeping, so a frame published in between is either seen or wakes it; the
+ stepping thread notifies without the lock, and a wakeup that still slips
+ by costs at most FRAME_NAP_MS. SIGPIPE is blocked here so a pipe whose
+ reader has gone fails the write instead of ending the program.
+ *********************************************************************/
+void FrameExporter::encoderLoop()
+{
+  sigset_t pipeSignal;
+  sigemptyset(&pipeSignal);
+  sigaddset(&pipeSignal, SIGPIPE);
+  pthread_sigmask(SIG_BLOCK, &pipeSignal, NULL);
+
+  if (frameFormatKind == FRAME_Y4M)
+  {
+    char header[160];
+    std::snprintf(header, sizeof(header), "YUV4MPEG2 W%d H%d F%lld:1000 Ip A1:1 Cmono\n",
+                  frameWidth(frameView), frameHeight(frameView),
+                  (long long)std::llround(framesPerSecond * 1000));
+    try
+    {
+      writeStream(header, std::strlen(header));
+    }
+    catch (const std::exception &problem)
+    {
+      fail(problem.what());
+    }
+  }
+
+  for (;;)
+  {
+    const unsigned long long at = tail.load(std::memory_order_relaxed);
+    if (at == head.load(std::memory_order_acquire))
+    {
+      if (stopping.load(std::memory_order_seq_cst) && at == head.load(std::memory_order_acquire))
+        return;
+
+      std::unique_lock<std::mutex> lock(mutex);
+      encoderWaiting.store(true, std::memory_order_seq_cst);
+      if (at == head.load(std::memory_order_seq_cst) && !stopping.load())
+        wake.wait_for(lock, std::chrono::milliseconds(FRAME_NAP_MS));
+      encoderWaiting.store(false, std::memory_order_relaxed);
+      continue;
+    }
+
+    try
+    {
+      encode(ring[at % ring.size()]);
+      writtenCount++;
+    }
+    catch (const std::exception &problem)
+    {
+      fail(problem.what());
+    }
+    tail.store(at + 1, std::memory_order_release);
+  }
+}
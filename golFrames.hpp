@@ -0,0 +1,208 @@
+/************************************************************************************************
+ ** Program       Filename: GameOfLife
+ ** Current       File: golFrames.hpp
+ ** Author:       Jordan Grant
+ ** Date:         10.17.26
+ ** Description: 	Frame export for long runs. A FrameView picks the part of the board to
+ show and how large: a crop rectangle, and either pixels per cell or cells per pixel
+ (a shrunk pixel shows how full its block is). FrameExporter watches a Simulation and
+ turns the generations it sees into PBM, PGM or PNG files, or one YUV4MPEG2 stream
+ (a file, a named pipe or a command to pipe into, such as ffmpeg). The stepping thread
+ only copies the board into a free slot of a bounded single producer, single consumer
+ ring; an encoder thread crops, scales, encodes and writes the frames. When the encoder
+ falls behind the ring fills, and rather than wait the exporter drops that frame and
+ from then on keeps only every other frame it would have kept, doubling the spacing
+ until the encoder keeps up; frames that go into an empty ring halve it again. Live
+ cells are white in every format.
+ **************************************************************************************************/
+
+
+#ifndef GOLFRAMES_HPP
+#define GOLFRAMES_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <sys/types.h>
+#include <thread>
+#include <vector>
+#include "golBitGrid.hpp"
+#include "golEngine.hpp"
+
+/** board copies the ring holds by default **/
+#define FRAME_SLOTS 8
+
+enum FrameFormat
+{
+  FRAME_PBM,     // binary bitmap, one file per frame; a shrunk pixel is white if any cell lives
+  FRAME_PGM,     // 8 bit gray, one file per frame
+  FRAME_PNG,     // 8 bit gray PNG, one file per frame
+  FRAME_Y4M      // YUV4MPEG2 mono video, every frame in one stream
+};
+
+/*********************************************************************
+ ** Struct: FrameView
+ ** Description: the rectangle of rows x columns cells whose top left cell is
+ (top, left), drawn pixels x pixels to a cell, or with cells x cells cells to
+ a pixel. rows or columns of 0 or less reach that many cells short of the far
+ edge of the board, so 0 runs to the edge.
+ *********************************************************************/
+struct FrameView
+{
+  int top;
+  int left;
+  int rows;
+  int columns;
+  int pixels;       // pixels per cell side, 1 unless cells is 1
+  int cells;        // cells per pixel side, 1 unless pixels is 1
+};
+
+/** the whole board, a pixel a cell **/
+FrameView fullView();
+
+/*********************************************************************
+ ** Function: Parse Crop / Parse Frame Scale
+ ** Description: "ROWSxCOLUMNS+TOP+LEFT" (the offsets may be left off) sets
+ view's rectangle; "N" draws N pixels to a cell and "1/N" N cells to a pixel
+ ** Post-Conditions: throws std::invalid_argument naming flag if the text is
+ malformed or out of range
+ *********************************************************************/
+void parseCrop(const std::string &flag, const std::string &text, FrameView &view);
+void parseFrameScale(const std::string &flag, const std::string &text, FrameView &view);
+
+/*********************************************************************
+ ** Function: Resolve View
+ ** Description: view on a boardRows x boardColumns board: rows and columns
+ made positive and the rectangle clipped to the board
+ ** Post-Conditions: rows or columns is 0 if no cell of the board is left in
+ the rectangle
+ *********************************************************************/
+FrameView resolveView(const FrameView &view, int boardRows, int boardColumns);
+
+/** pixels across a resolved view: every started block of cells is a pixel **/
+inline int frameHeight(const FrameView &view)
+{
+  return (view.rows + view.cells - 1) / view.cells * view.pixels;
+}
+inline int frameWidth(const FrameView &view)
+{
+  return (view.columns + view.cells - 1) / view.cells * view.pixels;
+}
+
+/*********************************************************************
+ ** Function: Render Frame
+ ** Description: draws a resolved view of board as 8 bit gray, one byte per
+ pixel, frameHeight() rows of frameWidth() bytes: live cells 255, dead 0,
+ and a shrunk pixel the share of its block's cells that are alive
+ ** Post-Conditions: pixels is resized to fit; its capacity is reused
+ *********************************************************************/
+void renderFrame(const BitGrid &board, const FrameView &view, std::vector<unsigned char> &pixels);
+
+/*********************************************************************
+ ** Function: Encode PNG / PBM / PGM
+ ** Description: appends a width x height gray image to out as a whole file.
+ The PNG is compressed by a small deflate of its own: one pass of LZ77
+ matching on a hash of the next three bytes, then fixed Huffman codes, which
+ suits boards whose rows are mostly runs and repeats of earlier rows.
+ *********************************************************************/
+void encodePng(const unsigned char *pixels, int width, int height, std::vector<unsigned char> &out);
+void encodePbm(const unsigned char *pixels, int width, int height, std::vector<unsigned char> &out);
+void encodePgm(const unsigned char *pixels, int width, int height, std::vector<unsigned char> &out);
+
+/*********************************************************************
+ ** Function: Frame Format
+ ** Description: the format a --frames target names: "|command" is a y4m pipe,
+ otherwise the file extension (.pbm, .pgm, .png or .y4m) decides
+ ** Post-Conditions: throws std::invalid_argument for any other target
+ *********************************************************************/
+FrameFormat frameFormat(const std::string &target);
+
+/*********************************************************************
+ ** Class: FrameExporter
+ ** Description: observer that exports the generations it sees; attach it
+ with Simulation::addObserver(exporter, every). target is "|command" or a
+ path: one file per frame for PBM, PGM and PNG, where a printf style %d
+ (%06d and the like) is replaced with the generation, or the y4m stream.
+ framesPerSecond only goes in the y4m header. slots board copies make up the
+ ring.
+ ** Pre-Conditions: boardRows x boardColumns is the size of every board it
+ will see
+ ** Post-Conditions: the constructor throws std::invalid_argument for a bad
+ target or view and std::runtime_error if the y4m stream cannot be opened.
+ close() (or the destructor) encodes the frames still in the ring and closes
+ the stream. Frames that fail to write are counted and lastError() says why;
+ the run carries on.
+ *********************************************************************/
+class FrameExporter : public GenerationObserver
+{
+public:
+  FrameExporter(const std::string &target, const FrameView &view, int boardRows,
+                int boardColumns, double framesPerSecond = 30, int slots = FRAME_SLOTS);
+  ~FrameExporter();
+
+  void observe(const Engine &engine);
+  /** drains the ring and closes the stream; observing afterwards does nothing **/
+  void close();
+
+  FrameFormat format() const { return frameFormatKind; }
+  /** the resolved view and the frame size it gives **/
+  const FrameView &view() const { return frameView; }
+  long long written() const { return writtenCount.load(); }
+  /** frames that found the ring full **/
+  long long dropped() const { return droppedCount; }
+  /** frames passed over to space the rest out after a drop **/
+  long long subsampled() const { return subsampledCount; }
+  long long failed() const { return failedCount.load(); }
+  /** message of the last failed write, empty if none failed **/
+  std::string lastError();
+
+private:
+  FrameExporter(const FrameExporter &);
+  FrameExporter &operator=(const FrameExporter &);
+
+  struct Slot
+  {
+    BitGrid board;
+    long long generation;
+  };
+
+  void encoderLoop();
+  void encode(const Slot &slot);
+  void writeStream(const void *data, std::size_t bytes);
+  void fail(const std::string &message);
+  std::string framePath(long long generation) const;
+
+  std::string target;
+  FrameFormat frameFormatKind;
+  FrameView frameView;
+  double framesPerSecond;
+  int stream;               // y4m file or pipe, -1 for one file per frame
+  pid_t child;              // the command a "|command" stream feeds, or -1
+
+  std::vector<Slot> ring;
+  /** producer and consumer positions; slot i is ring[i % ring.size()] **/
+  std::atomic<unsigned long long> head;
+  std::atomic<unsigned long long> tail;
+  std::atomic<bool> encoderWaiting;
+  std::atomic<bool> stopping;
+  bool closed;
+
+  /** stepping thread only **/
+  long long spacing;
+  long long sinceKept;
+  long long droppedCount;
+  long long subsampledCount;
+
+  std::atomic<long long> writtenCount;
+  std::atomic<long long> failedCount;
+  std::string error;
+  std::vector<unsigned char> pixels;
+  std::vector<unsigned char> encoded;
+  std::mutex mutex;
+  std::condition_variable wake;
+  std::thread encoder;
+};
+
+#endif
@@ -21,6 +21,27 @@
  *****************************************************************************************************/
 
 #include "golFunctions.hpp"
+#include "golStats.hpp"
+
+/*********************************************************************
+ ** Function: Load Array / Store Array
+ ** Description: convert between the fixed ROWSxCOLUMNS char boards ('x' / '-')
+ and the runtime sized Grid (1 / 0)
+ ** Parameters: char board and a Grid that is ROWSxCOLUMNS
+ *********************************************************************/
+static void loadArray(Grid &grid, char array[ROWS][COLUMNS])
+{
+  for (int row = 0; row < ROWS; row++)
+    for (int column = 0; column < COLUMNS; column++)
+      grid.set(row, column, array[row][column] == 'x');
+}
+
+static void storeArray(const Grid &grid, char array[ROWS][COLUMNS])
+{
+  for (int row = 0; row < ROWS; row++)
+    for (int column = 0; column < COLUMNS; column++)
+      array[row][column] = grid.get(row, column) ? 'x' : '-';
+}
 
 /*********************************************************************
  ** Function: Copy 2D array
@@ -37,14 +58,16 @@ void copy(char currentGen[ROWS][COLUMNS], char nextGen[ROWS][COLUMNS])
       currentGen[row][column] = nextGen[row][column];
 }
 
+void copy(Grid &currentGen, const Grid &nextGen)
+{
+  for (int row = 0; row < currentGen.rows(); row++)
+    std::memcpy(currentGen.row(row), nextGen.row(row), currentGen.columns());
+}
+
 /*********************************************************************
  ** Function: Update Game of Life
- ** Description: This function goes to each cell and:
- 1) checks for the number of live neighbors (neighbors() function)
- 2) applies the rules for life or death (liveOrDie() function)
- 3) modifies the current cell in nextGen with the appropriate state
- 4) transfers nextGen back to currentGen for printing and to get
- ready for the next round
+ ** Description: Thin wrapper over stepGrid(): the char board is loaded into
+ a Grid, stepped once and written back to nextGen, then copied to currentGen
  ** Parameters: Takes two 2D char arrays that are ROWSxCOLUMNS
  ** Pre-Conditions: currentGen must be initialized to a "starting state"
  nextGen should be pre-initialized with some value
@@ -53,31 +76,44 @@ void copy(char currentGen[ROWS][COLUMNS], char nextGen[ROWS][COLUMNS])
  *********************************************************************/
 void updateGame(char currentGen[ROWS][COLUMNS], char nextGen[ROWS][COLUMNS])
 {
-  for (int row = 0; row < ROWS; row++)
-  {
-    for (int column = 0; column < COLUMNS; column++)
-    {
-      bool live = true;
-      char lod = currentGen[row][column];
+  GOL_STAT_SCOPE("updateGame", 1);
+  Grid current(ROWS, COLUMNS),
+       next(ROWS, COLUMNS);
 
-      live = liveOrDie(neighbors(currentGen, row, column), lod);
-
-      if (live == true)
-        nextGen[row][column] = 'x';
-      else
-        nextGen[row][column] = '-';
-    }
-  }
+  loadArray(current, currentGen);
+  stepGrid(current, next);
+  storeArray(next, nextGen);
 
   copy(currentGen, nextGen);
 }
 
+/*********************************************************************
+ ** Function: Update Game of Life (Grid)
+ ** Description: steps currentGen into nextGen under the rule and then swaps
+ the two boards, so no copy is needed
+ ** Post-Conditions: currentGen holds the new generation, nextGen the old one
+ *********************************************************************/
+void updateGame(Grid &currentGen, Grid &nextGen, const Rule &rule)
+{
+  GOL_STAT_SCOPE("updateGame", 1);
+  stepGrid(currentGen, nextGen, rule);
+  currentGen.swap(nextGen);
+}
+
+/** true if (row, column) is on the board and occupied; off-board cells are dead **/
+static bool occupied(char currentGen[ROWS][COLUMNS], int row, int column)
+{
+  return row >= 0 && row < ROWS && column >= 0 && column < COLUMNS
+         && currentGen[row][column] == 'x';
+}
+
 /*********************************************************************
  ** Function: Live Neighbors
  ** Description: finds the number of live neighbors by using the x,y
  coordinates of the current cell and checking each of the
  surrounding neighbors for "life"". If a neighboring cell is
- occupied (alive) it adds 1 to the counter.
+ occupied (alive) it adds 1 to the counter. Neighbors that fall
+ off the edge of the board count as dead.
  ** Parameters: 2D char array with dimensions ROWS*COLUMNS, 2 ints representing the
  coordinates of the current cell.
  ** Pre-Conditions: Feeds into the liveOrDie() function so it must be called inside
@@ -86,26 +122,26 @@ void updateGame(char currentGen[ROWS][COLUMNS], char nextGen[ROWS][COLUMNS])
  *********************************************************************/
 int neighbors(char currentGen[ROWS][COLUMNS], int row, int column)
 {
-  int occupied = 0;
-
-  if (currentGen[row][column - 1] == 'x') // left neighbor
-    occupied++;
-  if (currentGen[row][column + 1] == 'x') // right neighbor
-    occupied++;
-  if (currentGen[row + 1][column] == 'x') // bottom neighbor
-    occupied++;
-  if (currentGen[row - 1][column] == 'x') // top neighbor
-    occupied++;
-  if (currentGen[row + 1][column + 1] == 'x') // bottom right neighbor
-    occupied++;
-  if (currentGen[row - 1][column - 1] == 'x') // top left neighbor
-    occupied++;
-  if (currentGen[row + 1][column - 1] == 'x') // bottom left neighbor
-    occupied++;
-  if (currentGen[row - 1][column + 1] == 'x') // top right neighbor
-    occupied++;
-
-  return occupied;
+  int occupiedCells = 0;
+
+  if (occupied(currentGen, row, column - 1)) // left neighbor
+    occupiedCells++;
+  if (occupied(currentGen, row, column + 1)) // right neighbor
+    occupiedCells++;
+  if (occupied(currentGen, row + 1, column)) // bottom neighbor
+    occupiedCells++;
+  if (occupied(currentGen, row - 1, column)) // top neighbor
+    occupiedCells++;
+  if (occupied(currentGen, row + 1, column + 1)) // bottom right neighbor
+    occupiedCells++;
+  if (occupied(currentGen, row - 1, column - 1)) // top left neighbor
+    occupiedCells++;
+  if (occupied(currentGen, row + 1, column - 1)) // bottom left neighbor
+    occupiedCells++;
+  if (occupied(currentGen, row - 1, column + 1)) // top right neighbor
+    occupiedCells++;
+
+  return occupiedCells;
 }
 
 /*********************************************************************
@@ -117,7 +153,9 @@ int neighbors(char currentGen[ROWS][COLUMNS], int row, int column)
  2. If an occupied cell has more than three neighbors, it dies.
  3. If an empty cell has exactly three occupied neighbor cells it
  comes to life
- ** Parameters: int representing live neighbors, char of the current cell
+ Another rule may be passed instead; its lookup table gives the answer.
+ ** Parameters: int representing live neighbors, char of the current cell,
+ rule (Conways by default)
  ** Pre-Conditions: must have a bool variable to receive whether teh cell should
  live or die. neighbors() function should be used to generate the
  first paramater.
@@ -125,18 +163,9 @@ int neighbors(char currentGen[ROWS][COLUMNS], int row, int column)
  for true: current cell lives in the nextGen
  for false: current cell dies in the nextGen
  *********************************************************************/
-bool liveOrDie(int n, char lod)
+bool liveOrDie(int n, char lod, const Rule &rule)
 {
-  if (n == 3 && lod == '-')      // current cell come to life?
-    return true;
-  else if (n <= 1 && lod == 'x') // current cell die of lonliness?
-    return false;
-  else if (n > 3 && lod == 'x')  // current cell die of overcrowding?
-    return false;
-  else if (lod == '-')           // current cell remain dead
-    return false;
-  else                           // current cell remain alive
-    return true;
+  return rule.next(lod == 'x', n) != 0;   // birth (dead) or survival (alive) count?
 }
 
 /*********************************************************************
@@ -152,201 +181,82 @@ bool liveOrDie(int n, char lod)
  *********************************************************************/
 void printGame(char array[ROWS][COLUMNS])
 {
+  Grid grid(ROWS, COLUMNS);
+
+  loadArray(grid, array);
+  printGame(grid);
+}
+
+FrameView printView()
+{
+  FrameView view = fullView();
+
+  view.top = 3;
+  view.left = 2;
+  view.rows = -2;
+  view.columns = -2;
+  return view;
+}
+
+void printGame(const Grid &grid)
+{
+  printGame(grid, printView());
+}
+
+void printGame(const Grid &grid, const FrameView &view)
+{
+  const FrameView shown = resolveView(view, grid.rows(), grid.columns());
+  std::string line;
+
   CLEAR();
-  for (int row = 3; row < ROWS - 2; row++)
+  for (int row = shown.top; row < shown.top + shown.rows; row += shown.cells)
   {
-    for (int column = 2; column < COLUMNS - 2; column++)
+    line.clear();
+    for (int column = shown.left; column < shown.left + shown.columns; column += shown.cells)
     {
-      std::cout << array[row][column];
+      /** the liveliest cell of the block: 1 beats a dying state beats 0 **/
+      unsigned char cell = 0;
+      for (int r = row; r < row + shown.cells && r < shown.top + shown.rows; r++)
+        for (int c = column; c < column + shown.cells && c < shown.left + shown.columns; c++)
+        {
+          unsigned char state = grid.get(r, c);
+          if (state == 1 || (state != 0 && cell == 0))
+            cell = state;
+        }
+      line.append((std::size_t)shown.pixels, cell == 1 ? 'x' : cell != 0 ? '.' : '-');
     }
-    std::cout << std::endl;
+    for (int p = 0; p < shown.pixels; p++)
+      std::cout << line << std::endl;
   }
 }
 
 /*********************************************************************
  ** Function: Seed Game Board
- ** Description: clears game and seeds game board with live cells ('x')
+ ** Description: clears game and seeds game board with live cells ('x') from
+ the built in pattern registry (golPattern.hpp)
  ** Parameters: 2D char array with dimension ROWSxCOLUMNS, user choice of pattern
+ (1 based index into the registry)
  ** Pre-Conditions: Game board allocated and player choice collected
  *********************************************************************/
-void seedGameboard(char array[ROWS][COLUMNS], int pattern) {
-  /** initially set all cells to dead('-') **/
-  for (int i = 0; i < ROWS; i++)
-    for (int j = 0; j < COLUMNS; j++)
-      array[i][j] = '-';
-
-  /*
-   **Switch case to set initial states of the game by user input:
-   **1)Pulsar 2)Gliders 3) Glider Cannon 4)Queen Bee Shuttle
-   ***Each block of assignments represent a distinct pattern (eg. a single glider)
-   */
-  switch (pattern)
-  {
-    case PULSAR: //Pulsar http://www.conwaylife.com/wiki/Pulsar
-      /** Pulsar top left quadrant **/
-      array[6][17] = 'x';
-      array[6][18] = 'x';
-      array[6][19] = 'x';
-      array[8][15] = 'x';
-      array[9][15] = 'x';
-      array[10][15] = 'x';
-      array[8][20] = 'x';
-      array[9][20] = 'x';
-      array[10][20] = 'x';
-      array[11][17] = 'x';
-      array[11][18] = 'x';
-      array[11][19] = 'x';
-
-      /** Pulsar bottom left quadrant **/
-      array[13][17] = 'x';
-      array[13][18] = 'x';
-      array[13][19] = 'x';
-      array[18][17] = 'x';
-      array[18][18] = 'x';
-      array[18][19] = 'x';
-      array[14][15] = 'x';
-      array[15][15] = 'x';
-      array[16][15] = 'x';
-      array[14][20] = 'x';
-      array[15][20] = 'x';
-      array[16][20] = 'x';
-
-      /** Pulsar top right quadrant **/
-      array[6][23] = 'x';
-      array[6][24] = 'x';
-      array[6][25] = 'x';
-      array[11][23] = 'x';
-      array[11][24] = 'x';
-      array[11][25] = 'x';
-      array[8][22] = 'x';
-      array[9][22] = 'x';
-      array[10][22] = 'x';
-      array[8][27] = 'x';
-      array[9][27] = 'x';
-      array[10][27] = 'x';
-
-      /** Pulsar bottom right quadrant **/
-      array[14][22] = 'x';
-      array[15][22] = 'x';
-      array[16][22] = 'x';
-      array[14][27] = 'x';
-      array[15][27] = 'x';
-      array[16][27] = 'x';
-      array[13][23] = 'x';
-      array[13][24] = 'x';
-      array[13][25] = 'x';
-      array[18][23] = 'x';
-      array[18][24] = 'x';
-      array[18][25] = 'x';
-
-      break;
-
-    case GLIDERS: //gliders https://en.wikipedia.org/wiki/Glider_(Conway%27s_Life)
-      /** left most glider **/
-      array[2][6] = 'x';
-      array[3][7] = 'x';
-      array[4][7] = 'x';
-      array[4][6] = 'x';
-      array[4][5] = 'x';
-
-      /** second to left glider **/
-      array[2][12] = 'x';
-      array[3][13] = 'x';
-      array[4][13] = 'x';
-      array[4][12] = 'x';
-      array[4][11] = 'x';
-
-      /** second to right glider **/
-      array[2][18] = 'x';
-      array[3][19] = 'x';
-      array[4][19] = 'x';
-      array[4][18] = 'x';
-      array[4][17] = 'x';
-
-      /** right most glider **/
-      array[2][24] = 'x';
-      array[3][25] = 'x';
-      array[4][25] = 'x';
-      array[4][24] = 'x';
-      array[4][23] = 'x';
-
-      break;
-
-    case GLIDER_GUN: //Glider Cannon http://www.conwaylife.com/wiki/Gosper_glider_gun
-
-      /** left feeder block **/
-      array[10][4] = 'x';
-      array[10][5] = 'x';
-      array[11][4] = 'x';
-      array[11][5] = 'x';
-
-      /** left figure **/
-      array[10][14] = 'x';
-      array[11][14] = 'x';
-      array[12][14] = 'x';
-      array[9][15] = 'x';
-      array[13][15] = 'x';
-      array[8][16] = 'x';
-      array[8][17] = 'x';
-      array[14][16] = 'x';
-      array[14][17] = 'x';
-      array[11][18] = 'x';
-      array[9][19] = 'x';
-      array[13][19] = 'x';
-      array[10][20] = 'x';
-      array[11][20] = 'x';
-      array[12][20] = 'x';
-      array[11][21] = 'x';
-
-      /** right figure **/
-      array[8][24] = 'x';
-      array[9][24] = 'x';
-      array[10][24] = 'x';
-      array[8][25] = 'x';
-      array[9][25] = 'x';
-      array[10][25] = 'x';
-      array[7][26] = 'x';
-      array[11][26] = 'x';
-      array[6][28] = 'x';
-      array[7][28] = 'x';
-      array[11][28] = 'x';
-      array[12][28] = 'x';
-
-      /** right feeder block **/
-      array[8][38] = 'x';
-      array[9][38] = 'x';
-      array[8][39] = 'x';
-      array[9][39] = 'x';
-
-      break;
+void seedGameboard(char array[ROWS][COLUMNS], int pattern)
+{
+  Grid grid(ROWS, COLUMNS);
 
-    case QUEEN_BEE: //Queen Bee Shuttle http://www.conwaylife.com/wiki/Queen_bee_shuttle
-      /** Left feeder block **/
-      array[11][11] = 'x';
-      array[11][12] = 'x';
-      array[12][11] = 'x';
-      array[12][12] = 'x';
+  seedGameboard(grid, pattern);
+  storeArray(grid, array);
+}
 
-      /** Right feeder block **/
-      array[11][31] = 'x';
-      array[11][32] = 'x';
-      array[12][31] = 'x';
-      array[12][32] = 'x';
+void seedGameboard(Grid &grid, int pattern)
+{
+  /** initially set all cells to dead **/
+  grid.clear();
 
-      /** Center figure 'Queen Bee' **/
-      array[11][16] = 'x';
-      array[10][17] = 'x';
-      array[12][17] = 'x';
-      array[13][18] = 'x';
-      array[9][18] = 'x';
-      array[10][19] = 'x';
-      array[11][19] = 'x';
-      array[12][19] = 'x';
-      array[8][20] = 'x';
-      array[9][20] = 'x';
-      array[13][20] = 'x';
-      array[14][21] = 'x';
+  if (pattern < 1 || pattern > patternCount())
+    return;
 
-      break;
-  }
+  /** built in patterns are anchored on the classic board and stay centred on larger ones **/
+  const PatternEntry &entry = patternEntry(pattern - 1);
+  GridSink sink(grid, entry.row + (grid.rows() - ROWS) / 2,
+                entry.column + (grid.columns() - COLUMNS) / 2);
+  loadPattern(entry, sink);
 }
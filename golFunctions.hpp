@@ -36,6 +36,7 @@
 #define ROWS 24
 #define COLUMNS 44
 
+/** menu numbers of the built in patterns, in registry order (golPattern.cpp) **/
 enum PATTERNS {
   PULSAR = 1,
   GLIDERS,
@@ -46,6 +47,10 @@ enum PATTERNS {
 
 #include <iostream>
 #include <string>
+#include <cstring>
+#include "golGrid.hpp"
+#include "golPattern.hpp"
+#include "golFrames.hpp"
 
 /*********************************************************************
  ** Function: Copy 2D array
@@ -56,30 +61,37 @@ enum PATTERNS {
  ** Post-Conditions: printGame() will now output the most recently modified generation
  *********************************************************************/
 void copy(char currentGen[ROWS][COLUMNS], char lastGen[ROWS][COLUMNS]);
+void copy(Grid &currentGen, const Grid &nextGen);
 
 /*********************************************************************
  ** Function: Update Game of Life
- ** Description: This function goes to each cell and:
- 1) checks for the number of live neighbors (neighbors() function)
- 2) applies the rules for life or death (liveOrDie() function)
+ ** Description: This function steps the board one generation (stepGrid()):
+ 1) counts the live neighbors of every cell
+ 2) applies the rules for life or death
  3) modifies the current cell in nextGen with the appropriate state
  4) transfers nextGen back to currentGen for printing and to get
  ready for the next round
- ** Parameters: Takes two 2D char arrays that are ROWSxCOLUMNS
+ The char array version is a thin wrapper that converts to and from a Grid.
+ ** Parameters: Takes two 2D char arrays that are ROWSxCOLUMNS, or two Grids of
+ the same size and a rule (Conways by default; a Generations rule keeps the
+ dying states in the Grid's cells)
  ** Pre-Conditions: currentGen must be initialized to a "starting state"
  nextGen should be pre-initialized with some value
  (can be NULL - will just be overwritten)
- ** Post-Conditions: If copy() is used: Both currentGen and nextGen will be updated
- If copy()is not used then only nextGen will be updated
+ ** Post-Conditions: char arrays: both currentGen and nextGen hold the new generation
+ (copy() is used). Grids: the two boards swap, so currentGen holds the new
+ generation and nextGen the previous one; nothing is copied.
  *********************************************************************/
 void updateGame(char currentGen[ROWS][COLUMNS], char nextGen[ROWS][COLUMNS]);
+void updateGame(Grid &currentGen, Grid &nextGen, const Rule &rule = Rule());
 
 /*********************************************************************
  ** Function: Live Neighbors
  ** Description: finds the number of live neighbors by using the x,y
  coordinates of the current cell and checking each of the
  surrounding neighbors for "life"". If a neighboring cell is
- occupied (alive) it adds 1 to the counter.
+ occupied (alive) it adds 1 to the counter. Neighbors that fall
+ off the edge of the board count as dead.
  ** Parameters: 2D char array with dimensions ROWS*COLUMNS, 2 ints representing the
  coordinates of the current cell.
  ** Pre-Conditions: Feeds into the liveOrDie() function so it must be called inside
@@ -97,7 +109,9 @@ int neighbors(char currentGen[ROWS][COLUMNS], int row, int column);
  2. If an occupied cell has more than three neighbors, it dies.
  3. If an empty cell has exactly three occupied neighbor cells it
  comes to life
- ** Parameters: int representing live neighbors, char of the current cell
+ Another rule may be passed instead; its lookup table gives the answer.
+ ** Parameters: int representing live neighbors, char of the current cell,
+ rule (Conways by default)
  ** Pre-Conditions: must have a bool variable to receive whether teh cell should
  live or die. neighbors() function should be used to generate the
  first paramater.
@@ -105,28 +119,42 @@ int neighbors(char currentGen[ROWS][COLUMNS], int row, int column);
  for true: current cell lives in the nextGen
  for false: current cell dies in the nextGen
  *********************************************************************/
-bool liveOrDie(int n, char lod);
+bool liveOrDie(int n, char lod, const Rule &rule = Rule());
 
 /*********************************************************************
  ** Function: Print Array
- ** Description: Prints a 20x40 2D char array
- ** Parameters: 2D char array with dimension ROWSxCOLUMNS
+ ** Description: Prints a 20x40 2D char array. A Grid prints live cells as 'x',
+ dead ones as '-' and the dying states of a Generations rule as '.'. With a
+ FrameView only its crop is printed, each cell repeated view.pixels times
+ across and down, or each view.cells x view.cells block as one character
+ ('x' if any cell lives, else '.' if any is dying).
+ ** Parameters: 2D char array with dimension ROWSxCOLUMNS, or a Grid and
+ optionally the view of it to print
  ** Pre-Conditions: 1) if GameOfLife is just begun:
  The current generation must be initialized to start position
  2) else the temp array must be copied to GameOfLife array after update()
- ** Post-Conditions: A segment of the Game of life is printed to the screen, excluding a
- 2 cell wide band around the parimeter. This avoids seeing strange
- behavior as sequences reach the edge of the board.
+ ** Post-Conditions: A segment of the Game of life is printed to the screen. Without
+ a view that is printView(): the board less 3 rows at the top and a 2 cell wide
+ band around the rest of the parimeter. This avoids seeing strange behavior as
+ sequences reach the edge of the board.
  *********************************************************************/
 void printGame(char array[ROWS][COLUMNS]);
+void printGame(const Grid &grid);
+void printGame(const Grid &grid, const FrameView &view);
+
+/** the crop printGame() has always used **/
+FrameView printView();
 
 /*********************************************************************
  ** Function: Seed Game Board
- ** Description: clears game and seeds game board with live cells ('x')
- ** Parameters: 2D char array with dimension ROWSxCOLUMNS, user choice of pattern
+ ** Description: clears game and seeds game board with live cells ('x') from
+ the built in pattern registry. Patterns are laid out for a ROWSxCOLUMNS board
+ and are centred on larger Grids; cells that fall off the board are dropped.
+ ** Parameters: 2D char array with dimension ROWSxCOLUMNS or a Grid, user choice of pattern
  ** Pre-Conditions: Game board allocated and player choice collected
  *********************************************************************/
 void seedGameboard(char array[ROWS][COLUMNS], int choice);
+void seedGameboard(Grid &grid, int choice);
 
 #endif
 
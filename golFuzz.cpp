@@ -0,0 +1,209 @@
+/**************************************************************************************************
+ ** Program       Filename: GameOfLife
+ ** Current       File: golFuzz.cpp
+ ** Author:       Jordan Grant
+ ** Date:         10.17.26
+ ** Description: 	Fuzz target, built with the sanitizers by `make fuzz`. Each input is
+ read as an engine, its threads and pass depth, a topology, a rule (any birth and
+ survival counts, and up to 5 states), a board size, a run length and step size, and
+ then the board's cells a bit each. The engine runs the board next to an OracleBoard
+ (golOracle.hpp) and the run aborts on the first generation they differ, so libFuzzer
+ keeps the input. Built with LIBFUZZER=1 the entry point is LLVMFuzzerTestOneInput()
+ for libFuzzer's own main; without it, for compilers with no libFuzzer, a small main
+ replays the files and directories it is given and runs -runs=N random inputs from
+ -seed=N, writing any input that fails to a crash- file.
+ *****************************************************************************************************/
+
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "golOracle.hpp"
+#include "golCycle.hpp"
+
+/** the header bytes before the cells **/
+#define FUZZ_HEADER 10
+#define FUZZ_MAX_ROWS 40
+#define FUZZ_MAX_COLUMNS 140
+#define FUZZ_MAX_GENERATIONS 32
+
+static const char *const fuzzEngines[] = { "char", "bit", "parallel", "distributed", "blocked",
+                                           "tiled", "hashlife", "sparse", "generations" };
+
+/*********************************************************************
+ ** Function: Fuzz Failed
+ ** Description: reports a difference and aborts, which libFuzzer (or the
+ driver below) takes as a crash
+ *********************************************************************/
+static void fuzzFailed(const std::string &run, const std::string &difference)
+{
+  std::cerr << "oracle mismatch: " << run << ": " << difference << "\n";
+  std::abort();
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, std::size_t size)
+{
+  if (size < FUZZ_HEADER)
+    return 0;
+
+  const std::string engineName = fuzzEngines[data[0] % (sizeof(fuzzEngines) / sizeof(fuzzEngines[0]))];
+  const int threads = data[1] % 4 + 1,
+            depth = (data[1] >> 2) % 10;
+  const Topology topology = data[2] & 1 ? TOPOLOGY_TORUS : TOPOLOGY_BOUNDED;
+  /** one input in four runs a Generations rule, with 3 to 5 states **/
+  const int states = (data[2] >> 1) % 4 == 0 ? 3 + (data[2] >> 3) % 3 : 2;
+  const unsigned birth = ((unsigned)data[3] | (unsigned)(data[4] & 1) << 8) & ~1u,
+                 survival = (unsigned)data[5] | (unsigned)(data[6] & 1) << 8;
+  const int rows = data[7] % FUZZ_MAX_ROWS + 1,
+            columns = data[8] % FUZZ_MAX_COLUMNS + 1,
+            generations = data[9] % FUZZ_MAX_GENERATIONS + 1,
+            stride = (data[4] >> 1) % 8 + 1;
+
+  if (birth == 0)
+    return 0;
+  const Rule rule(birth, survival, states);
+
+  std::unique_ptr<Engine> engine;
+  try
+  {
+    engine = makeEngine(engineName, rows, columns, threads, topology, rule, depth);
+  }
+  catch (const std::invalid_argument &)
+  {
+    return 0;
+  }
+
+  Grid board(rows, columns);
+  for (int r = 0; r < rows; r++)
+    for (int c = 0; c < columns; c++)
+    {
+      const std::size_t bit = (std::size_t)r * columns + c,
+                        byte = FUZZ_HEADER + bit / 8;
+      board.set(r, c, byte < size ? (data[byte] >> (bit % 8)) & 1 : 0);
+    }
+
+  OracleBoard oracle = OracleBoard::forEngine(engineName, rows, columns, topology, rule,
+                                              generations);
+  engine->load(board);
+  oracle.load(board);
+
+  const std::string run = engineName + "/" + std::to_string(threads) + " threads/depth "
+                          + std::to_string(depth) + "/" + topologyName(topology) + "/"
+                          + rule.notation() + "/" + std::to_string(rows) + "x"
+                          + std::to_string(columns) + "/step " + std::to_string(stride);
+  std::string difference = oracleDifference(*engine, oracle);
+  for (int done = 0; done < generations && difference.empty();)
+  {
+    const int step = generations - done < stride ? generations - done : stride;
+    engine->step(step);
+    for (int g = 0; g < step; g++)
+      oracle.step();
+    done += step;
+    difference = oracleDifference(*engine, oracle);
+  }
+  if (!difference.empty())
+    fuzzFailed(run, difference);
+  return 0;
+}
+
+#ifndef GOL_LIBFUZZER
+
+#include <dirent.h>
+#include <fstream>
+#include <iterator>
+
+/** the input being run, saved to a crash- file if it aborts **/
+static std::vector<uint8_t> currentInput;
+
+static void saveCrash(int)
+{
+  uint64_t key = currentInput.size();
+  for (std::size_t i = 0; i < currentInput.size(); i++)
+    key = hashMix(key ^ currentInput[i]);
+
+  char path[64];
+  std::snprintf(path, sizeof(path), "crash-%016llx", (unsigned long long)key);
+  FILE *file = std::fopen(path, "wb");
+  if (file != NULL)
+  {
+    std::fwrite(currentInput.data(), 1, currentInput.size(), file);
+    std::fclose(file);
+    std::fprintf(stderr, "input written to %s\n", path);
+  }
+}
+
+static void runInput(const std::vector<uint8_t> &input)
+{
+  currentInput = input;
+  LLVMFuzzerTestOneInput(input.data(), input.size());
+}
+
+/** runs the file at path, or every file in it if it is a directory **/
+static void replay(const std::string &path)
+{
+  DIR *directory = opendir(path.c_str());
+  if (directory != NULL)
+  {
+    for (struct dirent *entry = readdir(directory); entry != NULL; entry = readdir(directory))
+      if (entry->d_name[0] != '.')
+        replay(path + "/" + entry->d_name);
+    closedir(directory);
+    return;
+  }
+
+  std::ifstream file(path.c_str(), std::ios::binary);
+  if (!file)
+  {
+    std::cerr << "cannot read " << path << "\n";
+    std::exit(1);
+  }
+  runInput(std::vector<uint8_t>((std::istreambuf_iterator<char>(file)),
+                                std::istreambuf_iterator<char>()));
+}
+
+/*********************************************************************
+ ** Function: main
+ ** Description: the driver used without libFuzzer: replays the files and
+ directories named, then runs -runs=N (default 1000, or none when replaying)
+ random inputs of up to 600 bytes from -seed=N
+ *********************************************************************/
+int main(int argc, char **argv)
+{
+  long long runs = -1;
+  uint64_t seed = 1;
+  bool replayed = false;
+
+  std::signal(SIGABRT, saveCrash);
+  for (int i = 1; i < argc; i++)
+  {
+    const std::string arg = argv[i];
+    if (arg.compare(0, 6, "-runs=") == 0)
+      runs = std::atoll(arg.c_str() + 6);
+    else if (arg.compare(0, 6, "-seed=") == 0)
+      seed = (uint64_t)std::strtoull(arg.c_str() + 6, NULL, 10);
+    else
+    {
+      replay(arg);
+      replayed = true;
+    }
+  }
+  if (runs < 0)
+    runs = replayed ? 0 : 1000;
+
+  uint64_t state = seed;
+  std::vector<uint8_t> input;
+  for (long long run = 0; run < runs; run++)
+  {
+    input.resize(nextRandom(state) % 600 + FUZZ_HEADER);
+    for (std::size_t i = 0; i < input.size(); i++)
+      input[i] = (uint8_t)nextRandom(state);
+    runInput(input);
+  }
+  std::cout << "fuzz: " << runs << " random inputs from seed " << seed << " agreed with the oracle\n";
+  return 0;
+}
+
+#endif
@@ -0,0 +1,329 @@
+/**************************************************************************************************
+ ** Program       Filename: GameOfLife
+ ** Current       File: golGenerations.cpp
+ ** Author:       Jordan Grant
+ ** Date:         10.17.26
+ ** Description: 	Generations engine (see golGenerations.hpp). The step walks the board
+ row by row keeping the live rows above, at and below the current row in scratch
+ rows, derived before the planes underneath them are overwritten. The per word
+ work is templated on the plane count so each state width compiles to straight
+ line bit logic.
+ *****************************************************************************************************/
+
+#include "golGenerations.hpp"
+#include "golCycle.hpp"
+#include "golStats.hpp"
+
+#include <stdexcept>
+
+/** scratch rows: three rolling live rows, the next live row, a torus's edge rows **/
+#define SCRATCH_ROWS 6
+#define NEXT_ROW 3
+#define TOP_ROW 4
+#define BOTTOM_ROW 5
+
+GenerationsEngine::GenerationsEngine(int rows, int columns, Topology topology, const Rule &rule)
+  : Engine(rows, columns, rule), scratch(SCRATCH_ROWS, columns), topology(topology)
+{
+  planes.resize(rule.stateBits());
+  for (std::size_t i = 0; i < planes.size(); i++)
+    planes[i] = BitGrid(rows, columns);
+}
+
+/*********************************************************************
+ ** Function: Derive Live Words
+ ** Description: state 1 is plane 0 set and every other plane clear
+ *********************************************************************/
+template <int PLANES>
+static inline void deriveLiveWords(const uint64_t *const *state, uint64_t *live,
+                                   std::size_t words)
+{
+  for (std::size_t w = 0; w < words; w++)
+  {
+    uint64_t high = 0;
+    for (int i = 1; i < PLANES; i++)
+      high |= state[i][w];
+    live[w] = state[0][w] & ~high;
+  }
+}
+
+/*********************************************************************
+ ** Function: Update State Words
+ ** Description: next is the Life-like rule applied to the live cells. Births
+ only count in state 0 cells (a dying cell is not alive, so the kernel may
+ have birthed it); every other nonzero state is incremented with a ripple
+ carry across the planes and wraps to 0 when it reaches states. Cells that
+ are alive next generation are then forced to state 1. With a hash, each
+ plane word that changed swaps its key (seeds holds the plane rows' seeds).
+ *********************************************************************/
+template <int PLANES>
+static inline void updateStateWords(uint64_t *const *state, const uint64_t *next,
+                                    std::size_t words, int states, const uint64_t *seeds,
+                                    uint64_t *hash)
+{
+  uint64_t delta = 0;
+
+  for (std::size_t w = 0; w < words; w++)
+  {
+    uint64_t bits[PLANES], before[PLANES];
+    uint64_t occupied = 0, high = 0;
+
+    for (int i = 0; i < PLANES; i++)
+    {
+      bits[i] = before[i] = state[i][w];
+      occupied |= bits[i];
+      if (i > 0)
+        high |= bits[i];
+    }
+
+    const uint64_t alive = bits[0] & ~high;
+    const uint64_t born = next[w] & (alive | ~occupied);
+
+    uint64_t carry = occupied;
+    for (int i = 0; i < PLANES; i++)
+    {
+      uint64_t sum = bits[i] ^ carry;
+      carry &= bits[i];
+      bits[i] = sum;
+    }
+
+    uint64_t wrap = (states >> PLANES) & 1 ? carry : ~carry;
+    for (int i = 0; i < PLANES; i++)
+      wrap &= (states >> i) & 1 ? bits[i] : ~bits[i];
+
+    GOL_STAT_COUNT_WORDS(&alive, &born, 0, 1);
+    bits[0] = (bits[0] & ~wrap) | born;
+    for (int i = 1; i < PLANES; i++)
+      bits[i] &= ~wrap & ~born;
+
+    for (int i = 0; i < PLANES; i++)
+    {
+      state[i][w] = bits[i];
+      if (hash != NULL && bits[i] != before[i])
+        delta ^= hashWordKey(seeds[i], (long long)w, before[i])
+                 ^ hashWordKey(seeds[i], (long long)w, bits[i]);
+    }
+  }
+  if (hash != NULL)
+    *hash ^= delta;
+}
+
+/** plane i's rows are hashed as rows i * rows() onwards of one tall board, like hashGrid() **/
+static inline uint64_t planeRowSeed(int plane, int rows, int row)
+{
+  return hashRowSeed((long long)plane * rows + row);
+}
+
+/** derives the live words of a board row into a scratch row, wrapped on a torus **/
+template <int PLANES>
+static inline const uint64_t *deriveRow(const std::vector<BitGrid> &planes, int row,
+                                        BitGrid &scratch, int slot, Topology topology)
+{
+  const uint64_t *state[PLANES];
+
+  for (int i = 0; i < PLANES; i++)
+    state[i] = planes[i].row(row);
+  deriveLiveWords<PLANES>(state, scratch.row(slot), planes[0].words());
+  if (topology == TOPOLOGY_TORUS)
+    wrapBitColumns(scratch, slot, slot + 1);
+  return scratch.row(slot);
+}
+
+/*********************************************************************
+ ** Function: Step Planes
+ ** Description: one generation in place. Row r's live words are stepped from
+ the live rows r - 1, r and r + 1, all derived from the planes before row r
+ is rewritten; off the board they are the scratch board's dead halo rows,
+ or on a torus the opposite edge rows, derived before the pass starts.
+ *********************************************************************/
+template <int PLANES>
+static void stepPlanes(std::vector<BitGrid> &planes, BitGrid &scratch, Topology topology,
+                       const Rule &rule, uint64_t *hash)
+{
+  const int rows = planes[0].rows();
+  const std::size_t words = planes[0].words();
+  uint64_t *state[PLANES];
+  uint64_t seeds[PLANES];
+  uint64_t *next = scratch.row(NEXT_ROW);
+
+  const uint64_t *up = scratch.row(-1);
+  const uint64_t *bottom = scratch.row(SCRATCH_ROWS);
+  if (topology == TOPOLOGY_TORUS)
+  {
+    up = deriveRow<PLANES>(planes, rows - 1, scratch, TOP_ROW, topology);
+    bottom = deriveRow<PLANES>(planes, 0, scratch, BOTTOM_ROW, topology);
+  }
+
+  const uint64_t *mid = deriveRow<PLANES>(planes, 0, scratch, 0, topology);
+  for (int r = 0; r < rows; r++)
+  {
+    const uint64_t *down = r + 1 < rows
+                             ? deriveRow<PLANES>(planes, r + 1, scratch, (r + 1) % 3, topology)
+                             : bottom;
+
+    stepBitWords(up, mid, down, next, words, planes[0].lastWordMask(), rule);
+    for (int i = 0; i < PLANES; i++)
+    {
+      state[i] = planes[i].row(r);
+      if (hash != NULL)
+        seeds[i] = planeRowSeed(i, rows, r);
+    }
+    updateStateWords<PLANES>(state, next, words, rule.states(), seeds, hash);
+
+    up = mid;
+    mid = down;
+  }
+}
+
+void GenerationsEngine::stepOnce()
+{
+  uint64_t *hash = hashing ? &boardHash : NULL;
+
+  switch (planes.size())
+  {
+    case 1: stepPlanes<1>(planes, scratch, topology, lifeRule, hash); break;
+    case 2: stepPlanes<2>(planes, scratch, topology, lifeRule, hash); break;
+    case 3: stepPlanes<3>(planes, scratch, topology, lifeRule, hash); break;
+    case 4: stepPlanes<4>(planes, scratch, topology, lifeRule, hash); break;
+    case 5: stepPlanes<5>(planes, scratch, topology, lifeRule, hash); break;
+    case 6: stepPlanes<6>(planes, scratch, topology, lifeRule, hash); break;
+    case 7: stepPlanes<7>(planes, scratch, topology, lifeRule, hash); break;
+    default: stepPlanes<8>(planes, scratch, topology, lifeRule, hash); break;
+  }
+}
+
+void GenerationsEngine::step(long long generations)
+{
+  for (long long g = 0; g < generations; g++)
+    stepOnce();
+  generationCount += generations > 0 ? generations : 0;
+}
+
+/** live words of one row, for the slower paths that are not templated **/
+void GenerationsEngine::deriveLive(int row, uint64_t *live) const
+{
+  for (std::size_t w = 0; w < planes[0].words(); w++)
+  {
+    uint64_t high = 0;
+    for (std::size_t i = 1; i < planes.size(); i++)
+      high |= planes[i].row(row)[w];
+    live[w] = planes[0].row(row)[w] & ~high;
+  }
+}
+
+void GenerationsEngine::loadBits(const BitGrid &board)
+{
+  if (board.rows() != rowCount || board.columns() != columnCount)
+    throw std::invalid_argument("GenerationsEngine::loadBits: board dimensions differ");
+
+  planes[0] = board;
+  planes[0].clearHalo();
+  for (std::size_t i = 1; i < planes.size(); i++)
+    planes[i].clear();
+  generationCount = 0;
+  hashing = false;
+}
+
+void GenerationsEngine::storeBits(BitGrid &board) const
+{
+  if (board.rows() != rowCount || board.columns() != columnCount)
+    board = BitGrid(rowCount, columnCount);
+  else
+    board.clear();
+
+  for (int r = 0; r < rowCount; r++)
+    deriveLive(r, board.row(r));
+}
+
+/*********************************************************************
+ ** Function: GenerationsEngine::load
+ ** Description: takes each Grid cell's byte as its state
+ ** Pre-Conditions: every cell is below the rule's state count; throws
+ std::invalid_argument otherwise
+ *********************************************************************/
+void GenerationsEngine::load(const Grid &board)
+{
+  if (board.rows() != rowCount || board.columns() != columnCount)
+    throw std::invalid_argument("GenerationsEngine::load: board dimensions differ");
+
+  for (std::size_t i = 0; i < planes.size(); i++)
+    planes[i].clear();
+
+  for (int r = 0; r < rowCount; r++)
+  {
+    const unsigned char *cells = board.row(r);
+    for (int c = 0; c < columnCount; c++)
+    {
+      if (cells[c] >= lifeRule.states())
+        throw std::invalid_argument("GenerationsEngine::load: cell state "
+                                    + std::to_string(cells[c]) + " is past the rule's "
+                                    + std::to_string(lifeRule.states()) + " states");
+      for (std::size_t i = 0; i < planes.size(); i++)
+        if ((cells[c] >> i) & 1)
+          planes[i].set(r, c, true);
+    }
+  }
+  generationCount = 0;
+  hashing = false;
+}
+
+void GenerationsEngine::store(Grid &board) const
+{
+  if (board.rows() != rowCount || board.columns() != columnCount)
+    board = Grid(rowCount, columnCount);
+
+  for (int r = 0; r < rowCount; r++)
+  {
+    unsigned char *cells = board.row(r);
+    for (int c = 0; c < columnCount; c++)
+    {
+      unsigned char state = 0;
+      for (std::size_t i = 0; i < planes.size(); i++)
+        state |= (unsigned char)(planes[i].get(r, c) << i);
+      cells[c] = state;
+    }
+  }
+}
+
+/** counted a word at a time, without a row buffer, so observers can ask every generation **/
+long long GenerationsEngine::population() const
+{
+  long long count = 0;
+
+  for (int r = 0; r < rowCount; r++)
+    for (std::size_t w = 0; w < planes[0].words(); w++)
+    {
+      uint64_t high = 0;
+      for (std::size_t i = 1; i < planes.size(); i++)
+        high |= planes[i].row(r)[w];
+      count += __builtin_popcountll(planes[0].row(r)[w] & ~high);
+    }
+  return count;
+}
+
+std::size_t GenerationsEngine::memoryBytes() const
+{
+  std::size_t bytes = scratch.bufferBytes();
+
+  for (std::size_t i = 0; i < planes.size(); i++)
+    bytes += planes[i].bufferBytes();
+  return bytes;
+}
+
+/** every plane counts, so boards that differ only in dying states hash apart **/
+uint64_t GenerationsEngine::hash()
+{
+  if (hashing)
+    return boardHash;
+
+  boardHash = 0;
+  for (std::size_t i = 0; i < planes.size(); i++)
+    for (int r = 0; r < rowCount; r++)
+    {
+      const uint64_t seed = planeRowSeed((int)i, rowCount, r);
+      for (std::size_t w = 0; w < planes[i].words(); w++)
+        boardHash ^= hashWordKey(seed, (long long)w, planes[i].row(r)[w]);
+    }
+  hashing = true;
+  return boardHash;
+}
@@ -0,0 +1,58 @@
+/************************************************************************************************
+ ** Program       Filename: GameOfLife
+ ** Current       File: golGenerations.hpp
+ ** Author:       Jordan Grant
+ ** Date:         10.17.26
+ ** Description: 	Multi-state engine for Generations rules (Brian's Brain B2/S/C3, Star
+ Wars B2/S345/C4, up to 256 states). A cell's state is kept bit sliced: bit i of every
+ cell's state lives in plane i, a BitGrid, so C states take ceil(log2 C) bits per cell
+ (2 bits for 3 or 4 states, 4 for up to 16, 8 for up to 256) instead of a byte. Each
+ generation derives the live plane (state 1) one row at a time, counts live neighbors
+ with the same SIMD adder kernel as the bit engine, and updates every plane a word at a
+ time; the planes are updated in place, so there is no second buffer.
+ **************************************************************************************************/
+
+
+#ifndef GOLGENERATIONS_HPP
+#define GOLGENERATIONS_HPP
+
+#include <vector>
+#include "golEngine.hpp"
+
+/*********************************************************************
+ ** Class: GenerationsEngine
+ ** Description: bit sliced engine for any rule with 2 to 256 states. loadBits()
+ and storeBits() move the live cells (state 1); load() and store() move every
+ state as the byte value of a Grid cell.
+ *********************************************************************/
+class GenerationsEngine : public Engine
+{
+public:
+  GenerationsEngine(int rows, int columns, Topology topology = TOPOLOGY_BOUNDED,
+                    const Rule &rule = Rule());
+
+  const char *name() const { return "generations"; }
+  void loadBits(const BitGrid &board);
+  void storeBits(BitGrid &board) const;
+  void load(const Grid &board);
+  void store(Grid &board) const;
+  void step(long long generations);
+  long long population() const;
+  std::size_t memoryBytes() const;
+  uint64_t hash();
+
+  /** bits of state stored per cell **/
+  int stateBits() const { return (int)planes.size(); }
+
+private:
+  void deriveLive(int row, uint64_t *live) const;
+  void stepOnce();
+
+  std::vector<BitGrid> planes;
+  /** live rows derived on the fly, the next generation's live row, and the wrapped
+   ** edge rows of a torus **/
+  BitGrid scratch;
+  Topology topology;
+};
+
+#endif
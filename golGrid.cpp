@@ -0,0 +1,211 @@
+/**************************************************************************************************
+ ** Program       Filename: GameOfLife
+ ** Current       File: golGrid.cpp
+ ** Author:       Jordan Grant
+ ** Date:         10.17.26
+ ** Description: 	Runtime sized game board (see golGrid.hpp). The buffer layout is:
+ one halo row, rows() interior rows, one halo row. Each row is stride() bytes long and
+ starts with a cache line of padding whose last byte is the left halo column, so the
+ first interior cell of every row is cache line aligned.
+ *****************************************************************************************************/
+
+#include "golGrid.hpp"
+#include "golArena.hpp"
+#include "golStats.hpp"
+
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+/** round n up to the next multiple of the cache line **/
+static std::size_t roundToLine(std::size_t n)
+{
+  return (n + CACHE_LINE - 1) / CACHE_LINE * CACHE_LINE;
+}
+
+Grid::Grid()
+  : rowCount(0), columnCount(0), rowStride(0), bufferSize(0), buffer(NULL), origin(NULL)
+{
+}
+
+Grid::Grid(int rows, int columns)
+  : rowCount(rows), columnCount(columns), rowStride(0), bufferSize(0), buffer(NULL), origin(NULL)
+{
+  if (rows <= 0 || columns <= 0)
+    throw std::invalid_argument("Grid dimensions must be positive");
+
+  /** left padding line + interior + right halo column **/
+  rowStride = roundToLine(CACHE_LINE + (std::size_t)columns + 1);
+  bufferSize = rowStride * ((std::size_t)rows + 2);
+
+  buffer = static_cast<unsigned char *>(arenaAllocate(bufferSize));
+
+  std::memset(buffer, 0, bufferSize);
+  origin = buffer + rowStride + CACHE_LINE;
+}
+
+Grid::Grid(const Grid &other)
+  : rowCount(other.rowCount), columnCount(other.columnCount), rowStride(other.rowStride),
+    bufferSize(other.bufferSize), buffer(NULL), origin(NULL)
+{
+  if (other.buffer == NULL)
+    return;
+
+  buffer = static_cast<unsigned char *>(arenaAllocate(bufferSize));
+
+  std::memcpy(buffer, other.buffer, bufferSize);
+  origin = buffer + (other.origin - other.buffer);
+}
+
+Grid::Grid(Grid &&other) noexcept
+  : rowCount(0), columnCount(0), rowStride(0), bufferSize(0), buffer(NULL), origin(NULL)
+{
+  swap(other);
+}
+
+Grid &Grid::operator=(Grid other) noexcept
+{
+  swap(other);
+  return *this;
+}
+
+Grid::~Grid()
+{
+  arenaRelease(buffer, bufferSize);
+}
+
+/*********************************************************************
+ ** Function: Grid::clear
+ ** Description: kills every cell, including the halo
+ *********************************************************************/
+void Grid::clear()
+{
+  if (buffer != NULL)
+    std::memset(buffer, 0, bufferSize);
+}
+
+/*********************************************************************
+ ** Function: Grid::population
+ ** Description: returns the number of live (state 1) interior cells
+ *********************************************************************/
+long long Grid::population() const
+{
+  long long live = 0;
+
+  for (int r = 0; r < rowCount; r++)
+  {
+    const unsigned char *cells = row(r);
+    for (int c = 0; c < columnCount; c++)
+      live += cells[c] == 1;
+  }
+
+  return live;
+}
+
+void Grid::swap(Grid &other) noexcept
+{
+  std::swap(rowCount, other.rowCount);
+  std::swap(columnCount, other.columnCount);
+  std::swap(rowStride, other.rowStride);
+  std::swap(bufferSize, other.bufferSize);
+  std::swap(buffer, other.buffer);
+  std::swap(origin, other.origin);
+}
+
+void wrapGrid(Grid &grid)
+{
+  const int columns = grid.columns();
+
+  for (int r = 0; r < grid.rows(); r++)
+  {
+    unsigned char *cells = grid.row(r);
+    cells[-1] = cells[columns - 1];
+    cells[columns] = cells[0];
+  }
+
+  std::memcpy(grid.row(-1) - 1, grid.row(grid.rows() - 1) - 1, columns + 2);
+  std::memcpy(grid.row(grid.rows()) - 1, grid.row(0) - 1, columns + 2);
+}
+
+/*********************************************************************
+ ** Function: Step Generations Grid
+ ** Description: stepGrid() for rules with dying states: neighbors are counted
+ as cells equal to 1, a state 0 cell follows the birth counts, a live cell
+ that does not survive goes to state 2 and a dying cell moves on one state,
+ back to 0 after the last
+ *********************************************************************/
+static void stepGenerationsGrid(const Grid &current, Grid &next, const Rule &rule)
+{
+  const int columns = current.columns();
+  const int states = rule.states();
+  const unsigned char *table = rule.table();
+
+  for (int r = 0; r < current.rows(); r++)
+  {
+    const unsigned char *up = current.row(r - 1);
+    const unsigned char *mid = current.row(r);
+    const unsigned char *down = current.row(r + 1);
+    unsigned char *out = next.row(r);
+
+    for (int c = 0; c < columns; c++)
+    {
+      if (mid[c] > 1)
+      {
+        out[c] = (unsigned char)((mid[c] + 1) % states);
+        continue;
+      }
+
+      int n = (up[c - 1] == 1) + (up[c] == 1) + (up[c + 1] == 1)
+            + (mid[c - 1] == 1) + (mid[c + 1] == 1)
+            + (down[c - 1] == 1) + (down[c] == 1) + (down[c + 1] == 1);
+
+      if (table[mid[c] * 9 + n])
+        out[c] = 1;
+      else
+        out[c] = mid[c] == 1 ? 2 % states : 0;
+    }
+    GOL_STAT_COUNT_CELLS(mid, out, columns);
+  }
+}
+
+/*********************************************************************
+ ** Function: Step Grid
+ ** Description: Computes one generation of the rule (Conways Game of Life by
+ default) from current into next. The halo keeps the neighbor reads in bounds,
+ so the inner loop is a straight sum of the eight neighbors followed by a
+ lookup in the rule's table.
+ ** Parameters: current generation, grid that receives the next generation, rule
+ ** Pre-Conditions: both grids have the same dimensions and are not the same grid
+ ** Post-Conditions: next holds the following generation, current is unchanged
+ *********************************************************************/
+void stepGrid(const Grid &current, Grid &next, const Rule &rule)
+{
+  if (current.rows() != next.rows() || current.columns() != next.columns())
+    throw std::invalid_argument("stepGrid: grid dimensions differ");
+  if (rule.states() > 2)
+  {
+    stepGenerationsGrid(current, next, rule);
+    return;
+  }
+
+  const int columns = current.columns();
+  const unsigned char *table = rule.table();
+
+  for (int r = 0; r < current.rows(); r++)
+  {
+    const unsigned char *up = current.row(r - 1);
+    const unsigned char *mid = current.row(r);
+    const unsigned char *down = current.row(r + 1);
+    unsigned char *out = next.row(r);
+
+    for (int c = 0; c < columns; c++)
+    {
+      int n = up[c - 1] + up[c] + up[c + 1]
+            + mid[c - 1] + mid[c + 1]
+            + down[c - 1] + down[c] + down[c + 1];
+
+      out[c] = table[mid[c] * 9 + n];
+    }
+    GOL_STAT_COUNT_CELLS(mid, out, columns);
+  }
+}
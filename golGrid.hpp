@@ -0,0 +1,86 @@
+/************************************************************************************************
+ ** Program       Filename: GameOfLife
+ ** Current       File: golGrid.hpp
+ ** Author:       Jordan Grant
+ ** Date:         10.17.26
+ ** Description: 	Runtime sized game board. The board is stored as one contiguous,
+ cache-line-aligned buffer with one cell per byte (0 = dead, 1 = alive; under a
+ Generations rule the byte is the cell's state and 2 and up are dying). Every row is
+ padded out to a multiple of the cache line and the board is surrounded by a dead
+ halo, so row -1, row rows(), column -1 and column columns() can always be read. This
+ lets the stepping loop look at all eight neighbors without any bounds checks.
+ **************************************************************************************************/
+
+
+#ifndef GOLGRID_HPP
+#define GOLGRID_HPP
+
+#include <cstddef>
+#include "golRule.hpp"
+
+#define CACHE_LINE 64
+
+/*********************************************************************
+ ** Class: Grid
+ ** Description: rows x columns board of byte cells with a one cell dead halo.
+ The first interior cell of every row starts on a cache line boundary.
+ ** Pre-Conditions: rows and columns must be positive
+ ** Post-Conditions: all cells (and the halo) start dead
+ *********************************************************************/
+class Grid
+{
+public:
+  Grid();
+  Grid(int rows, int columns);
+  Grid(const Grid &other);
+  Grid(Grid &&other) noexcept;
+  Grid &operator=(Grid other) noexcept;
+  ~Grid();
+
+  int rows() const { return rowCount; }
+  int columns() const { return columnCount; }
+  std::size_t stride() const { return rowStride; }
+  std::size_t bufferBytes() const { return bufferSize; }
+
+  /** row -1 and row rows() are the halo rows; row(r)[-1] and row(r)[columns()] are
+   the halo columns **/
+  unsigned char *row(int r) { return origin + (std::ptrdiff_t)r * (std::ptrdiff_t)rowStride; }
+  const unsigned char *row(int r) const
+  { return origin + (std::ptrdiff_t)r * (std::ptrdiff_t)rowStride; }
+
+  unsigned char get(int r, int c) const { return row(r)[c]; }
+  void set(int r, int c, unsigned char value) { row(r)[c] = value; }
+
+  void clear();
+  long long population() const;
+  void swap(Grid &other) noexcept;
+
+private:
+  int rowCount;
+  int columnCount;
+  std::size_t rowStride;
+  std::size_t bufferSize;
+  unsigned char *buffer;
+  unsigned char *origin;
+};
+
+/*********************************************************************
+ ** Function: Wrap Grid
+ ** Description: copies the opposite edges of the board into the halo so the
+ next stepGrid() treats the board as a torus
+ *********************************************************************/
+void wrapGrid(Grid &grid);
+
+/*********************************************************************
+ ** Function: Step Grid
+ ** Description: Computes one generation of the rule (Conways Game of Life by
+ default) from current into next. Cells beyond the edge of the board are read
+ from the halo, which is always dead unless wrapGrid() has filled it. Under a
+ Generations rule only cells in state 1 count as neighbors.
+ ** Parameters: current generation, grid that receives the next generation, rule
+ ** Pre-Conditions: both grids have the same dimensions and are not the same grid
+ ** Post-Conditions: next holds the following generation, current is unchanged
+ *********************************************************************/
+void stepGrid(const Grid &current, Grid &next, const Rule &rule = Rule());
+
+#endif
@@ -0,0 +1,481 @@
+/**************************************************************************************************
+ ** Program       Filename: GameOfLife
+ ** Current       File: golHashLife.cpp
+ ** Author:       Jordan Grant
+ ** Date:         10.17.26
+ ** Description: 	HashLife universe (see golHashLife.hpp). Nodes come from a BlockPool
+ of NODE_BLOCK node blocks; the canonical node table is a chained hash table keyed on
+ the four child pointers. Nodes never handed out are all zero and freed ones are
+ marked with level -1, so a collection can sweep the pool's blocks directly.
+ *****************************************************************************************************/
+
+#include "golHashLife.hpp"
+#include "golCycle.hpp"
+
+#include <stdexcept>
+
+#define MAX_LEVEL 60
+
+static inline std::size_t hashChildren(const LifeNode *nw, const LifeNode *ne,
+                                       const LifeNode *sw, const LifeNode *se)
+{
+  uint64_t h = (uint64_t)(uintptr_t)nw;
+  h = h * 0x9E3779B97F4A7C15ULL + (uint64_t)(uintptr_t)ne;
+  h = (h ^ (h >> 29)) * 0xBF58476D1CE4E5B9ULL + (uint64_t)(uintptr_t)sw;
+  h = (h ^ (h >> 32)) * 0x94D049BB133111EBULL + (uint64_t)(uintptr_t)se;
+  return (std::size_t)(h ^ (h >> 31));
+}
+
+HashLife::HashLife(const Rule &rule, std::size_t maxNodes)
+  : dead(NULL), alive(NULL), root(NULL), initialRoot(NULL),
+    originY(0), originX(0), initialY(0), initialX(0), generationCount(0),
+    maxNodes(maxNodes), liveNodes(0), gcCount(0), markStamp(0), step(0), rule(rule)
+{
+  table.assign(1 << 16, NULL);
+
+  dead = allocate();
+  alive = allocate();
+  dead->nw = dead->ne = dead->sw = dead->se = dead->result = dead->next = NULL;
+  alive->nw = alive->ne = alive->sw = alive->se = alive->result = alive->next = NULL;
+  dead->level = alive->level = 0;
+  dead->population = 0;
+  alive->population = 1;
+  dead->mark = alive->mark = 0;
+
+  emptyNodes.push_back(dead);
+  root = initialRoot = empty(3);
+}
+
+LifeNode *HashLife::allocate()
+{
+  LifeNode *n = pool.allocate();
+  liveNodes++;
+  return n;
+}
+
+/*********************************************************************
+ ** Function: HashLife::node
+ ** Description: returns the one canonical node with these four children,
+ creating it if it does not exist yet
+ *********************************************************************/
+LifeNode *HashLife::node(LifeNode *nw, LifeNode *ne, LifeNode *sw, LifeNode *se)
+{
+  std::size_t slot = hashChildren(nw, ne, sw, se) & (table.size() - 1);
+
+  for (LifeNode *n = table[slot]; n != NULL; n = n->next)
+    if (n->nw == nw && n->ne == ne && n->sw == sw && n->se == se)
+      return n;
+
+  LifeNode *n = allocate();
+  n->nw = nw;
+  n->ne = ne;
+  n->sw = sw;
+  n->se = se;
+  n->result = NULL;
+  n->population = nw->population + ne->population + sw->population + se->population;
+  n->level = nw->level + 1;
+  n->mark = 0;
+  n->next = table[slot];
+  table[slot] = n;
+
+  if (liveNodes > table.size())
+    rehash(table.size() * 2);
+  return n;
+}
+
+void HashLife::rehash(std::size_t buckets)
+{
+  std::vector<LifeNode *> old;
+  old.swap(table);
+  table.assign(buckets, NULL);
+
+  for (std::size_t i = 0; i < old.size(); i++)
+  {
+    LifeNode *n = old[i];
+    while (n != NULL)
+    {
+      LifeNode *following = n->next;
+      std::size_t slot = hashChildren(n->nw, n->ne, n->sw, n->se) & (buckets - 1);
+      n->next = table[slot];
+      table[slot] = n;
+      n = following;
+    }
+  }
+}
+
+LifeNode *HashLife::empty(int level)
+{
+  while ((int)emptyNodes.size() <= level)
+  {
+    LifeNode *e = emptyNodes.back();
+    emptyNodes.push_back(node(e, e, e, e));
+  }
+  return emptyNodes[level];
+}
+
+/** the centre half of a node: one level down, no time step **/
+LifeNode *HashLife::centre(LifeNode *n)
+{
+  return node(n->nw->se, n->ne->sw, n->sw->ne, n->se->nw);
+}
+
+/*********************************************************************
+ ** Function: HashLife::baseStep
+ ** Description: level 2 (4x4) node: brute force one generation of the 2x2
+ centre under the rule
+ *********************************************************************/
+LifeNode *HashLife::baseStep(LifeNode *n)
+{
+  LifeNode *quads[2][2] = { { n->nw, n->ne }, { n->sw, n->se } };
+  int cells[4][4];
+
+  for (int y = 0; y < 4; y++)
+  {
+    for (int x = 0; x < 4; x++)
+    {
+      LifeNode *q = quads[y / 2][x / 2];
+      LifeNode *leaf = (y % 2) ? ((x % 2) ? q->se : q->sw) : ((x % 2) ? q->ne : q->nw);
+      cells[y][x] = (int)leaf->population;
+    }
+  }
+
+  LifeNode *next[2][2];
+  for (int y = 1; y <= 2; y++)
+  {
+    for (int x = 1; x <= 2; x++)
+    {
+      int count = cells[y - 1][x - 1] + cells[y - 1][x] + cells[y - 1][x + 1]
+                + cells[y][x - 1] + cells[y][x + 1]
+                + cells[y + 1][x - 1] + cells[y + 1][x] + cells[y + 1][x + 1];
+      next[y - 1][x - 1] = rule.next((unsigned char)cells[y][x], count) ? alive : dead;
+    }
+  }
+
+  return node(next[0][0], next[0][1], next[1][0], next[1][1]);
+}
+
+/*********************************************************************
+ ** Function: HashLife::successor
+ ** Description: centre half of a level k node advanced 2^min(step, k - 2)
+ generations. The nine overlapping level k-1 sub squares are advanced (or,
+ when step is smaller than k - 2, just centred), regrouped into four, and
+ advanced again.
+ *********************************************************************/
+LifeNode *HashLife::successor(LifeNode *n)
+{
+  if (n->result != NULL)
+    return n->result;
+
+  LifeNode *result;
+  if (n->population == 0)
+    result = empty(n->level - 1);
+  else if (n->level == 2)
+    result = baseStep(n);
+  else
+  {
+    LifeNode *n00 = n->nw,
+             *n01 = node(n->nw->ne, n->ne->nw, n->nw->se, n->ne->sw),
+             *n02 = n->ne,
+             *n10 = node(n->nw->sw, n->nw->se, n->sw->nw, n->sw->ne),
+             *n11 = node(n->nw->se, n->ne->sw, n->sw->ne, n->se->nw),
+             *n12 = node(n->ne->sw, n->ne->se, n->se->nw, n->se->ne),
+             *n20 = n->sw,
+             *n21 = node(n->sw->ne, n->se->nw, n->sw->se, n->se->sw),
+             *n22 = n->se;
+
+    LifeNode *r[3][3];
+    LifeNode *sub[3][3] = { { n00, n01, n02 }, { n10, n11, n12 }, { n20, n21, n22 } };
+    bool fullSpeed = step >= n->level - 2;
+
+    for (int y = 0; y < 3; y++)
+      for (int x = 0; x < 3; x++)
+        r[y][x] = fullSpeed ? successor(sub[y][x]) : centre(sub[y][x]);
+
+    result = node(successor(node(r[0][0], r[0][1], r[1][0], r[1][1])),
+                  successor(node(r[0][1], r[0][2], r[1][1], r[1][2])),
+                  successor(node(r[1][0], r[1][1], r[2][0], r[2][1])),
+                  successor(node(r[1][1], r[1][2], r[2][1], r[2][2])));
+  }
+
+  n->result = result;
+  return result;
+}
+
+LifeNode *HashLife::build(const BitGrid &board, int level, long long y, long long x)
+{
+  if (y >= board.rows() || x >= board.columns())
+    return empty(level);
+  if (level == 0)
+    return board.get((int)y, (int)x) ? alive : dead;
+
+  long long half = 1LL << (level - 1);
+  return node(build(board, level - 1, y, x),
+              build(board, level - 1, y, x + half),
+              build(board, level - 1, y + half, x),
+              build(board, level - 1, y + half, x + half));
+}
+
+void HashLife::load(const BitGrid &board)
+{
+  int level = 3;
+  while ((1LL << level) < board.rows() || (1LL << level) < board.columns())
+    level++;
+
+  root = initialRoot = build(board, level, 0, 0);
+  originY = originX = initialY = initialX = 0;
+  generationCount = 0;
+}
+
+void HashLife::extract(const LifeNode *n, long long y, long long x, BitGrid &board) const
+{
+  long long size = 1LL << n->level;
+
+  if (n->population == 0 || y >= board.rows() || x >= board.columns() || y + size <= 0
+      || x + size <= 0)
+    return;
+
+  if (n->level == 0)
+  {
+    board.set((int)y, (int)x, true);
+    return;
+  }
+
+  long long half = size / 2;
+  extract(n->nw, y, x, board);
+  extract(n->ne, y, x + half, board);
+  extract(n->sw, y + half, x, board);
+  extract(n->se, y + half, x + half, board);
+}
+
+/** gathers the live cells into 64 cell words keyed by (row, word) **/
+void HashLife::collect(const LifeNode *n, long long y, long long x,
+                       std::map<std::pair<long long, long long>, uint64_t> &words) const
+{
+  if (n->population == 0)
+    return;
+
+  if (n->level == 0)
+  {
+    long long word = x >= 0 ? x / WORD_BITS : -((-x + WORD_BITS - 1) / WORD_BITS);
+    words[std::make_pair(y, word)] |= (uint64_t)1 << (x - word * WORD_BITS);
+    return;
+  }
+
+  long long half = (1LL << n->level) / 2;
+  collect(n->nw, y, x, words);
+  collect(n->ne, y, x + half, words);
+  collect(n->sw, y + half, x, words);
+  collect(n->se, y + half, x + half, words);
+}
+
+uint64_t HashLife::hash() const
+{
+  std::map<std::pair<long long, long long>, uint64_t> words;
+  uint64_t result = 0;
+
+  collect(root, originY, originX, words);
+  for (std::map<std::pair<long long, long long>, uint64_t>::const_iterator it = words.begin();
+       it != words.end(); ++it)
+    result ^= hashWordKey(hashRowSeed(it->first.first), it->first.second, it->second);
+  return result;
+}
+
+void HashLife::store(BitGrid &board) const
+{
+  board.clear();
+  extract(root, originY, originX, board);
+}
+
+/** wraps the universe in a border of empty space, keeping it centred **/
+void HashLife::expand()
+{
+  if (root->level >= MAX_LEVEL)
+    throw std::overflow_error("HashLife universe is too large");
+
+  LifeNode *e = empty(root->level - 1);
+  long long shift = 1LL << (root->level - 1);
+
+  root = node(node(e, e, e, root->nw), node(e, e, root->ne, e),
+              node(e, root->sw, e, e), node(root->se, e, e, e));
+  originY -= shift;
+  originX -= shift;
+}
+
+/** true when every live cell lies in the centre half of the root **/
+bool HashLife::padded() const
+{
+  return root->nw->population == root->nw->se->population
+         && root->ne->population == root->ne->sw->population
+         && root->sw->population == root->sw->ne->population
+         && root->se->population == root->se->nw->population;
+}
+
+/** memoized results are only valid for the step they were made with **/
+void HashLife::setStep(int stepLog)
+{
+  if (stepLog == step)
+    return;
+
+  for (std::size_t i = 0; i < table.size(); i++)
+    for (LifeNode *n = table[i]; n != NULL; n = n->next)
+      n->result = NULL;
+  step = stepLog;
+}
+
+/*********************************************************************
+ ** Function: HashLife::jump
+ ** Description: advances the universe 2^stepLog generations. The universe is
+ grown until the pattern sits in the centre half with room for the step,
+ then grown once more so nothing can reach the edge of the result.
+ *********************************************************************/
+void HashLife::jump(int stepLog)
+{
+  setStep(stepLog);
+  while (root->level < stepLog + 2 || !padded())
+    expand();
+  expand();
+
+  long long shift = 1LL << (root->level - 2);
+  root = successor(root);
+  originY += shift;
+  originX += shift;
+  generationCount += 1ULL << stepLog;
+
+  if (liveNodes > maxNodes)
+    collect();
+}
+
+void HashLife::advance(unsigned long long generations)
+{
+  for (int bit = 0; bit < 64 && generations != 0; bit++, generations >>= 1)
+  {
+    if (generations & 1)
+    {
+      if (bit > MAX_LEVEL - 4)
+        throw std::overflow_error("HashLife jump is too large");
+      jump(bit);
+    }
+  }
+}
+
+std::size_t HashLife::memoryBytes() const
+{
+  return pool.memoryBytes()
+         + (table.capacity() + emptyNodes.capacity()) * sizeof(LifeNode *);
+}
+
+long long HashLife::populationAt(unsigned long long target)
+{
+  if (target < generationCount)
+  {
+    root = initialRoot;
+    originY = initialY;
+    originX = initialX;
+    generationCount = 0;
+  }
+
+  advance(target - generationCount);
+  return root->population;
+}
+
+void HashLife::markFrom(LifeNode *n)
+{
+  if (n == NULL || n->mark == markStamp)
+    return;
+
+  n->mark = markStamp;
+  if (n->level > 0)
+  {
+    markFrom(n->nw);
+    markFrom(n->ne);
+    markFrom(n->sw);
+    markFrom(n->se);
+  }
+}
+
+/*********************************************************************
+ ** Function: HashLife::collect
+ ** Description: keeps the nodes reachable from the current and initial
+ universe (and the empty nodes), frees everything else and drops all
+ memoized results
+ *********************************************************************/
+void HashLife::collect()
+{
+  markStamp++;
+  markFrom(root);
+  markFrom(initialRoot);
+  for (std::size_t i = 0; i < emptyNodes.size(); i++)
+    markFrom(emptyNodes[i]);
+  dead->mark = alive->mark = markStamp;
+
+  for (std::size_t i = 0; i < table.size(); i++)
+    table[i] = NULL;
+
+  for (std::size_t b = 0; b < pool.blockCount(); b++)
+  {
+    for (int i = 0; i < NODE_BLOCK; i++)
+    {
+      LifeNode *n = &pool.block(b)[i];
+      if (n->level <= 0)
+        continue;
+
+      if (n->mark == markStamp)
+      {
+        n->result = NULL;
+        std::size_t slot = hashChildren(n->nw, n->ne, n->sw, n->se) & (table.size() - 1);
+        n->next = table[slot];
+        table[slot] = n;
+      }
+      else
+      {
+        n->level = -1;
+        pool.release(n);
+        liveNodes--;
+      }
+    }
+  }
+
+  gcCount++;
+}
+
+HashLifeEngine::HashLifeEngine(int rows, int columns, const Rule &rule)
+  : Engine(rows, columns, rule), life(rule)
+{
+}
+
+void HashLifeEngine::loadBits(const BitGrid &board)
+{
+  life.load(board);
+  generationCount = 0;
+}
+
+void HashLifeEngine::storeBits(BitGrid &board) const
+{
+  if (board.rows() != rowCount || board.columns() != columnCount)
+    board = BitGrid(rowCount, columnCount);
+  life.store(board);
+}
+
+void HashLifeEngine::step(long long generations)
+{
+  if (generations <= 0)
+    return;
+
+  life.advance((unsigned long long)generations);
+  generationCount += generations;
+}
+
+long long HashLifeEngine::population() const
+{
+  return life.population();
+}
+
+std::size_t HashLifeEngine::memoryBytes() const
+{
+  return life.memoryBytes();
+}
+
+uint64_t HashLifeEngine::hash()
+{
+  return life.hash();
+}
@@ -0,0 +1,149 @@
+/************************************************************************************************
+ ** Program       Filename: GameOfLife
+ ** Current       File: golHashLife.hpp
+ ** Author:       Jordan Grant
+ ** Date:         10.17.26
+ ** Description: 	HashLife (Gosper's algorithm). The universe is a quadtree whose nodes
+ are hash-consed, so every distinct square of cells exists once no matter how often it
+ repeats in space or time. Each node memoizes its result: its centre half advanced
+ 2^j generations, where j is the current step exponent. Repeated and periodic
+ patterns then advance by huge powers of two in time close to constant. The universe
+ is unbounded: it grows as the pattern grows and cells never hit a wall.
+
+ Memory is bounded by a node budget. When a jump leaves more nodes than the budget
+ allows, everything not reachable from the current (or initial) universe is swept
+ and the memoized results are dropped, to be recomputed on demand.
+ **************************************************************************************************/
+
+
+#ifndef GOLHASHLIFE_HPP
+#define GOLHASHLIFE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <utility>
+#include <vector>
+#include "golArena.hpp"
+#include "golEngine.hpp"
+
+#define NODE_BLOCK 4096
+
+/*********************************************************************
+ ** Struct: Life Node
+ ** Description: square of 2^level x 2^level cells. Level 0 nodes are single
+ cells and have no children.
+ *********************************************************************/
+struct LifeNode
+{
+  LifeNode *nw, *ne, *sw, *se;
+  LifeNode *result;
+  LifeNode *next;
+  long long population;
+  int level;
+  unsigned mark;
+};
+
+/*********************************************************************
+ ** Class: HashLife
+ ** Description: unbounded universe stepped with HashLife. Boards are loaded
+ with their top left cell at (0, 0) and store() reads back any window.
+ ** Pre-Conditions: maxNodes is a soft budget; it is enforced between jumps
+ *********************************************************************/
+class HashLife
+{
+public:
+  explicit HashLife(const Rule &rule = Rule(), std::size_t maxNodes = (std::size_t)1 << 22);
+
+  void load(const BitGrid &board);
+  /** copies the rows x columns window whose top left cell is (0, 0) **/
+  void store(BitGrid &board) const;
+
+  /** advances the universe, one jump per set bit of generations **/
+  void advance(unsigned long long generations);
+  /** population after the given generation (since the last load); earlier
+   generations restart from the loaded board **/
+  long long populationAt(unsigned long long generation);
+
+  unsigned long long generation() const { return generationCount; }
+  long long population() const { return root->population; }
+  std::size_t nodeCount() const { return liveNodes; }
+  std::size_t collections() const { return gcCount; }
+  /**
+   ** hash of the universe, the same as a SparseLife holding the same cells.
+   ** Computed from the live cells on every call, so it costs time in proportion
+   ** to the population.
+   **/
+  uint64_t hash() const;
+  /** node blocks plus the node table **/
+  std::size_t memoryBytes() const;
+
+private:
+  HashLife(const HashLife &);
+  HashLife &operator=(const HashLife &);
+
+  LifeNode *allocate();
+  LifeNode *node(LifeNode *nw, LifeNode *ne, LifeNode *sw, LifeNode *se);
+  LifeNode *empty(int level);
+  LifeNode *centre(LifeNode *n);
+  LifeNode *baseStep(LifeNode *n);
+  LifeNode *successor(LifeNode *n);
+  LifeNode *build(const BitGrid &board, int level, long long y, long long x);
+  void extract(const LifeNode *n, long long y, long long x, BitGrid &board) const;
+  void collect(const LifeNode *n, long long y, long long x,
+               std::map<std::pair<long long, long long>, uint64_t> &words) const;
+  void expand();
+  bool padded() const;
+  void setStep(int stepLog);
+  void jump(int stepLog);
+  void rehash(std::size_t buckets);
+  void markFrom(LifeNode *n);
+  void collect();
+
+  BlockPool<LifeNode, &LifeNode::next, NODE_BLOCK> pool;
+  std::vector<LifeNode *> table;
+  std::vector<LifeNode *> emptyNodes;
+  LifeNode *dead;
+  LifeNode *alive;
+  LifeNode *root;
+  LifeNode *initialRoot;
+  long long originY, originX;
+  long long initialY, initialX;
+  unsigned long long generationCount;
+  std::size_t maxNodes;
+  std::size_t liveNodes;
+  std::size_t gcCount;
+  unsigned markStamp;
+  int step;
+  Rule rule;
+};
+
+/*********************************************************************
+ ** Class: HashLifeEngine
+ ** Description: Engine front end for HashLife. Unlike the grid engines the
+ universe has no edge: cells that leave the board keep evolving off screen
+ and may come back, and storeBits() shows the board sized window.
+ *********************************************************************/
+class HashLifeEngine : public Engine
+{
+public:
+  HashLifeEngine(int rows, int columns, const Rule &rule = Rule());
+
+  const char *name() const { return "hashlife"; }
+  void loadBits(const BitGrid &board);
+  void storeBits(BitGrid &board) const;
+  void step(long long generations);
+  long long population() const;
+  std::size_t memoryBytes() const;
+  uint64_t hash();
+  /** hashing walks every live cell and would undo the big steps **/
+  bool tracksHash() const { return false; }
+  bool unbounded() const { return true; }
+
+  HashLife &universe() { return life; }
+
+private:
+  HashLife life;
+};
+
+#endif
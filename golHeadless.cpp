@@ -0,0 +1,202 @@
+/**************************************************************************************************
+ ** Program       Filename: GameOfLife
+ ** Current       File: golHeadless.cpp
+ ** Author:       Jordan Grant
+ ** Date:         10.17.26
+ ** Description: 	Headless batch runs (see golHeadless.hpp).
+ *****************************************************************************************************/
+
+#include "golHeadless.hpp"
+#include "golCheckpoint.hpp"
+#include "golEngine.hpp"
+#include "golFrames.hpp"
+#include "golPattern.hpp"
+#include "golTemporal.hpp"
+#include "golThreadPool.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <stdexcept>
+
+#define HEADLESS_ROWS 1024
+#define HEADLESS_COLUMNS 1024
+#define HEADLESS_GENERATIONS 1000
+
+/** writes text as a JSON string literal **/
+static void writeJsonString(std::ostream &out, const std::string &text)
+{
+  out << '"';
+  for (std::size_t i = 0; i < text.size(); i++)
+  {
+    unsigned char ch = (unsigned char)text[i];
+    if (ch == '"' || ch == '\\')
+      out << '\\' << ch;
+    else if (ch < 0x20)
+    {
+      char escape[8];
+      std::snprintf(escape, sizeof(escape), "\\u%04x", ch);
+      out << escape;
+    }
+    else
+      out << ch;
+  }
+  out << '"';
+}
+
+int runHeadless(const Options &options, std::ostream &out)
+{
+  int rows = options.rows > 0 ? options.rows : HEADLESS_ROWS,
+      columns = options.columns > 0 ? options.columns : HEADLESS_COLUMNS;
+  long long generations = options.generations >= 0 ? options.generations : HEADLESS_GENERATIONS;
+  std::string pattern = options.pattern.empty() ? "soup" : options.pattern;
+
+  /** a checkpoint brings its own board size and rule, an RLE pattern may name a rule **/
+  Rule rule;
+  if (!options.rule.empty())
+    rule = Rule::parse(options.rule);
+
+  BitGrid board;
+  CheckpointInfo info;
+  if (!options.restore.empty())
+  {
+    board = loadCheckpoint(options.restore, &info);
+    if (options.rows > 0 && (info.rows != rows || info.columns != columns))
+      throw std::invalid_argument(options.restore + ": checkpoint is "
+                                  + std::to_string(info.rows) + "x" + std::to_string(info.columns)
+                                  + ", not the requested --size");
+    if (!options.rule.empty() && info.rule != rule)
+      throw std::invalid_argument(options.restore + ": checkpoint runs " + info.rule.notation()
+                                  + ", not the requested --rule");
+    rows = info.rows;
+    columns = info.columns;
+    rule = info.rule;
+    pattern = options.restore;
+  }
+  else
+  {
+    board = BitGrid(rows, columns);
+    if (pattern == "soup")
+      fillSoup(board, options.density, options.seed);
+    else
+    {
+      BitGridSink sink(board);
+      loadPattern(pattern, sink);
+      if (options.rule.empty() && !sink.patternRule().empty())
+        rule = Rule::parse(sink.patternRule());
+    }
+  }
+
+  if (!options.checkpoint.empty() && rule.states() > 2)
+    throw std::invalid_argument("--checkpoint: checkpoints cannot hold the dying states of "
+                                + rule.notation());
+  std::unique_ptr<Engine> engine = makeEngine(options.engine, rows, columns, options.threads,
+                                              options.topology, rule, options.depth);
+  if (!options.restore.empty())
+  {
+    engine->adoptBits(board);
+    engine->setGeneration(info.generation);
+  }
+  else
+    engine->loadBits(board);
+  board = BitGrid();
+
+  Simulation simulation(*engine);
+  simulation.detectCycles((std::size_t)options.cycles, CYCLE_SKIP);
+  std::unique_ptr<CheckpointWriter> writer;
+  if (!options.checkpoint.empty())
+  {
+    writer.reset(new CheckpointWriter(options.checkpoint, options.compress));
+    simulation.addObserver(writer.get(), options.checkpointEvery);
+  }
+  std::unique_ptr<FrameExporter> frames;
+  if (!options.frames.empty())
+  {
+    frames.reset(new FrameExporter(options.frames, options.frameView, rows, columns,
+                                   options.frameRate));
+    simulation.addObserver(frames.get(), options.framesEvery);
+  }
+
+  const long long startGeneration = engine->generation();
+  MemoryTraffic traffic;
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  traffic.start();
+  simulation.run(generations);
+  traffic.stop();
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  /** frames still in the ring are encoded after the clock stops **/
+  if (frames)
+    frames->close();
+
+  /** the background writer may have skipped the last generation; write it for sure **/
+  if (writer)
+  {
+    writer->flush();
+    saveCheckpoint(options.checkpoint, *engine, options.compress);
+  }
+
+  /** rates count the generations stepped; a skip to the end is not throughput **/
+  double rate = seconds > 0 ? simulation.stepped() / seconds : 0;
+  int threads = options.engine == "parallel" || options.engine == "distributed"
+                  ? (options.threads > 0 ? options.threads : hardwareThreads()) : 1;
+
+  out << "{\"engine\": ";
+  writeJsonString(out, engine->name());
+  out << ", \"threads\": " << threads
+      << ", \"topology\": \"" << topologyName(options.topology) << "\""
+      << ", \"rule\": \"" << rule.notation() << "\""
+      << ", \"rows\": " << rows << ", \"columns\": " << columns
+      << ", \"pattern\": ";
+  writeJsonString(out, pattern);
+  out << ", \"start_generation\": " << startGeneration
+      << ", \"generations\": " << generations
+      << ", \"generation\": " << engine->generation()
+      << ", \"seconds\": " << seconds
+      << ", \"generations_per_second\": " << rate
+      << ", \"cell_updates_per_second\": " << rate * rows * (double)columns
+      << ", \"population\": " << engine->population();
+
+  /** measured DRAM traffic, and what the blocked engine's passes stream by design; a
+   ** pass is only depth deep when the steps it is given are, so the depth it got is
+   ** given next to the one asked for **/
+  const double cellGenerations = (double)simulation.stepped() * rows * (double)columns;
+  out << ", \"dram_bytes_per_cell_generation\": ";
+  if (traffic.available() && cellGenerations > 0)
+    out << traffic.bytes() / cellGenerations;
+  else
+    out << "null";
+  const BlockedEngine *blocked = dynamic_cast<const BlockedEngine *>(engine.get());
+  if (blocked != NULL)
+    out << ", \"depth\": " << blocked->depth()
+        << ", \"generations_per_pass\": " << blocked->generationsPerPass()
+        << ", \"streamed_bytes_per_cell_generation\": " << blocked->bytesPerCellGeneration();
+  const CycleDetector *cycles = simulation.cycles();
+  if (cycles != NULL)
+  {
+    out << ", \"stepped_generations\": " << simulation.stepped();
+    if (cycles->found())
+      out << ", \"cycle_period\": " << cycles->period()
+          << ", \"cycle_start\": " << cycles->start();
+    else
+      out << ", \"cycle_period\": null, \"cycle_start\": null";
+  }
+  if (writer)
+    out << ", \"checkpoints_written\": " << writer->written() + 1
+        << ", \"checkpoints_skipped\": " << writer->skipped();
+  if (frames)
+  {
+    out << ", \"frames_written\": " << frames->written()
+        << ", \"frames_dropped\": " << frames->dropped()
+        << ", \"frames_subsampled\": " << frames->subsampled()
+        << ", \"frames_failed\": " << frames->failed();
+    if (frames->failed() > 0)
+    {
+      out << ", \"frames_error\": ";
+      writeJsonString(out, frames->lastError());
+    }
+  }
+  out << "}" << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,40 @@
+/************************************************************************************************
+ ** Program       Filename: GameOfLife
+ ** Current       File: golHeadless.hpp
+ ** Author:       Jordan Grant
+ ** Date:         10.17.26
+ ** Description: 	Headless batch runs for throughput work: build the engine and board the
+ options ask for, step the generations with nothing watching but an optional background
+ checkpoint writer, and report the rate as JSON.
+ **************************************************************************************************/
+
+
+#ifndef GOLHEADLESS_HPP
+#define GOLHEADLESS_HPP
+
+#include <iostream>
+#include "golOptions.hpp"
+
+/*********************************************************************
+ ** Function: Run Headless
+ ** Description: runs options.generations generations (default 1000) of
+ options.pattern (default a soup) on a rows x columns board (default
+ 1024x1024), or continues from options.restore, and writes one line of JSON:
+ {"engine": ..., "rule": ..., "generations": ..., "seconds": ...,
+  "generations_per_second": ..., "cell_updates_per_second": ...,
+  "population": ..., "cycle_period": ..., "cycle_start": ..., ...}
+ dram_bytes_per_cell_generation is the last level cache misses of the
+ stepping thread times the line size over the cells stepped, null where the
+ kernel has no counter for it; the blocked engine also reports its depth and
+ the board bytes its passes read and wrote per cell generation.
+ Only the stepping is timed; loading, the final checkpoint and encoding the
+ frames left over when the run ends (--frames) are not. Unless
+ --cycles is 0, a board that repeats is skipped ahead to the last generation;
+ cycle_period and cycle_start then say where the cycle began (null when none
+ was seen), and the rates count only the stepped_generations.
+ ** Post-Conditions: returns the exit status; throws on bad options, unreadable
+ patterns or checkpoints
+ *********************************************************************/
+int runHeadless(const Options &options, std::ostream &out);
+
+#endif
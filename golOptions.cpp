@@ -0,0 +1,236 @@
+/**************************************************************************************************
+ ** Program       Filename: GameOfLife
+ ** Current       File: golOptions.cpp
+ ** Author:       Jordan Grant
+ ** Date:         10.17.26
+ ** Description: 	Command line options (see golOptions.hpp).
+ *****************************************************************************************************/
+
+#include "golOptions.hpp"
+#include "golEngine.hpp"
+#include "golTemporal.hpp"
+
+#include <cerrno>
+#include <cstdlib>
+#include <stdexcept>
+
+static long long parseNumber(const std::string &flag, const std::string &text, long long low,
+                             long long high)
+{
+  char *end = NULL;
+  errno = 0;
+  long long value = std::strtoll(text.c_str(), &end, 10);
+
+  if (text.empty() || *end != '\0' || errno != 0 || value < low || value > high)
+    throw std::invalid_argument(flag + ": expected a whole number from " + std::to_string(low)
+                                + " to " + std::to_string(high) + ", got '" + text + "'");
+  return value;
+}
+
+/** "RxC", e.g. 1024x768 **/
+static void parseSize(const std::string &text, int &rows, int &columns)
+{
+  std::size_t x = text.find('x');
+  if (x == std::string::npos)
+    throw std::invalid_argument("--size: expected ROWSxCOLUMNS, got '" + text + "'");
+
+  rows = (int)parseNumber("--size", text.substr(0, x), 1, 1 << 30);
+  columns = (int)parseNumber("--size", text.substr(x + 1), 1, 1 << 30);
+}
+
+Options parseOptions(int argc, char *argv[])
+{
+  Options options;
+  options.headless = false;
+  options.census = false;
+  options.soups = 0;
+  options.rows = 0;
+  options.columns = 0;
+  options.generations = -1;
+  options.engine = "bit";
+  options.threads = 0;
+  options.depth = 0;
+  options.topology = TOPOLOGY_BOUNDED;
+  options.density = 0.5;
+  options.seed = 1;
+  options.checkpointEvery = 1000;
+  options.compress = false;
+  options.fps = 30;
+  options.speed = -1;
+  options.cycles = 1024;
+  options.statsEvery = 5;
+  options.traceMarkers = false;
+  options.framesEvery = 1;
+  options.frameView = fullView();
+  options.frameRate = 30;
+
+  int i = 1;
+  for (; i < argc && argv[i][0] == '-' && argv[i][1] == '-'; i++)
+  {
+    const std::string flag = argv[i];
+
+    if (flag == "--headless")
+    {
+      options.headless = true;
+      continue;
+    }
+    if (flag == "--census")
+    {
+      options.census = true;
+      continue;
+    }
+    if (flag == "--trace-markers")
+    {
+      options.traceMarkers = true;
+      continue;
+    }
+    if (flag == "--compress")
+    {
+      options.compress = true;
+      continue;
+    }
+
+    /** every other flag takes a value **/
+    static const char *const valued[] =
+    {
+      "--pattern", "--size", "--generations", "--engine", "--rule", "--threads", "--depth",
+      "--topology",
+      "--density", "--seed", "--checkpoint", "--checkpoint-every", "--restore", "--fps",
+      "--speed", "--cycles", "--soups", "--stats", "--stats-every", "--frames", "--frames-every",
+      "--crop", "--frame-scale", "--frame-rate"
+    };
+    bool known = false;
+    for (std::size_t k = 0; k < sizeof(valued) / sizeof(valued[0]); k++)
+      known = known || flag == valued[k];
+    if (!known)
+      throw std::invalid_argument("unknown option: " + flag);
+    if (i + 1 >= argc)
+      throw std::invalid_argument(flag + ": missing value");
+    const std::string value = argv[++i];
+
+    if (flag == "--pattern")
+      options.pattern = value;
+    else if (flag == "--size")
+      parseSize(value, options.rows, options.columns);
+    else if (flag == "--generations")
+      options.generations = parseNumber(flag, value, 0, 1LL << 62);
+    else if (flag == "--engine")
+      options.engine = value;
+    else if (flag == "--rule")
+    {
+      Rule::parse(value);
+      options.rule = value;
+    }
+    else if (flag == "--threads")
+      options.threads = (int)parseNumber(flag, value, 0, 4096);
+    else if (flag == "--depth")
+      options.depth = (int)parseNumber(flag, value, 0, MAX_TEMPORAL_DEPTH);
+    else if (flag == "--topology")
+      options.topology = parseTopology(value);
+    else if (flag == "--density")
+    {
+      char *end = NULL;
+      options.density = std::strtod(value.c_str(), &end);
+      if (value.empty() || *end != '\0' || !(options.density >= 0 && options.density <= 1))
+        throw std::invalid_argument("--density: expected a number from 0 to 1, got '" + value + "'");
+    }
+    else if (flag == "--fps" || flag == "--speed" || flag == "--stats-every" || flag == "--frame-rate")
+    {
+      char *end = NULL;
+      double rate = std::strtod(value.c_str(), &end);
+      if (value.empty() || *end != '\0' || !(rate >= 0 && rate <= 1e9))
+        throw std::invalid_argument(flag + ": expected a rate of 0 or more, got '" + value + "'");
+      if ((flag == "--stats-every" || flag == "--frame-rate") && rate <= 0)
+        throw std::invalid_argument(flag + ": expected a positive number of seconds, got '"
+                                    + value + "'");
+      (flag == "--fps" ? options.fps : flag == "--speed" ? options.speed
+       : flag == "--frame-rate" ? options.frameRate : options.statsEvery) = rate;
+    }
+    else if (flag == "--seed")
+      options.seed = (uint64_t)parseNumber(flag, value, 0, 1LL << 62);
+    else if (flag == "--checkpoint")
+      options.checkpoint = value;
+    else if (flag == "--checkpoint-every")
+      options.checkpointEvery = parseNumber(flag, value, 1, 1LL << 62);
+    else if (flag == "--cycles")
+      options.cycles = parseNumber(flag, value, 0, 1 << 24);
+    else if (flag == "--stats")
+      options.stats = value;
+    else if (flag == "--frames")
+    {
+      frameFormat(value);
+      options.frames = value;
+    }
+    else if (flag == "--frames-every")
+      options.framesEvery = parseNumber(flag, value, 1, 1LL << 62);
+    else if (flag == "--crop")
+      parseCrop(flag, value, options.frameView);
+    else if (flag == "--frame-scale")
+      parseFrameScale(flag, value, options.frameView);
+    else if (flag == "--soups")
+      options.soups = parseNumber(flag, value, 1, 1LL << 62);
+    else
+      options.restore = value;
+  }
+
+  /** the original positional form: rows columns [engine [bounded|torus]] **/
+  const int positional = argc - i;
+  if (positional == 1 || positional > 4)
+    throw std::invalid_argument("expected: rows columns [engine [bounded|torus]]");
+  if (positional >= 2)
+  {
+    options.rows = (int)parseNumber("rows", argv[i], 1, 1 << 30);
+    options.columns = (int)parseNumber("columns", argv[i + 1], 1, 1 << 30);
+  }
+  if (positional >= 3)
+    options.engine = argv[i + 2];
+  if (positional >= 4)
+    options.topology = parseTopology(argv[i + 3]);
+
+  return options;
+}
+
+void printUsage(std::ostream &out)
+{
+  out << "usage: GameOfLife [options] [rows columns [engine [bounded|torus]]]\n"
+         "       GameOfLife --scaling [rows columns generations threads]\n"
+         "  --headless              run without the menu or display and print a JSON report\n"
+         "  --census                run --soups random soups (10000) of --size (16x16) on\n"
+         "                          every cpu until they settle, for at most --generations\n"
+         "                          (20000), and print a JSON count of the objects left\n"
+         "  --pattern NAME|FILE     built in pattern, soup, or a .cells/.rle/.lif file\n"
+         "  --size ROWSxCOLUMNS     board size (interactive 24x44, headless 1024x1024)\n"
+         "  --generations N         generations to run (interactive 100, headless 1000)\n"
+         "  --engine NAME           char, bit, parallel, distributed, blocked, tiled, hashlife,\n"
+         "                          sparse or generations\n"
+         "  --rule RULE             B/S rule, e.g. B36/S23 or highlife (default the pattern's\n"
+         "                          or checkpoint's rule, else B3/S23); Generations rules\n"
+         "                          such as B2/S/C3 or brain need --engine generations\n"
+         "  --threads N             worker threads for the parallel engine and --census,\n"
+         "                          worker processes for distributed, 0 = one per cpu\n"
+         "  --depth K               generations the blocked engine advances per pass over the\n"
+         "                          board, 0 = as many as its rows fit in the cache (0)\n"
+         "  --topology EDGE         bounded or torus\n"
+         "  --density D --seed S    live fraction and random seed of the soup pattern\n"
+         "  --checkpoint PATH       write a checkpoint in the background while running\n"
+         "  --checkpoint-every N    generations between checkpoints (1000)\n"
+         "  --compress              zero run encode checkpoints\n"
+         "  --restore PATH          start from a checkpoint instead of a pattern\n"
+         "  --fps F                 frames drawn per second (30), 0 = every generation\n"
+         "  --speed G               generations per second (10), 0 = as fast as possible\n"
+         "  --cycles N              stop once the board repeats one of the last N generations\n"
+         "                          (1024), 0 = never; headless runs skip ahead to the end\n"
+         "  --stats PATH|unix:PATH  dump statistics as Prometheus text to a file, or serve\n"
+         "                          them on a Unix socket (builds made with make STATS=1)\n"
+         "  --stats-every S         seconds between statistics dumps (5)\n"
+         "  --trace-markers         mark each step in the kernel trace for perf (STATS=1)\n"
+         "  --frames PATH|'|CMD'    export frames in the background: frame%06d.pbm, .pgm or\n"
+         "                          .png files named by generation, or one .y4m video file\n"
+         "                          or pipe (e.g. '|ffmpeg -i - run.mp4'); frames the encoder\n"
+         "                          cannot keep up with are dropped, never waited for\n"
+         "  --frames-every N        generations between frames (1)\n"
+         "  --crop RxC+TOP+LEFT     cells to export, R or C of 0 or less stopping that many\n"
+         "                          cells short of the far edge (default the whole board)\n"
+         "  --frame-scale N|1/N     N pixels per cell, or N cells per gray pixel (1)\n"
+         "  --frame-rate F          frames per second in the y4m header (30)\n";
+}
@@ -0,0 +1,73 @@
+/************************************************************************************************
+ ** Program       Filename: GameOfLife
+ ** Current       File: golOptions.hpp
+ ** Author:       Jordan Grant
+ ** Date:         10.17.26
+ ** Description: 	Command line options. The program runs either interactively (the
+ original menu, the board redrawn at --fps while --speed generations a second go by)
+ or headless: no menu, no screen
+ and no sleeping, just the requested number of generations as fast as the engine
+ goes, followed by a one line JSON report. A census runs many random soups the same
+ way and reports what they settled into.
+ **************************************************************************************************/
+
+
+#ifndef GOLOPTIONS_HPP
+#define GOLOPTIONS_HPP
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include "golBitGrid.hpp"
+#include "golFrames.hpp"
+
+/*********************************************************************
+ ** Struct: Options
+ ** Description: everything the command line can set. rows and columns are 0
+ when not given, so each mode can pick its own default board.
+ *********************************************************************/
+struct Options
+{
+  bool headless;
+  bool census;                  // soup census instead of a single run
+  long long soups;              // census soups, 0 = default
+  std::string pattern;          // built in name, file, or "soup"
+  int rows;
+  int columns;
+  long long generations;
+  std::string engine;
+  std::string rule;             // B/S rule, empty = the pattern's or checkpoint's, else B3/S23
+  int threads;                  // 0 = one per cpu
+  int depth;                    // generations per pass of the blocked engine, 0 = automatic
+  Topology topology;
+  double density;               // soup density
+  uint64_t seed;                // soup seed
+  std::string checkpoint;       // periodic checkpoint path, empty for none
+  long long checkpointEvery;
+  bool compress;
+  std::string restore;          // checkpoint to start from, empty for none
+  double fps;                   // frames drawn per second
+  double speed;                 // generations per second, 0 = unlimited, -1 = default
+  long long cycles;             // board hashes kept to spot a repeat, 0 = no detection
+  std::string stats;            // statistics file or unix:socket, empty for none (GOL_STATS)
+  double statsEvery;            // seconds between statistics dumps
+  bool traceMarkers;            // step markers in the kernel trace (GOL_STATS)
+  std::string frames;           // frame files or y4m stream to export, empty for none
+  long long framesEvery;        // generations between exported frames
+  FrameView frameView;          // crop and scale of exported frames
+  double frameRate;             // frames per second written in a y4m header
+};
+
+/*********************************************************************
+ ** Function: Parse Options
+ ** Description: reads the command line. The original positional form,
+ GameOfLife [rows columns [engine [bounded|torus]]], is still accepted after
+ any flags.
+ ** Post-Conditions: returns the options; throws std::invalid_argument with a
+ message for unknown flags, missing values or values out of range
+ *********************************************************************/
+Options parseOptions(int argc, char *argv[]);
+
+void printUsage(std::ostream &out);
+
+#endif
@@ -0,0 +1,318 @@
+/**************************************************************************************************
+ ** Program       Filename: GameOfLife
+ ** Current       File: golOracle.cpp
+ ** Author:       Jordan Grant
+ ** Date:         10.17.26
+ ** Description: 	Reference implementation (see golOracle.hpp).
+ *****************************************************************************************************/
+
+#include "golOracle.hpp"
+#include "golCycle.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+/** the original board reads a cell past its edge as dead **/
+static bool referenceOccupied(char currentGen[ROWS][COLUMNS], int row, int column)
+{
+  if (row < 0 || row >= ROWS || column < 0 || column >= COLUMNS)
+    return false;
+  return currentGen[row][column] == 'x';
+}
+
+/*********************************************************************
+ ** Function: Reference Neighbors
+ ** Description: the original neighbors(), kept here so a change to the one in
+ golFunctions.cpp cannot change the reference with it
+ *********************************************************************/
+static int referenceNeighbors(char currentGen[ROWS][COLUMNS], int row, int column)
+{
+  int occupied = 0;
+
+  if (referenceOccupied(currentGen, row, column - 1)) // left neighbor
+    occupied++;
+  if (referenceOccupied(currentGen, row, column + 1)) // right neighbor
+    occupied++;
+  if (referenceOccupied(currentGen, row + 1, column)) // bottom neighbor
+    occupied++;
+  if (referenceOccupied(currentGen, row - 1, column)) // top neighbor
+    occupied++;
+  if (referenceOccupied(currentGen, row + 1, column + 1)) // bottom right neighbor
+    occupied++;
+  if (referenceOccupied(currentGen, row - 1, column - 1)) // top left neighbor
+    occupied++;
+  if (referenceOccupied(currentGen, row + 1, column - 1)) // bottom left neighbor
+    occupied++;
+  if (referenceOccupied(currentGen, row - 1, column + 1)) // top right neighbor
+    occupied++;
+
+  return occupied;
+}
+
+/*********************************************************************
+ ** Function: Reference Live or Die
+ ** Description: the original liveOrDie() for Conway's rules, word for word;
+ any other rule is read straight off its birth and survival counts, without
+ Rule::next() or its table
+ *********************************************************************/
+static bool referenceLiveOrDie(int n, char lod, const Rule &rule)
+{
+  if (rule.birth() != 1u << 3 || rule.survival() != (1u << 2 | 1u << 3))
+    return lod == 'x' ? (rule.survival() >> n & 1) != 0 : (rule.birth() >> n & 1) != 0;
+
+  if (n == 3 && lod == '-')      // current cell come to life?
+    return true;
+  else if (n <= 1 && lod == 'x') // current cell die of lonliness?
+    return false;
+  else if (n > 3 && lod == 'x')  // current cell die of overcrowding?
+    return false;
+  else if (lod == '-')           // current cell remain dead
+    return false;
+  else                           // current cell remain alive
+    return true;
+}
+
+void referenceUpdate(char currentGen[ROWS][COLUMNS], char nextGen[ROWS][COLUMNS], const Rule &rule)
+{
+  for (int row = 0; row < ROWS; row++)
+  {
+    for (int column = 0; column < COLUMNS; column++)
+    {
+      bool live = true;
+      char lod = currentGen[row][column];
+
+      live = referenceLiveOrDie(referenceNeighbors(currentGen, row, column), lod, rule);
+
+      if (live == true)
+        nextGen[row][column] = 'x';
+      else
+        nextGen[row][column] = '-';
+    }
+  }
+
+  for (int row = 0; row < ROWS; row++)
+    for (int column = 0; column < COLUMNS; column++)
+      currentGen[row][column] = nextGen[row][column];
+}
+
+OracleBoard::OracleBoard(int rows, int columns, int margin, const Rule &rule)
+  : rowCount(rows), columnCount(columns), margin(margin), topology(TOPOLOGY_BOUNDED), rule(rule),
+    generationCount(0), extent(0)
+{
+  if (rows <= 0 || columns <= 0 || margin < 0)
+    throw std::invalid_argument("OracleBoard: rows and columns must be positive");
+
+  cells.assign((std::size_t)(rows + 2 * margin) * (std::size_t)(columns + 2 * margin), 0);
+  nextCells = cells;
+}
+
+OracleBoard::OracleBoard(int rows, int columns, Topology topology, const Rule &rule)
+  : OracleBoard(rows, columns, 0, rule)
+{
+  this->topology = topology;
+}
+
+OracleBoard OracleBoard::unbounded(int rows, int columns, int margin, const Rule &rule)
+{
+  if (rule.states() > 2)
+    throw std::invalid_argument("OracleBoard: unbounded boards run Life-like rules only");
+  return OracleBoard(rows, columns, margin, rule);
+}
+
+OracleBoard OracleBoard::forEngine(const std::string &engine, int rows, int columns,
+                                   Topology topology, const Rule &rule, long long generations)
+{
+  if (engine == "hashlife" || engine == "sparse")
+    return unbounded(rows, columns, (int)generations + 1, rule);
+  return OracleBoard(rows, columns, topology, rule);
+}
+
+unsigned char OracleBoard::get(long long row, long long column) const
+{
+  if (row < -margin || row >= rowCount + margin || column < -margin
+      || column >= columnCount + margin)
+    return 0;
+  return cells[(std::size_t)(row + margin) * (std::size_t)(columnCount + 2 * margin)
+               + (std::size_t)(column + margin)];
+}
+
+void OracleBoard::set(long long row, long long column, unsigned char state)
+{
+  if (row < -margin || row >= rowCount + margin || column < -margin
+      || column >= columnCount + margin)
+    return;
+
+  const long long past = std::max(std::max(-row, row - (rowCount - 1)),
+                                  std::max(-column, column - (columnCount - 1)));
+  if (state != 0 && past > extent)
+    extent = (int)past;
+  cells[(std::size_t)(row + margin) * (std::size_t)(columnCount + 2 * margin)
+        + (std::size_t)(column + margin)] = state;
+}
+
+void OracleBoard::loadBits(const BitGrid &board)
+{
+  if (board.rows() != rowCount || board.columns() != columnCount)
+    throw std::invalid_argument("OracleBoard::loadBits: board dimensions differ");
+
+  cells.assign(cells.size(), 0);
+  nextCells.assign(nextCells.size(), 0);
+  extent = 0;
+  for (int row = 0; row < rowCount; row++)
+    for (int column = 0; column < columnCount; column++)
+      set(row, column, board.get(row, column) ? 1 : 0);
+  generationCount = 0;
+}
+
+void OracleBoard::load(const Grid &board)
+{
+  if (board.rows() != rowCount || board.columns() != columnCount)
+    throw std::invalid_argument("OracleBoard::load: board dimensions differ");
+
+  cells.assign(cells.size(), 0);
+  nextCells.assign(nextCells.size(), 0);
+  extent = 0;
+  for (int row = 0; row < rowCount; row++)
+    for (int column = 0; column < columnCount; column++)
+      set(row, column, board.get(row, column));
+  generationCount = 0;
+}
+
+bool OracleBoard::occupied(long long row, long long column) const
+{
+  if (topology == TOPOLOGY_TORUS)
+  {
+    row = (row % rowCount + rowCount) % rowCount;
+    column = (column % columnCount + columnCount) % columnCount;
+  }
+  return get(row, column) == 1;
+}
+
+/*********************************************************************
+ ** Function: OracleBoard::neighbors
+ ** Description: referenceNeighbors() for any board: the eight cells around
+ (row, column) looked up one at a time, in the same order
+ *********************************************************************/
+int OracleBoard::neighbors(long long row, long long column) const
+{
+  int occupiedCells = 0;
+
+  if (occupied(row, column - 1)) // left neighbor
+    occupiedCells++;
+  if (occupied(row, column + 1)) // right neighbor
+    occupiedCells++;
+  if (occupied(row + 1, column)) // bottom neighbor
+    occupiedCells++;
+  if (occupied(row - 1, column)) // top neighbor
+    occupiedCells++;
+  if (occupied(row + 1, column + 1)) // bottom right neighbor
+    occupiedCells++;
+  if (occupied(row - 1, column - 1)) // top left neighbor
+    occupiedCells++;
+  if (occupied(row + 1, column - 1)) // bottom left neighbor
+    occupiedCells++;
+  if (occupied(row - 1, column + 1)) // top right neighbor
+    occupiedCells++;
+
+  return occupiedCells;
+}
+
+/*********************************************************************
+ ** Function: OracleBoard::step
+ ** Description: the original updateGame() loop over every cell, and the margin
+ as far as cells can have spread into it, one cell further than last time.
+ Under a Generations rule a dying cell moves on one state (back to 0 after the
+ last) whatever its neighbors, and a live cell that does not survive starts
+ dying.
+ *********************************************************************/
+void OracleBoard::step()
+{
+  const int states = rule.states();
+  const int reach = extent < margin ? extent + 1 : margin;
+
+  for (long long row = -reach; row < rowCount + reach; row++)
+  {
+    for (long long column = -reach; column < columnCount + reach; column++)
+    {
+      const unsigned char state = get(row, column);
+      unsigned char next;
+
+      if (state > 1)
+        next = (unsigned char)((state + 1) % states);
+      else if (referenceLiveOrDie(neighbors(row, column), state == 1 ? 'x' : '-', rule))
+        next = 1;
+      else
+        next = state == 1 ? (unsigned char)(2 % states) : 0;
+
+      nextCells[(std::size_t)(row + margin) * (std::size_t)(columnCount + 2 * margin)
+                + (std::size_t)(column + margin)] = next;
+    }
+  }
+
+  cells.swap(nextCells);
+  extent = reach;
+  generationCount++;
+}
+
+long long OracleBoard::population() const
+{
+  long long live = 0;
+
+  for (std::size_t i = 0; i < cells.size(); i++)
+    live += cells[i] == 1;
+  return live;
+}
+
+/** the word holding column: bit i of word w is column 64 w + i, negative words included **/
+static inline long long wordOf(long long column)
+{
+  return column >= 0 ? column / WORD_BITS : -((-column + WORD_BITS - 1) / WORD_BITS);
+}
+
+uint64_t OracleBoard::hash() const
+{
+  const long long firstWord = wordOf(-extent),
+                  lastWord = wordOf(columnCount - 1 + extent);
+  std::vector<uint64_t> words((std::size_t)(lastWord - firstWord + 1));
+  uint64_t hash = 0;
+
+  for (int plane = 0; plane < rule.stateBits(); plane++)
+    for (long long row = -extent; row < rowCount + extent; row++)
+    {
+      words.assign(words.size(), 0);
+      for (long long column = -extent; column < columnCount + extent; column++)
+        if ((get(row, column) >> plane) & 1)
+        {
+          const long long word = wordOf(column);
+          words[(std::size_t)(word - firstWord)] |= (uint64_t)1 << (column - word * WORD_BITS);
+        }
+
+      const uint64_t seed = hashRowSeed(plane * rowCount + row);
+      for (std::size_t w = 0; w < words.size(); w++)
+        hash ^= hashWordKey(seed, firstWord + (long long)w, words[w]);
+    }
+  return hash;
+}
+
+std::string oracleDifference(Engine &engine, const OracleBoard &oracle)
+{
+  const std::string at = " at generation " + std::to_string(oracle.generation());
+
+  if (engine.generation() != oracle.generation())
+    return "engine is at generation " + std::to_string(engine.generation()) + at;
+  if (engine.population() != oracle.population())
+    return "population " + std::to_string(engine.population()) + " should be "
+           + std::to_string(oracle.population()) + at;
+  if (engine.hash() != oracle.hash())
+    return "hash differs" + at;
+
+  Grid board(engine.rows(), engine.columns());
+  engine.store(board);
+  for (int r = 0; r < board.rows(); r++)
+    for (int c = 0; c < board.columns(); c++)
+      if (board.get(r, c) != oracle.get(r, c))
+        return "cell (" + std::to_string(r) + ", " + std::to_string(c) + ") is "
+               + std::to_string(board.get(r, c)) + ", should be "
+               + std::to_string(oracle.get(r, c)) + at;
+  return "";
+}
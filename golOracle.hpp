@@ -0,0 +1,114 @@
+/************************************************************************************************
+ ** Program       Filename: GameOfLife
+ ** Current       File: golOracle.hpp
+ ** Author:       Jordan Grant
+ ** Date:         10.17.26
+ ** Description: 	Reference implementation the engines are checked against. It steps
+ the board the way the original program did, with none of the tricks that make the
+ engines fast: no halo, no packing, no SIMD, no threads. Every cell's eight neighbors
+ are looked up one at a time, with the edge decided on each lookup, and the original
+ liveOrDie() decides the cell. Both are private copies, so nothing golFunctions.cpp or
+ the Rule tables do can move the reference along with the engines. referenceUpdate()
+ is the original updateGame() for the classic char board. OracleBoard applies the same
+ steps to any size of board, with a bounded edge, a torus or no edge at all, and under
+ Generations rules too. It hashes its cells one by one into the golCycle.hpp hash, so
+ an engine's hash can be compared as well as its population. It is slow and is only
+ linked into the test programs.
+ **************************************************************************************************/
+
+
+#ifndef GOLORACLE_HPP
+#define GOLORACLE_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "golFunctions.hpp"
+#include "golEngine.hpp"
+
+/*********************************************************************
+ ** Function: Reference Update
+ ** Description: the original updateGame(): every cell of currentGen is given
+ to the original liveOrDie() with its neighbors() count, nextGen is filled in
+ with 'x' and '-' and then copied back to currentGen
+ ** Parameters: two 2D char arrays that are ROWSxCOLUMNS, rule (Conways by default)
+ ** Post-Conditions: both boards hold the next generation
+ *********************************************************************/
+void referenceUpdate(char currentGen[ROWS][COLUMNS], char nextGen[ROWS][COLUMNS],
+                     const Rule &rule = Rule());
+
+/*********************************************************************
+ ** Class: OracleBoard
+ ** Description: rows x columns board of cell states (0 dead, 1 alive, 2 and
+ up dying), stepped a cell at a time. A bounded board treats the cells past
+ its edge as dead and a torus wraps them around. An unbounded board stands in
+ for hashlife and sparse: it keeps margin dead cells on every side, which is
+ exact while the run is shorter than margin generations, as no cell reaches
+ more than one cell further out each generation. Cells are addressed as the
+ board's, so a margin's rows and columns are negative or past the board.
+ ** Pre-Conditions: rows and columns positive, margin 0 unless unbounded
+ *********************************************************************/
+class OracleBoard
+{
+public:
+  OracleBoard(int rows, int columns, Topology topology, const Rule &rule);
+  /** a board with no edge, good for runs of fewer than margin generations **/
+  static OracleBoard unbounded(int rows, int columns, int margin, const Rule &rule);
+  /**
+   ** the board to check the engine makeEngine() builds by that name against:
+   ** unbounded for hashlife and sparse, good for generations generations
+   **/
+  static OracleBoard forEngine(const std::string &engine, int rows, int columns,
+                               Topology topology, const Rule &rule, long long generations);
+
+  int rows() const { return rowCount; }
+  int columns() const { return columnCount; }
+  long long generation() const { return generationCount; }
+
+  /** a cell off the board (and its margin) reads as dead; setting one does nothing **/
+  unsigned char get(long long row, long long column) const;
+  void set(long long row, long long column, unsigned char state);
+
+  /** the board's rows x columns cells from a BitGrid or a Grid, the rest dead **/
+  void loadBits(const BitGrid &board);
+  void load(const Grid &board);
+
+  void step();
+  /** live cells, the margin included; dying cells do not count **/
+  long long population() const;
+  /**
+   ** hashBitGrid() of the cells, worked out a cell at a time; a Generations
+   ** board hashes like hashGrid() with the rule's stateBits() planes, and an
+   ** unbounded one like the hash of a SparseLife holding the same cells
+   **/
+  uint64_t hash() const;
+
+private:
+  OracleBoard(int rows, int columns, int margin, const Rule &rule);
+
+  /** true if the neighbor at (row, column) is alive, wrapping it on a torus **/
+  bool occupied(long long row, long long column) const;
+  int neighbors(long long row, long long column) const;
+
+  int rowCount;
+  int columnCount;
+  int margin;
+  Topology topology;
+  Rule rule;
+  long long generationCount;
+  int extent;                              // how far past the board's edge cells may live
+  std::vector<unsigned char> cells;        // the board and its margin, row by row
+  std::vector<unsigned char> nextCells;
+};
+
+/*********************************************************************
+ ** Function: Oracle Difference
+ ** Description: the first way engine differs from oracle: its generation,
+ population, hash, then the board cell by cell (dying states included; the
+ window at (0, 0) for an unbounded engine)
+ ** Post-Conditions: returns "" if they agree, else a message naming the
+ generation
+ *********************************************************************/
+std::string oracleDifference(Engine &engine, const OracleBoard &oracle);
+
+#endif
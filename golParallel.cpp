@@ -0,0 +1,184 @@
+/**************************************************************************************************
+ ** Program       Filename: GameOfLife
+ ** Current       File: golParallel.cpp
+ ** Author:       Jordan Grant
+ ** Date:         10.17.26
+ ** Description: 	Multithreaded row band stepping (see golParallel.hpp).
+ *****************************************************************************************************/
+
+#include "golParallel.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <stdexcept>
+
+ParallelStepper::ParallelStepper(int rows, int columns, int threads, bool pin,
+                                 Topology topology, const Rule &rule)
+  : pool(threads, pin), barrier(threads), current(0), topology(topology), rule(rule),
+    source(NULL), generations(0), hashDeltas((std::size_t)threads * LINE_WORDS),
+    hashing(false)
+{
+  /** buffers are not zeroed here; touchTask() lets each band fault in its own pages **/
+  grids[0] = BitGrid(rows, columns, false);
+  grids[1] = BitGrid(rows, columns, false);
+
+  bandStart.resize(threads + 1);
+  for (int i = 0; i <= threads; i++)
+    bandStart[i] = (int)((long long)rows * i / threads);
+
+  pool.run(touchTask, this);
+}
+
+/*********************************************************************
+ ** Function: ParallelStepper::touchTask
+ ** Description: each worker clears its band of both buffers; the first and
+ last bands also own the halo rows above and below the board
+ *********************************************************************/
+void ParallelStepper::touchTask(void *context, int worker)
+{
+  ParallelStepper *self = static_cast<ParallelStepper *>(context);
+  int first = self->bandStart[worker],
+      last = self->bandStart[worker + 1];
+
+  if (worker == 0)
+    first = -1;
+  if (worker == self->threads() - 1)
+    last = self->grids[0].rows() + 1;
+
+  self->grids[0].clearRows(first, last);
+  self->grids[1].clearRows(first, last);
+}
+
+void ParallelStepper::loadTask(void *context, int worker)
+{
+  ParallelStepper *self = static_cast<ParallelStepper *>(context);
+  BitGrid &target = self->grids[self->current];
+  const std::size_t bytes = target.words() * sizeof(uint64_t);
+
+  for (int r = self->bandStart[worker]; r < self->bandStart[worker + 1]; r++)
+  {
+    std::memcpy(target.row(r), self->source->row(r), bytes);
+    target.row(r)[target.words() - 1] &= target.lastWordMask();
+  }
+}
+
+/*********************************************************************
+ ** Function: ParallelStepper::stepTask
+ ** Description: steps this worker's band for every generation of the job. All
+ workers swap buffers in lock step, so no shared state changes mid job.
+ *********************************************************************/
+void ParallelStepper::stepTask(void *context, int worker)
+{
+  ParallelStepper *self = static_cast<ParallelStepper *>(context);
+  int first = self->bandStart[worker],
+      last = self->bandStart[worker + 1],
+      from = self->current;
+  uint64_t hash = 0;
+
+  for (long long g = 0; g < self->generations; g++)
+  {
+    if (self->topology == TOPOLOGY_TORUS)
+    {
+      /** every row's columns must wrap before the halo rows copy them **/
+      BitGrid &grid = self->grids[from];
+      wrapBitColumns(grid, first, last);
+      self->barrier.wait();
+      if (worker == 0)
+        wrapBitRows(grid);
+      self->barrier.wait();
+    }
+
+    stepBitRows(self->grids[from], self->grids[from ^ 1], first, last, self->rule,
+                self->hashing ? &hash : NULL);
+    self->barrier.wait();
+    from ^= 1;
+  }
+  self->hashDeltas[(std::size_t)worker * LINE_WORDS] = hash;
+}
+
+void ParallelStepper::load(const BitGrid &board)
+{
+  if (board.rows() != grids[0].rows() || board.columns() != grids[0].columns())
+    throw std::invalid_argument("ParallelStepper::load: board dimensions differ");
+
+  source = &board;
+  pool.run(loadTask, this);
+  source = NULL;
+}
+
+void ParallelStepper::store(BitGrid &board) const
+{
+  board = grids[current];
+  board.clearHalo();
+}
+
+std::size_t ParallelStepper::memoryBytes() const
+{
+  return grids[0].bufferBytes() + grids[1].bufferBytes() + bandStart.capacity() * sizeof(int)
+         + hashDeltas.capacity() * sizeof(uint64_t);
+}
+
+/*********************************************************************
+ ** Function: ParallelStepper::step
+ ** Description: the hash changes of the bands are XORed together afterwards;
+ XOR does not care which band or generation a change came from
+ *********************************************************************/
+void ParallelStepper::step(long long count, uint64_t *hash)
+{
+  if (count <= 0)
+    return;
+
+  generations = count;
+  hashing = hash != NULL;
+  pool.run(stepTask, this);
+  current ^= (int)(count & 1);
+
+  if (hash != NULL)
+    for (int worker = 0; worker < threads(); worker++)
+      *hash ^= hashDeltas[(std::size_t)worker * LINE_WORDS];
+}
+
+void reportScaling(int rows, int columns, long long generations, int maxThreads,
+                   std::ostream &out)
+{
+  BitGrid soup(rows, columns);
+  std::srand(1);
+  for (int r = 0; r < rows; r++)
+    for (int c = 0; c < columns; c++)
+      soup.set(r, c, std::rand() % 3 == 0);
+
+  std::vector<int> counts;
+  for (int t = 1; t < maxThreads; t *= 2)
+    counts.push_back(t);
+  counts.push_back(maxThreads);
+
+  out << "board " << rows << "x" << columns << ", " << generations << " generations, "
+      << hardwareThreads() << " cpus, " << simdLevelName(activeSimdLevel()) << " kernel\n"
+      << std::setw(8) << "threads" << std::setw(14) << "gens/sec"
+      << std::setw(16) << "cells/sec" << std::setw(10) << "speedup"
+      << std::setw(12) << "efficiency" << "\n";
+
+  double base = 0;
+  for (std::size_t i = 0; i < counts.size(); i++)
+  {
+    ParallelStepper stepper(rows, columns, counts[i]);
+    stepper.load(soup);
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    stepper.step(generations);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    double rate = generations / seconds;
+    if (i == 0)
+      base = rate;
+
+    out << std::setw(8) << counts[i]
+        << std::setw(14) << std::fixed << std::setprecision(1) << rate
+        << std::setw(16) << std::scientific << std::setprecision(3)
+        << rate * rows * (double)columns
+        << std::setw(10) << std::fixed << std::setprecision(2) << rate / base
+        << std::setw(11) << std::setprecision(0) << 100.0 * rate / base / counts[i] << "%\n";
+  }
+}
@@ -0,0 +1,77 @@
+/************************************************************************************************
+ ** Program       Filename: GameOfLife
+ ** Current       File: golParallel.hpp
+ ** Author:       Jordan Grant
+ ** Date:         10.17.26
+ ** Description: 	Multithreaded stepping of a bit packed board. The board is split into
+ one band of whole rows per thread. A persistent ThreadPool runs every band and the
+ threads meet at a barrier between generations. Each thread also clears and fills
+ its own rows, so with a first-touch NUMA policy a band's memory lives on the node of
+ the thread that steps it. Rows are whole cache lines, so no two threads ever write
+ the same line.
+ **************************************************************************************************/
+
+
+#ifndef GOLPARALLEL_HPP
+#define GOLPARALLEL_HPP
+
+#include <iostream>
+#include <vector>
+#include "golBitGrid.hpp"
+#include "golThreadPool.hpp"
+
+/*********************************************************************
+ ** Class: ParallelStepper
+ ** Description: owns the two generation buffers of a rows x columns board and
+ steps them with threads() workers
+ ** Pre-Conditions: rows, columns and threads must be positive. Threads beyond
+ the number of rows get no band and just take part in the barrier. On a
+ torus each generation first wraps the halo, which costs two more barriers.
+ *********************************************************************/
+class ParallelStepper
+{
+public:
+  ParallelStepper(int rows, int columns, int threads, bool pin = true,
+                  Topology topology = TOPOLOGY_BOUNDED, const Rule &rule = Rule());
+
+  int threads() const { return pool.size(); }
+
+  void load(const BitGrid &board);
+  void store(BitGrid &board) const;
+  /** hash, if not NULL, is kept up to date as stepBitRows() does **/
+  void step(long long generations, uint64_t *hash = NULL);
+
+  const BitGrid &board() const { return grids[current]; }
+  std::size_t memoryBytes() const;
+
+private:
+  static void touchTask(void *context, int worker);
+  static void loadTask(void *context, int worker);
+  static void stepTask(void *context, int worker);
+
+  ThreadPool pool;
+  Barrier barrier;
+  BitGrid grids[2];
+  int current;
+  std::vector<int> bandStart;
+  Topology topology;
+  Rule rule;
+  const BitGrid *source;
+  long long generations;
+  /** each worker's hash change, a cache line apart, when hashing **/
+  std::vector<uint64_t> hashDeltas;
+  bool hashing;
+};
+
+/*********************************************************************
+ ** Function: Report Scaling
+ ** Description: steps a random soup on a rows x columns board for the given
+ number of generations with 1, 2, 4, ... up to maxThreads threads and prints
+ a table of generations/second, speedup and parallel efficiency
+ ** Parameters: board size, generations per measurement, largest thread count,
+ stream the table is written to
+ *********************************************************************/
+void reportScaling(int rows, int columns, long long generations, int maxThreads,
+                   std::ostream &out);
+
+#endif
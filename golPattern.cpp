@@ -0,0 +1,561 @@
+/**************************************************************************************************
+ ** Program       Filename: GameOfLife
+ ** Current       File: golPattern.cpp
+ ** Author:       Jordan Grant
+ ** Date:         10.17.26
+ ** Description: 	Pattern loading (see golPattern.hpp). Each parser is a single forward
+ pass over the bytes with hand rolled number parsing; the only work per run of cells is
+ one virtual call into the sink, and the board sinks fill whole words at a time.
+ *****************************************************************************************************/
+
+#include "golPattern.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sstream>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/*
+ ** The four patterns of the original menu, laid out on the classic 24x44 board.
+ ** http://www.conwaylife.com/wiki/Pulsar
+ ** https://en.wikipedia.org/wiki/Glider_(Conway%27s_Life)
+ ** http://www.conwaylife.com/wiki/Gosper_glider_gun
+ ** http://www.conwaylife.com/wiki/Queen_bee_shuttle
+ */
+static const PatternEntry builtinPatterns[] =
+{
+  { "pulsar", "Pulsar", PATTERN_PLAINTEXT,
+    "..OOO...OOO\n"
+    "\n"
+    "O....O.O....O\n"
+    "O....O.O....O\n"
+    "O....O.O....O\n"
+    "..OOO...OOO\n"
+    "\n"
+    "..OOO...OOO\n"
+    "O....O.O....O\n"
+    "O....O.O....O\n"
+    "O....O.O....O\n"
+    "\n"
+    "..OOO...OOO\n", 6, 15 },
+
+  { "gliders", "Gliders", PATTERN_PLAINTEXT,
+    ".O.....O.....O.....O\n"
+    "..O.....O.....O.....O\n"
+    "OOO...OOO...OOO...OOO\n", 2, 5 },
+
+  { "gun", "Glider Cannon: Gosper's Glider Gun", PATTERN_PLAINTEXT,
+    "........................O\n"
+    "......................O.O\n"
+    "............OO......OO............OO\n"
+    "...........O...O....OO............OO\n"
+    "OO........O.....O...OO\n"
+    "OO........O...O.OO....O.O\n"
+    "..........O.....O.......O\n"
+    "...........O...O\n"
+    "............OO\n", 6, 4 },
+
+  { "queenbee", "Queen Bee Shuttle", PATTERN_PLAINTEXT,
+    ".........O\n"
+    ".......O.O\n"
+    "......O.O\n"
+    "OO...O..O...........OO\n"
+    "OO....O.O...........OO\n"
+    ".......O.O\n"
+    "..........O\n", 8, 11 }
+};
+
+int patternCount()
+{
+  return (int)(sizeof(builtinPatterns) / sizeof(builtinPatterns[0]));
+}
+
+const PatternEntry &patternEntry(int index)
+{
+  if (index < 0 || index >= patternCount())
+    throw std::out_of_range("patternEntry: no such pattern");
+  return builtinPatterns[index];
+}
+
+const PatternEntry *findPattern(const std::string &name)
+{
+  for (int i = 0; i < patternCount(); i++)
+    if (name == builtinPatterns[i].name)
+      return &builtinPatterns[i];
+  return NULL;
+}
+
+BoardSink::BoardSink(int rows, int columns)
+  : rowCount(rows), columnCount(columns), rowOffset(rows / 2), columnOffset(columns / 2),
+    anchored(false)
+{
+}
+
+BoardSink::BoardSink(int rows, int columns, long long row, long long column)
+  : rowCount(rows), columnCount(columns), rowOffset(row), columnOffset(column),
+    anchored(true)
+{
+}
+
+void BoardSink::size(long long height, long long width)
+{
+  if (anchored)
+    return;
+
+  rowOffset = (rowCount - height) / 2;
+  columnOffset = (columnCount - width) / 2;
+}
+
+GridSink::GridSink(Grid &grid)
+  : BoardSink(grid.rows(), grid.columns()), target(grid)
+{
+}
+
+GridSink::GridSink(Grid &grid, long long row, long long column)
+  : BoardSink(grid.rows(), grid.columns(), row, column), target(grid)
+{
+}
+
+void GridSink::run(long long row, long long first, long long last)
+{
+  if (place(row, first, last))
+    std::memset(target.row((int)row) + first, 1, last - first);
+}
+
+BitGridSink::BitGridSink(BitGrid &grid)
+  : BoardSink(grid.rows(), grid.columns()), target(grid)
+{
+}
+
+BitGridSink::BitGridSink(BitGrid &grid, long long row, long long column)
+  : BoardSink(grid.rows(), grid.columns(), row, column), target(grid)
+{
+}
+
+void BitGridSink::run(long long row, long long first, long long last)
+{
+  if (!place(row, first, last))
+    return;
+
+  uint64_t *words = target.row((int)row);
+  long long firstWord = first / WORD_BITS,
+      lastWord = (last - 1) / WORD_BITS;
+  uint64_t head = ~(uint64_t)0 << (first % WORD_BITS),
+           tail = ~(uint64_t)0 >> (WORD_BITS - 1 - (last - 1) % WORD_BITS);
+
+  if (firstWord == lastWord)
+  {
+    words[firstWord] |= head & tail;
+    return;
+  }
+
+  words[firstWord] |= head;
+  for (int w = firstWord + 1; w < lastWord; w++)
+    words[w] = ~(uint64_t)0;
+  words[lastWord] |= tail;
+}
+
+MappedFile::MappedFile(const std::string &path)
+  : address(NULL), length(0)
+{
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+    throw std::runtime_error(path + ": " + std::strerror(errno));
+
+  struct stat status;
+  if (fstat(fd, &status) != 0)
+  {
+    int error = errno;
+    close(fd);
+    throw std::runtime_error(path + ": " + std::strerror(error));
+  }
+
+  length = (std::size_t)status.st_size;
+  if (length > 0)
+  {
+    address = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (address == MAP_FAILED)
+    {
+      int error = errno;
+      close(fd);
+      address = NULL;
+      throw std::runtime_error(path + ": " + std::strerror(error));
+    }
+    /** one front to back pass: let the kernel read ahead aggressively **/
+    madvise(address, length, MADV_SEQUENTIAL);
+  }
+  close(fd);
+}
+
+MappedFile::~MappedFile()
+{
+  if (address != NULL)
+    munmap(address, length);
+}
+
+/** throws std::invalid_argument naming the offending line **/
+static void parseError(long long line, const char *what)
+{
+  std::ostringstream message;
+  message << "pattern line " << line << ": " << what;
+  throw std::invalid_argument(message.str());
+}
+
+static const char *endOfLine(const char *p, const char *end)
+{
+  const char *newline = static_cast<const char *>(std::memchr(p, '\n', end - p));
+  return newline != NULL ? newline : end;
+}
+
+static inline bool isBlank(char ch)
+{
+  return ch == ' ' || ch == '\t' || ch == '\r';
+}
+
+/** parses an optionally signed decimal at p, advancing p; false if there is none **/
+static bool parseInteger(const char *&p, const char *end, long long &value)
+{
+  bool negative = false;
+
+  if (p < end && (*p == '-' || *p == '+'))
+    negative = *p++ == '-';
+  if (p >= end || *p < '0' || *p > '9')
+    return false;
+
+  value = 0;
+  for (; p < end && *p >= '0' && *p <= '9'; p++)
+  {
+    if (value > 100000000000000000LL)
+      return false;
+    value = value * 10 + (*p - '0');
+  }
+  if (negative)
+    value = -value;
+  return true;
+}
+
+PatternFormat detectPatternFormat(const char *begin, const char *end)
+{
+  static const char life106[] = "#Life 1.06";
+  const std::size_t tagLength = sizeof(life106) - 1;
+
+  if ((std::size_t)(end - begin) >= tagLength && std::memcmp(begin, life106, tagLength) == 0)
+    return PATTERN_LIFE106;
+
+  for (const char *p = begin; p < end; p = endOfLine(p, end) + 1)
+  {
+    while (p < end && (isBlank(*p) || *p == '\n'))
+      p++;
+    if (p >= end || *p == '#')
+      continue;
+    return *p == 'x' ? PATTERN_RLE : PATTERN_PLAINTEXT;
+  }
+  return PATTERN_PLAINTEXT;
+}
+
+/*********************************************************************
+ ** Function: Parse Plaintext
+ ** Description: '!' lines are comments, every other line is one row with '.'
+ dead and 'O' (or '*') alive. A first pass over the line ends finds the
+ bounding box so the sink can place the pattern before any cells arrive.
+ *********************************************************************/
+static void parsePlaintext(const char *begin, const char *end, PatternSink &sink)
+{
+  long long height = 0, width = 0;
+
+  for (const char *p = begin; p < end;)
+  {
+    const char *eol = endOfLine(p, end);
+    if (*p != '!')
+    {
+      const char *last = eol;
+      while (last > p && isBlank(last[-1]))
+        last--;
+      height++;
+      if (last - p > width)
+        width = last - p;
+    }
+    p = eol + 1;
+  }
+  sink.size(height, width);
+
+  long long line = 0, row = 0;
+  for (const char *p = begin; p < end;)
+  {
+    const char *eol = endOfLine(p, end);
+    line++;
+    if (*p == '!')
+    {
+      p = eol + 1;
+      continue;
+    }
+
+    for (const char *c = p; c < eol;)
+    {
+      if (*c == 'O' || *c == '*')
+      {
+        const char *start = c;
+        while (c < eol && (*c == 'O' || *c == '*'))
+          c++;
+        sink.run(row, start - p, c - start);
+      }
+      else if (*c == '.' || isBlank(*c))
+        c++;
+      else
+        parseError(line, "unexpected character in plaintext pattern");
+    }
+
+    row++;
+    p = eol + 1;
+  }
+}
+
+/*********************************************************************
+ ** Function: Parse RLE
+ ** Description: "#" comment lines, an optional "x = W, y = H, rule = ..."
+ header, then <count><tag> items: b or . dead, o or A-X alive, $ ends a row,
+ ! ends the pattern. Whitespace and line breaks may appear anywhere between
+ items. The header's rule is handed to the sink unchecked, up to any ":" (a
+ Golly bounded grid suffix).
+ *********************************************************************/
+static void parseRle(const char *p, const char *end, PatternSink &sink)
+{
+  long long line = 1;
+
+  while (p < end)
+  {
+    if (*p == '#')
+      p = endOfLine(p, end);
+    else if (*p == '\n')
+    {
+      line++;
+      p++;
+    }
+    else if (isBlank(*p))
+      p++;
+    else
+      break;
+  }
+
+  if (p < end && *p == 'x')
+  {
+    const char *eol = endOfLine(p, end);
+    long long width = -1, height = -1;
+
+    while (p < eol)
+    {
+      const char *key = p;
+      while (p < eol && *p >= 'a' && *p <= 'z')
+        p++;
+      const std::size_t keyLength = p - key;
+      while (p < eol && isBlank(*p))
+        p++;
+      if (p < eol && *p == '=')
+      {
+        p++;
+        while (p < eol && isBlank(*p))
+          p++;
+        if (keyLength == 1 && (*key == 'x' || *key == 'y'))
+        {
+          if (!parseInteger(p, eol, *key == 'x' ? width : height))
+            parseError(line, "bad size in RLE header");
+        }
+        else if (keyLength == 4 && std::memcmp(key, "rule", 4) == 0)
+        {
+          const char *value = p;
+          while (p < eol && *p != ',' && *p != ':' && !isBlank(*p))
+            p++;
+          sink.rule(std::string(value, p));
+        }
+      }
+      while (p < eol && *p != ',')
+        p++;
+      while (p < eol && (*p == ',' || isBlank(*p)))
+        p++;
+    }
+    if (width < 0 || height < 0)
+      parseError(line, "RLE header needs x and y");
+
+    sink.size(height, width);
+    p = eol;
+  }
+
+  long long row = 0, column = 0;
+  while (p < end)
+  {
+    /** the count is read in its own loop so the common tags come first below **/
+    long long n = 1;
+    if (*p >= '0' && *p <= '9')
+    {
+      n = *p++ - '0';
+      while (p < end && *p >= '0' && *p <= '9')
+      {
+        if (n > 100000000000000LL)
+          parseError(line, "run count too large");
+        n = n * 10 + (*p++ - '0');
+      }
+      if (p >= end)
+        break;
+    }
+
+    char ch = *p++;
+    if (ch == 'o')
+    {
+      sink.run(row, column, n);
+      column += n;
+    }
+    else if (ch == 'b' || ch == '.')
+      column += n;
+    else if (ch == '$')
+    {
+      row += n;
+      column = 0;
+    }
+    else if (ch == '!')
+      return;
+    else if (ch == '\n')
+      line++;
+    else if (ch == '#')
+      p = endOfLine(p, end);
+    else if (ch >= 'A' && ch <= 'X')
+    {
+      sink.run(row, column, n);
+      column += n;
+    }
+    else if (!isBlank(ch))
+      parseError(line, "unexpected character in RLE pattern");
+  }
+}
+
+/*********************************************************************
+ ** Function: Parse Life 1.06
+ ** Description: "#" lines are comments, every other line is "x y" for one
+ live cell, x the column and y the row. Consecutive cells of a row are
+ merged into a single run.
+ *********************************************************************/
+static void parseLife106(const char *p, const char *end, PatternSink &sink)
+{
+  long long line = 0, runRow = 0, runColumn = 0, runLength = 0;
+
+  while (p < end)
+  {
+    const char *eol = endOfLine(p, end);
+    line++;
+
+    while (p < eol && isBlank(*p))
+      p++;
+    if (p < eol && *p != '#')
+    {
+      long long x, y;
+      if (!parseInteger(p, eol, x))
+        parseError(line, "expected a column");
+      while (p < eol && isBlank(*p))
+        p++;
+      if (!parseInteger(p, eol, y))
+        parseError(line, "expected a row");
+
+      if (runLength > 0 && y == runRow && x == runColumn + runLength)
+        runLength++;
+      else
+      {
+        if (runLength > 0)
+          sink.run(runRow, runColumn, runLength);
+        runRow = y;
+        runColumn = x;
+        runLength = 1;
+      }
+    }
+    p = eol + 1;
+  }
+
+  if (runLength > 0)
+    sink.run(runRow, runColumn, runLength);
+}
+
+void parsePattern(PatternFormat format, const char *begin, const char *end, PatternSink &sink)
+{
+  switch (format)
+  {
+    case PATTERN_PLAINTEXT:
+      parsePlaintext(begin, end, sink);
+      break;
+    case PATTERN_RLE:
+      parseRle(begin, end, sink);
+      break;
+    case PATTERN_LIFE106:
+      parseLife106(begin, end, sink);
+      break;
+  }
+}
+
+void loadPattern(const PatternEntry &entry, PatternSink &sink)
+{
+  parsePattern(entry.format, entry.text, entry.text + std::strlen(entry.text), sink);
+}
+
+void loadPatternFile(const std::string &path, PatternSink &sink)
+{
+  MappedFile file(path);
+
+  parsePattern(detectPatternFormat(file.begin(), file.end()), file.begin(), file.end(), sink);
+}
+
+void loadPattern(const std::string &name, PatternSink &sink)
+{
+  const PatternEntry *entry = findPattern(name);
+
+  if (entry != NULL)
+    loadPattern(*entry, sink);
+  else
+    loadPatternFile(name, sink);
+}
+
+uint64_t nextRandom(uint64_t &state)
+{
+  uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  return z ^ (z >> 31);
+}
+
+/*********************************************************************
+ ** Function: Fill Soup
+ ** Description: builds 64 cells at a time from the binary digits of density,
+ least significant first: OR with a random word for a 1 digit, AND for a 0.
+ Every bit then ends up set with probability exactly density (rounded to
+ 16 binary digits), for 16 random words per 64 cells.
+ *********************************************************************/
+void fillSoup(BitGrid &board, double density, uint64_t seed)
+{
+  const int digits = 16;
+  uint64_t state = seed;
+  unsigned threshold;
+
+  if (density <= 0)
+    threshold = 0;
+  else if (density >= 1)
+    threshold = 1u << digits;
+  else
+    threshold = (unsigned)(density * (1u << digits) + 0.5);
+
+  board.clear();
+  for (int r = 0; r < board.rows(); r++)
+  {
+    uint64_t *words = board.row(r);
+    for (std::size_t w = 0; w < board.words(); w++)
+    {
+      uint64_t cells = 0;
+      if (threshold >= (1u << digits))
+        cells = ~(uint64_t)0;
+      else
+        for (int d = 0; d < digits; d++)
+          cells = (threshold >> d) & 1 ? cells | nextRandom(state) : cells & nextRandom(state);
+      words[w] = cells;
+    }
+    words[board.words() - 1] &= board.lastWordMask();
+  }
+}
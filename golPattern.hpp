@@ -0,0 +1,197 @@
+/************************************************************************************************
+ ** Program       Filename: GameOfLife
+ ** Current       File: golPattern.hpp
+ ** Author:       Jordan Grant
+ ** Date:         10.17.26
+ ** Description: 	Pattern loading. Files in the plaintext (.cells), RLE (.rle) and Life 1.06
+ (.lif) formats are memory mapped and parsed in place: the parsers walk the mapped
+ bytes once and hand each horizontal run of live cells to a PatternSink, so nothing is
+ allocated per cell or per line. The built in patterns are plaintext strings kept in
+ the same registry and go through the same parser.
+ **************************************************************************************************/
+
+
+#ifndef GOLPATTERN_HPP
+#define GOLPATTERN_HPP
+
+#include <cstddef>
+#include <string>
+#include "golGrid.hpp"
+#include "golBitGrid.hpp"
+
+enum PatternFormat
+{
+  PATTERN_PLAINTEXT,
+  PATTERN_RLE,
+  PATTERN_LIFE106
+};
+
+/*********************************************************************
+ ** Class: PatternSink
+ ** Description: receives a parsed pattern. size() is called once, before any
+ cells, by formats that know their bounding box (plaintext and RLE); Life 1.06
+ never calls it and its coordinates are relative to the pattern's centre.
+ rule() passes on the rule an RLE header names, as written ("B36/S23").
+ run() reports length live cells starting at (row, column) going right.
+ *********************************************************************/
+class PatternSink
+{
+public:
+  virtual ~PatternSink() {}
+
+  virtual void size(long long height, long long width) {}
+  virtual void rule(const std::string &notation) {}
+  virtual void run(long long row, long long column, long long length) = 0;
+};
+
+/*********************************************************************
+ ** Class: BoardSink
+ ** Description: base of the sinks that write into a board. By default the
+ pattern is centred on the board; the anchored constructor puts the pattern's
+ top left cell at (row, column) instead. Cells off the board are dropped.
+ patternRule() is the rule the pattern named, empty if it named none.
+ *********************************************************************/
+class BoardSink : public PatternSink
+{
+public:
+  BoardSink(int rows, int columns);
+  BoardSink(int rows, int columns, long long row, long long column);
+
+  void size(long long height, long long width);
+  void rule(const std::string &notation) { ruleText = notation; }
+
+  const std::string &patternRule() const { return ruleText; }
+
+protected:
+  /**
+   ** takes a run as (row, column, length) and turns it into board columns
+   ** [first, last) of row; false if none of it lands on the board
+   **/
+  bool place(long long &row, long long &first, long long &last) const
+  {
+    row += rowOffset;
+    first += columnOffset;
+    last += first;
+    if (row < 0 || row >= rowCount)
+      return false;
+    if (first < 0)
+      first = 0;
+    if (last > columnCount)
+      last = columnCount;
+    return first < last;
+  }
+
+private:
+  int rowCount, columnCount;
+  long long rowOffset, columnOffset;
+  bool anchored;
+  std::string ruleText;
+};
+
+class GridSink : public BoardSink
+{
+public:
+  explicit GridSink(Grid &grid);
+  GridSink(Grid &grid, long long row, long long column);
+
+  void run(long long row, long long column, long long length);
+
+private:
+  Grid &target;
+};
+
+class BitGridSink : public BoardSink
+{
+public:
+  explicit BitGridSink(BitGrid &grid);
+  BitGridSink(BitGrid &grid, long long row, long long column);
+
+  void run(long long row, long long column, long long length);
+
+private:
+  BitGrid &target;
+};
+
+/*********************************************************************
+ ** Class: MappedFile
+ ** Description: read only private mapping of a whole file
+ ** Pre-Conditions: throws std::runtime_error if the file cannot be opened or
+ mapped. An empty file maps to an empty range.
+ *********************************************************************/
+class MappedFile
+{
+public:
+  explicit MappedFile(const std::string &path);
+  ~MappedFile();
+
+  const char *begin() const { return static_cast<const char *>(address); }
+  const char *end() const { return begin() + length; }
+  std::size_t size() const { return length; }
+
+private:
+  MappedFile(const MappedFile &);
+  MappedFile &operator=(const MappedFile &);
+
+  void *address;
+  std::size_t length;
+};
+
+/*********************************************************************
+ ** Struct: PatternEntry
+ ** Description: one built in pattern. row and column anchor its top left cell
+ on the classic ROWSxCOLUMNS board.
+ *********************************************************************/
+struct PatternEntry
+{
+  const char *name;
+  const char *title;
+  PatternFormat format;
+  const char *text;
+  int row, column;
+};
+
+int patternCount();
+const PatternEntry &patternEntry(int index);
+/** returns NULL if no built in pattern has that name **/
+const PatternEntry *findPattern(const std::string &name);
+
+/*********************************************************************
+ ** Function: Detect Pattern Format
+ ** Description: tells the formats apart by their first line: "#Life 1.06",
+ an RLE "x = " header (after any # comment lines), anything else is plaintext
+ *********************************************************************/
+PatternFormat detectPatternFormat(const char *begin, const char *end);
+
+/*********************************************************************
+ ** Function: Parse Pattern
+ ** Description: parses [begin, end) in the given format into sink
+ ** Pre-Conditions: throws std::invalid_argument, naming the line, on malformed
+ input
+ *********************************************************************/
+void parsePattern(PatternFormat format, const char *begin, const char *end, PatternSink &sink);
+
+void loadPattern(const PatternEntry &entry, PatternSink &sink);
+void loadPatternFile(const std::string &path, PatternSink &sink);
+
+/*********************************************************************
+ ** Function: Load Pattern (by name)
+ ** Description: loads the built in pattern called name, or failing that the
+ pattern file at that path
+ *********************************************************************/
+void loadPattern(const std::string &name, PatternSink &sink);
+
+/*********************************************************************
+ ** Function: Next Random
+ ** Description: splitmix64 step; a small, fast generator whose whole state
+ is the one word, so a run is reproduced exactly from its seed
+ *********************************************************************/
+uint64_t nextRandom(uint64_t &state);
+
+/*********************************************************************
+ ** Function: Fill Soup
+ ** Description: replaces the board with random cells, each alive with
+ probability density (in steps of 1/65536), reproducibly from seed
+ *********************************************************************/
+void fillSoup(BitGrid &board, double density, uint64_t seed);
+
+#endif
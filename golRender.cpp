@@ -0,0 +1,377 @@
+/**************************************************************************************************
+ ** Program       Filename: GameOfLife
+ ** Current       File: golRender.cpp
+ ** Author:       Jordan Grant
+ ** Date:         10.17.26
+ ** Description: 	Terminal display (see golRender.hpp).
+ *****************************************************************************************************/
+
+#include "golRender.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <sys/ioctl.h>
+#include <thread>
+#include <unistd.h>
+
+/** longest cursor move: ESC [ row ; column H **/
+#define MOVE_BYTES 16
+/** characters the viewport moves per pan key **/
+#define PAN_STEP 4
+#define MAX_ZOOM (1 << 20)
+
+TerminalRenderer::TerminalRenderer(int fd)
+  : fd(fd), screenRows(0), screenColumns(0), viewTop(0), viewLeft(0), scale(1), used(0),
+    frameBytes(0), clearFirst(true)
+{
+  resize(0, 0);
+}
+
+void TerminalRenderer::resize(int rows, int columns)
+{
+  if (rows <= 0 || columns <= 0)
+  {
+    struct winsize size;
+    if (ioctl(fd, TIOCGWINSZ, &size) == 0 && size.ws_row > 0 && size.ws_col > 0)
+    {
+      rows = size.ws_row;
+      columns = size.ws_col;
+    }
+    else
+    {
+      rows = 24;
+      columns = 80;
+    }
+  }
+  screenRows = rows < 2 ? 2 : rows;
+  screenColumns = columns;
+
+  /** worst case: every cell needs its own cursor move, plus clear and status line **/
+  const std::size_t cells = (std::size_t)(screenRows - 1) * screenColumns;
+  shown.assign(cells, 0);
+  frame.resize(cells * (MOVE_BYTES + 1) + screenColumns + 4 * MOVE_BYTES);
+  invalidate();
+}
+
+void TerminalRenderer::fit(int boardRows, int boardColumns)
+{
+  const long long viewRows = screenRows - 1;
+
+  scale = 1;
+  while (scale < MAX_ZOOM && (boardRows > viewRows * scale || boardColumns > (long long)screenColumns * scale))
+    scale *= 2;
+
+  viewTop = (boardRows - viewRows * scale) / 2;
+  viewLeft = (boardColumns - (long long)screenColumns * scale) / 2;
+}
+
+void TerminalRenderer::pan(int rows, int columns)
+{
+  viewTop += (long long)rows * scale;
+  viewLeft += (long long)columns * scale;
+}
+
+/** zooming keeps the board cell at the centre of the screen where it is **/
+void TerminalRenderer::zoomIn()
+{
+  if (scale == 1)
+    return;
+
+  long long centreRow = viewTop + (long long)(screenRows - 1) * scale / 2,
+            centreColumn = viewLeft + (long long)screenColumns * scale / 2;
+  scale /= 2;
+  viewTop = centreRow - (long long)(screenRows - 1) * scale / 2;
+  viewLeft = centreColumn - (long long)screenColumns * scale / 2;
+}
+
+void TerminalRenderer::zoomOut()
+{
+  if (scale >= MAX_ZOOM)
+    return;
+
+  long long centreRow = viewTop + (long long)(screenRows - 1) * scale / 2,
+            centreColumn = viewLeft + (long long)screenColumns * scale / 2;
+  scale *= 2;
+  viewTop = centreRow - (long long)(screenRows - 1) * scale / 2;
+  viewLeft = centreColumn - (long long)screenColumns * scale / 2;
+}
+
+void TerminalRenderer::invalidate()
+{
+  std::fill(shown.begin(), shown.end(), 0);
+  shownStatus.clear();
+  clearFirst = true;
+}
+
+/*********************************************************************
+ ** Function: TerminalRenderer::glyph
+ ** Description: character for the scale x scale block of cells whose top left
+ cell is (row, column): live or dead at zoom 1, otherwise a density step
+ over the part of the block that is on the board
+ *********************************************************************/
+char TerminalRenderer::glyph(const BitGrid &board, long long row, long long column) const
+{
+  long long firstRow = row < 0 ? 0 : row,
+            lastRow = row + scale < board.rows() ? row + scale : board.rows(),
+            firstColumn = column < 0 ? 0 : column,
+            lastColumn = column + scale < board.columns() ? column + scale : board.columns();
+
+  if (firstRow >= lastRow || firstColumn >= lastColumn)
+    return OFF_BOARD_GLYPH;
+  if (scale == 1)
+    return board.get((int)row, (int)column) ? LIVE_GLYPH : DEAD_GLYPH;
+
+  long long live = 0;
+  for (long long r = firstRow; r < lastRow; r++)
+    live += countBitRange(board.row((int)r), firstColumn, lastColumn);
+  if (live == 0)
+    return DEAD_GLYPH;
+
+  static const char density[] = DENSITY_GLYPHS;
+  const long long steps = sizeof(density) - 1,
+                  area = (lastRow - firstRow) * (lastColumn - firstColumn);
+  return density[(live * steps - 1) / area];
+}
+
+void TerminalRenderer::append(const char *text, std::size_t length)
+{
+  std::memcpy(&frame[used], text, length);
+  used += length;
+}
+
+void TerminalRenderer::moveTo(int row, int column)
+{
+  char move[MOVE_BYTES];
+  int length = std::snprintf(move, sizeof(move), "\x1b[%d;%dH", row + 1, column + 1);
+  append(move, (std::size_t)length);
+}
+
+/*********************************************************************
+ ** Function: TerminalRenderer::render
+ ** Description: builds the changes since the last frame in the frame buffer,
+ moving the cursor only when the next changed cell is not where it already
+ is, and sends them with one write()
+ *********************************************************************/
+void TerminalRenderer::render(const BitGrid &board, const std::string &status)
+{
+  const int viewRows = screenRows - 1;
+  int cursorRow = -1, cursorColumn = -1;
+
+  used = 0;
+  if (clearFirst)
+  {
+    append("\x1b[H\x1b[2J", 7);
+    std::fill(shown.begin(), shown.end(), OFF_BOARD_GLYPH);
+    clearFirst = false;
+  }
+
+  for (int r = 0; r < viewRows; r++)
+  {
+    char *onScreen = &shown[(std::size_t)r * screenColumns];
+    for (int c = 0; c < screenColumns; c++)
+    {
+      char next = glyph(board, viewTop + (long long)r * scale, viewLeft + (long long)c * scale);
+      if (onScreen[c] == next)
+        continue;
+
+      if (r != cursorRow || c != cursorColumn)
+        moveTo(r, c);
+      frame[used++] = next;
+      onScreen[c] = next;
+      cursorRow = r;
+      cursorColumn = c + 1;
+    }
+  }
+
+  if (status != shownStatus)
+  {
+    moveTo(viewRows, 0);
+    append(status.data(), status.size() < (std::size_t)screenColumns ? status.size()
+                                                                      : (std::size_t)screenColumns);
+    append("\x1b[K", 3);
+    shownStatus = status;
+  }
+
+  frameBytes = used;
+  for (std::size_t done = 0; done < used;)
+  {
+    ssize_t written = write(fd, &frame[done], used - done);
+    if (written < 0 && errno != EINTR)
+      break;
+    if (written > 0)
+      done += (std::size_t)written;
+  }
+}
+
+TerminalDisplay::TerminalDisplay(Simulation &simulation, double framesPerSecond,
+                                 double generationsPerSecond)
+  : simulation(simulation), renderer(STDOUT_FILENO),
+    frameInterval(framesPerSecond > 0
+                    ? std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                        std::chrono::duration<double>(1.0 / framesPerSecond))
+                    : std::chrono::steady_clock::duration::zero()),
+    generationRate(generationsPerSecond), runStartGeneration(0), rawInput(false),
+    fitted(false), boardRows(0), boardColumns(0)
+{
+}
+
+TerminalDisplay::~TerminalDisplay()
+{
+  if (rawInput)
+    tcsetattr(STDIN_FILENO, TCSANOW, &savedTerminal);
+}
+
+/*********************************************************************
+ ** Function: TerminalDisplay::open
+ ** Description: starts a run: hides the cursor, puts the keyboard in
+ non-blocking, unechoed mode (if it is a terminal) and draws the first frame
+ *********************************************************************/
+void TerminalDisplay::open(const Engine &engine)
+{
+  renderer.resize(0, 0);
+  if (!fitted || boardRows != engine.rows() || boardColumns != engine.columns())
+  {
+    boardRows = engine.rows();
+    boardColumns = engine.columns();
+    renderer.fit(boardRows, boardColumns);
+    fitted = true;
+  }
+
+  if (!rawInput && isatty(STDIN_FILENO) && tcgetattr(STDIN_FILENO, &savedTerminal) == 0)
+  {
+    struct termios raw = savedTerminal;
+    raw.c_lflag &= ~(ICANON | ECHO);
+    raw.c_cc[VMIN] = 0;
+    raw.c_cc[VTIME] = 0;
+    rawInput = tcsetattr(STDIN_FILENO, TCSANOW, &raw) == 0;
+  }
+
+  if (write(STDOUT_FILENO, "\x1b[?25l", 6) < 0)
+    return;
+  runStart = std::chrono::steady_clock::now();
+  runStartGeneration = engine.generation();
+  nextFrame = runStart;
+}
+
+void TerminalDisplay::close(const Engine &engine)
+{
+  draw(engine);
+
+  if (write(STDOUT_FILENO, "\x1b[?25h\r\n", 8) < 0)
+    return;
+  if (rawInput)
+  {
+    tcsetattr(STDIN_FILENO, TCSANOW, &savedTerminal);
+    rawInput = false;
+  }
+}
+
+void TerminalDisplay::observe(const Engine &engine)
+{
+  pollKeys();
+
+  std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+  if (generationRate > 0)
+  {
+    std::chrono::steady_clock::time_point due = runStart
+      + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+          std::chrono::duration<double>((engine.generation() - runStartGeneration) / generationRate));
+    if (now < due)
+    {
+      std::this_thread::sleep_until(due);
+      now = due;
+    }
+  }
+
+  if (now < nextFrame)
+    return;
+
+  draw(engine);
+  nextFrame += frameInterval;
+  if (nextFrame < now)
+    nextFrame = now + frameInterval;
+}
+
+void TerminalDisplay::draw(const Engine &engine)
+{
+  char status[160];
+
+  engine.storeBits(board);
+  std::snprintf(status, sizeof(status),
+                "generation %lld  population %lld  zoom 1:%d  arrows/wasd pan  +/- zoom  f fit  q quit",
+                engine.generation(), engine.population(), renderer.zoom());
+  renderer.render(board, status);
+}
+
+void TerminalDisplay::pollKeys()
+{
+  if (!rawInput)
+    return;
+
+  char keys[32];
+  ssize_t count = read(STDIN_FILENO, keys, sizeof(keys));
+  for (ssize_t i = 0; i < count; i++)
+  {
+    char key = keys[i];
+
+    /**
+     ** arrow keys arrive as ESC [ A..D; any other escape sequence (Home, End,
+     ** F keys, ESC O forms, mouse reports ESC [ M and three bytes) is skipped
+     ** whole, so none of its bytes reads as a key
+     **/
+    if (key == '\x1b' && i + 1 < count && keys[i + 1] == 'O')
+    {
+      i += 2;
+      continue;
+    }
+    if (key == '\x1b' && i + 1 < count && keys[i + 1] == '[')
+    {
+      ssize_t last = i + 2;
+      while (last < count && keys[last] >= 0x20 && keys[last] <= 0x3f)
+        last++;
+      if (last >= count)
+        break;
+
+      const char final = keys[last];
+      const bool arrow = last == i + 2 && final >= 'A' && final <= 'D';
+      if (final == 'M' && last == i + 2)
+        last += 3;
+      i = last;
+      if (!arrow)
+        continue;
+      key = "wsda"[final - 'A'];
+    }
+
+    switch (key)
+    {
+      case 'w':
+        renderer.pan(-PAN_STEP, 0);
+        break;
+      case 's':
+        renderer.pan(PAN_STEP, 0);
+        break;
+      case 'a':
+        renderer.pan(0, -PAN_STEP);
+        break;
+      case 'd':
+        renderer.pan(0, PAN_STEP);
+        break;
+      case '+':
+      case '=':
+        renderer.zoomIn();
+        break;
+      case '-':
+      case '_':
+        renderer.zoomOut();
+        break;
+      case 'f':
+        renderer.fit(boardRows, boardColumns);
+        break;
+      case 'q':
+        simulation.stop();
+        break;
+    }
+  }
+}
@@ -0,0 +1,115 @@
+/************************************************************************************************
+ ** Program       Filename: GameOfLife
+ ** Current       File: golRender.hpp
+ ** Author:       Jordan Grant
+ ** Date:         10.17.26
+ ** Description: 	Terminal display. TerminalRenderer remembers which glyph is on every
+ screen cell and, for each frame, writes only the cells that changed, jumping the cursor
+ with ANSI escapes, into one buffer allocated up front, then hands it to the terminal
+ in a single write(). The viewport can be panned and zoomed out by powers of two; a
+ zoomed out character shows how full its block of cells is. TerminalDisplay drives it
+ from a Simulation with frame pacing of its own: the simulation may run far faster than
+ frames are drawn (or be held to a set generation rate), and keys pan, zoom and quit.
+ **************************************************************************************************/
+
+
+#ifndef GOLRENDER_HPP
+#define GOLRENDER_HPP
+
+#include <chrono>
+#include <string>
+#include <termios.h>
+#include <vector>
+#include "golBitGrid.hpp"
+#include "golEngine.hpp"
+
+#define LIVE_GLYPH 'x'
+#define DEAD_GLYPH '-'
+#define OFF_BOARD_GLYPH ' '
+/** zoomed out blocks, emptiest to fullest; an empty block is DEAD_GLYPH **/
+#define DENSITY_GLYPHS ".:+*#@"
+
+/*********************************************************************
+ ** Class: TerminalRenderer
+ ** Description: draws a viewport of a board on a screenRows x screenColumns
+ terminal. The last screen row is a status line. At zoom z every character
+ covers a z x z block of cells; top() and left() are the board cell at the
+ top left of the screen.
+ *********************************************************************/
+class TerminalRenderer
+{
+public:
+  explicit TerminalRenderer(int fd);
+
+  /** sizes the screen (0 = ask the terminal, 24x80 if it will not say) **/
+  void resize(int rows, int columns);
+  /** smallest zoom that shows the whole board, centred **/
+  void fit(int boardRows, int boardColumns);
+  /** moves the viewport by whole characters **/
+  void pan(int rows, int columns);
+  void zoomIn();
+  void zoomOut();
+  /** forgets what is on screen so the next frame is drawn in full **/
+  void invalidate();
+
+  void render(const BitGrid &board, const std::string &status);
+
+  int zoom() const { return scale; }
+  long long top() const { return viewTop; }
+  long long left() const { return viewLeft; }
+  std::size_t lastFrameBytes() const { return frameBytes; }
+
+private:
+  char glyph(const BitGrid &board, long long row, long long column) const;
+  void append(const char *text, std::size_t length);
+  void moveTo(int row, int column);
+
+  int fd;
+  int screenRows, screenColumns;
+  long long viewTop, viewLeft;
+  int scale;
+  std::vector<char> shown;     // glyph on each board cell of the screen, 0 = unknown
+  std::vector<char> frame;     // output buffer, big enough for a full redraw
+  std::size_t used;
+  std::size_t frameBytes;
+  std::string shownStatus;
+  bool clearFirst;
+};
+
+/*********************************************************************
+ ** Class: TerminalDisplay
+ ** Description: observer that shows a running Simulation. Attach it with
+ every = 1 and bracket each run with open() and close(). A frame is drawn when
+ one is due at framesPerSecond, whatever generation that is; in between an
+ observation costs a clock read and a key poll. With generationsPerSecond
+ above 0 the simulation is also held to that rate. Keys: arrows or wasd pan,
+ + and - zoom, f fits the board, q stops the run.
+ *********************************************************************/
+class TerminalDisplay : public GenerationObserver
+{
+public:
+  TerminalDisplay(Simulation &simulation, double framesPerSecond, double generationsPerSecond);
+  ~TerminalDisplay();
+
+  void open(const Engine &engine);
+  void close(const Engine &engine);
+  void observe(const Engine &engine);
+
+private:
+  void draw(const Engine &engine);
+  void pollKeys();
+
+  Simulation &simulation;
+  TerminalRenderer renderer;
+  BitGrid board;
+  std::chrono::steady_clock::duration frameInterval;
+  double generationRate;
+  std::chrono::steady_clock::time_point nextFrame, runStart;
+  long long runStartGeneration;
+  struct termios savedTerminal;
+  bool rawInput;
+  bool fitted;
+  int boardRows, boardColumns;
+};
+
+#endif
@@ -0,0 +1,177 @@
+/**************************************************************************************************
+ ** Program       Filename: GameOfLife
+ ** Current       File: golRule.cpp
+ ** Author:       Jordan Grant
+ ** Date:         10.17.26
+ ** Description: 	Outer totalistic rules (see golRule.hpp).
+ *****************************************************************************************************/
+
+#include "golRule.hpp"
+
+#include <cctype>
+#include <stdexcept>
+
+/** masks of the rules with kernels of their own, in RuleKernel order **/
+static const unsigned KERNEL_BIRTH[RULE_KERNEL_GENERIC] =
+  { 1 << 3, 1 << 3 | 1 << 6, 1 << 3 | 1 << 6 | 1 << 7 | 1 << 8, 1 << 2 };
+static const unsigned KERNEL_SURVIVAL[RULE_KERNEL_GENERIC] =
+  { 1 << 2 | 1 << 3, 1 << 2 | 1 << 3, 1 << 3 | 1 << 4 | 1 << 6 | 1 << 7 | 1 << 8, 0 };
+
+Rule::Rule()
+  : birthMask(KERNEL_BIRTH[RULE_KERNEL_CONWAY]), survivalMask(KERNEL_SURVIVAL[RULE_KERNEL_CONWAY]),
+    stateCount(2)
+{
+  build();
+}
+
+Rule::Rule(unsigned birth, unsigned survival, int states)
+  : birthMask(birth), survivalMask(survival), stateCount(states)
+{
+  if (birth > 0x1ff || survival > 0x1ff)
+    throw std::invalid_argument("rule: neighbor counts go from 0 to 8");
+  if (birth & 1)
+    throw std::invalid_argument("rule: B0 rules are not supported");
+  if (states < 2 || states > 256)
+    throw std::invalid_argument("rule: Generations rules have 2 to 256 states");
+  build();
+}
+
+void Rule::build()
+{
+  kernelId = RULE_KERNEL_GENERIC;
+  for (int k = 0; k < RULE_KERNEL_GENERIC; k++)
+    if (birthMask == KERNEL_BIRTH[k] && survivalMask == KERNEL_SURVIVAL[k])
+      kernelId = (RuleKernel)k;
+
+  for (int n = 0; n <= 8; n++)
+  {
+    lookup[n] = (unsigned char)(birthMask >> n & 1);
+    lookup[9 + n] = (unsigned char)(survivalMask >> n & 1);
+  }
+}
+
+/** digits 0-8 of compact from p up to the first character that is not one **/
+static unsigned readCounts(const std::string &text, const std::string &compact, std::size_t &p)
+{
+  unsigned mask = 0;
+
+  for (; p < compact.size() && std::isdigit((unsigned char)compact[p]); p++)
+  {
+    if (compact[p] == '9')
+      throw std::invalid_argument("rule '" + text + "': neighbor counts go from 0 to 8");
+    mask |= 1u << (compact[p] - '0');
+  }
+  return mask;
+}
+
+/** the state count of a Generations rule, from p **/
+static int readStates(const std::string &text, const std::string &compact, std::size_t &p)
+{
+  int states = 0;
+  std::size_t first = p;
+
+  for (; p < compact.size() && std::isdigit((unsigned char)compact[p]); p++)
+    if ((states = states * 10 + (compact[p] - '0')) > 256)
+      break;
+  if (p == first || states < 2 || states > 256)
+    throw std::invalid_argument("rule '" + text + "': Generations rules have 2 to 256 states");
+  return states;
+}
+
+Rule Rule::parse(const std::string &text)
+{
+  std::string lower;
+  for (std::size_t i = 0; i < text.size(); i++)
+    if (!std::isspace((unsigned char)text[i]))
+      lower += (char)std::tolower((unsigned char)text[i]);
+
+  if (lower == "conway" || lower == "life")
+    return Rule();
+  if (lower == "highlife")
+    return Rule(KERNEL_BIRTH[RULE_KERNEL_HIGHLIFE], KERNEL_SURVIVAL[RULE_KERNEL_HIGHLIFE]);
+  if (lower == "daynight")
+    return Rule(KERNEL_BIRTH[RULE_KERNEL_DAYNIGHT], KERNEL_SURVIVAL[RULE_KERNEL_DAYNIGHT]);
+  if (lower == "seeds")
+    return Rule(KERNEL_BIRTH[RULE_KERNEL_SEEDS], KERNEL_SURVIVAL[RULE_KERNEL_SEEDS]);
+  if (lower == "brain" || lower == "briansbrain")
+    return Rule(1 << 2, 0, 3);
+  if (lower == "starwars")
+    return Rule(1 << 2, 1 << 3 | 1 << 4 | 1 << 5, 4);
+
+  unsigned birth = 0, survival = 0;
+  int states = 2;
+  bool sawBirth = false, sawSurvival = false, sawStates = false;
+  std::size_t p = 0;
+
+  if (!lower.empty() && (lower[0] == 'b' || lower[0] == 's'))
+  {
+    /** B.../S... in either order, then an optional C... **/
+    while (p < lower.size())
+    {
+      char part = lower[p++];
+      if (part == 'b' && !sawBirth)
+      {
+        birth = readCounts(text, lower, p);
+        sawBirth = true;
+      }
+      else if (part == 's' && !sawSurvival)
+      {
+        survival = readCounts(text, lower, p);
+        sawSurvival = true;
+      }
+      else if (part == 'c' && sawBirth && sawSurvival && !sawStates)
+      {
+        states = readStates(text, lower, p);
+        sawStates = true;
+      }
+      else
+        throw std::invalid_argument("rule '" + text + "': expected B/S notation, e.g. B3/S23");
+      if (p < lower.size() && lower[p] == '/' && p + 1 < lower.size())
+        p++;
+    }
+  }
+  else
+  {
+    /** survival/birth[/states] **/
+    survival = readCounts(text, lower, p);
+    sawSurvival = true;
+    if (p < lower.size() && lower[p] == '/')
+    {
+      p++;
+      birth = readCounts(text, lower, p);
+      sawBirth = true;
+    }
+    if (sawBirth && p < lower.size() && lower[p] == '/')
+    {
+      p++;
+      states = readStates(text, lower, p);
+    }
+  }
+
+  if (!sawBirth || !sawSurvival || p != lower.size())
+    throw std::invalid_argument("rule '" + text + "': expected B/S notation, e.g. B3/S23");
+  return Rule(birth, survival, states);
+}
+
+int Rule::stateBits() const
+{
+  int bits = 1;
+  while ((1 << bits) < stateCount)
+    bits++;
+  return bits;
+}
+
+std::string Rule::notation() const
+{
+  std::string text = "B";
+  for (int n = 0; n <= 8; n++)
+    if (birthMask >> n & 1)
+      text += (char)('0' + n);
+  text += "/S";
+  for (int n = 0; n <= 8; n++)
+    if (survivalMask >> n & 1)
+      text += (char)('0' + n);
+  if (stateCount > 2)
+    text += "/C" + std::to_string(stateCount);
+  return text;
+}
@@ -0,0 +1,98 @@
+/************************************************************************************************
+ ** Program       Filename: GameOfLife
+ ** Current       File: golRule.hpp
+ ** Author:       Jordan Grant
+ ** Date:         10.17.26
+ ** Description: 	Outer totalistic Life-like rules in B/S notation. A rule is the set of
+ neighbor counts that give birth to a dead cell (B) and the set that keep a live cell
+ alive (S): Conway's Game of Life is B3/S23, HighLife B36/S23, Day & Night B3678/S34678
+ and Seeds B2/S. Generations rules add a state count C (B2/S/C3 is Brian's Brain): a
+ live cell that does not survive starts dying instead of dying outright, steps through
+ states 2 to C - 1 one generation at a time, and only counts as a neighbor, and can
+ only be reborn, once it is back at 0. A Rule holds both sets as bit masks, a lookup table indexed by the
+ cell and its neighbor count for the byte per cell engine, and the id of the bit
+ kernel that runs it: the common rules have kernels of their own with the rule folded
+ into the adder logic; any other rule runs on the generic kernel, which tests the
+ count against the masks.
+ **************************************************************************************************/
+
+
+#ifndef GOLRULE_HPP
+#define GOLRULE_HPP
+
+#include <string>
+
+/** bit kernels; every rule without a kernel of its own uses RULE_KERNEL_GENERIC **/
+enum RuleKernel
+{
+  RULE_KERNEL_CONWAY,
+  RULE_KERNEL_HIGHLIFE,
+  RULE_KERNEL_DAYNIGHT,
+  RULE_KERNEL_SEEDS,
+  RULE_KERNEL_GENERIC,
+  RULE_KERNELS
+};
+
+/*********************************************************************
+ ** Class: Rule
+ ** Description: birth and survival neighbor counts of an outer totalistic
+ rule; bit n of a mask is set when n live neighbors qualify. The default
+ rule is Conway's B3/S23.
+ ** Pre-Conditions: rules with B0 are rejected: a dead cell with no live
+ neighbors would be born, so empty space would fill, and neither the dead
+ board edge nor the unbounded engines can represent that
+ *********************************************************************/
+class Rule
+{
+public:
+  Rule();
+  /** throws std::invalid_argument for counts above 8, birth on 0 or states outside 2-256 **/
+  Rule(unsigned birth, unsigned survival, int states = 2);
+
+  /*
+   ** reads "B36/S23" (either order, any case, the slash optional), the older
+   ** survival/birth form "23/36", either one with a state count ("B2/S/C3",
+   ** "345/2/4"), or one of the names conway, life, highlife, daynight, seeds,
+   ** brain (B2/S/C3) and starwars (B2/S345/C4); throws std::invalid_argument
+   ** for anything else
+   */
+  static Rule parse(const std::string &text);
+
+  unsigned birth() const { return birthMask; }
+  unsigned survival() const { return survivalMask; }
+  RuleKernel kernel() const { return kernelId; }
+  /** cell states: 2 for Life-like rules, up to 256 for Generations rules **/
+  int states() const { return stateCount; }
+  /** bits needed to number the states, 1 for Life-like rules **/
+  int stateBits() const;
+
+  /**
+   ** next state of a cell (0 or 1) with neighbors live neighbors, ignoring the
+   ** dying states of a Generations rule: a 0 for a live cell means it starts dying
+   **/
+  unsigned char next(unsigned char alive, int neighbors) const
+  { return lookup[alive * 9 + neighbors]; }
+  /** next() as a table of 18 entries: [alive * 9 + neighbors] **/
+  const unsigned char *table() const { return lookup; }
+
+  /** canonical B/S notation, e.g. "B36/S23" or "B2/S/C3" **/
+  std::string notation() const;
+
+  bool operator==(const Rule &other) const
+  {
+    return birthMask == other.birthMask && survivalMask == other.survivalMask
+           && stateCount == other.stateCount;
+  }
+  bool operator!=(const Rule &other) const { return !(*this == other); }
+
+private:
+  void build();
+
+  unsigned birthMask;
+  unsigned survivalMask;
+  int stateCount;
+  RuleKernel kernelId;
+  unsigned char lookup[18];
+};
+
+#endif
@@ -0,0 +1,427 @@
+/**************************************************************************************************
+ ** Program       Filename: GameOfLife
+ ** Current       File: golSparse.cpp
+ ** Author:       Jordan Grant
+ ** Date:         10.17.26
+ ** Description: 	Unbounded sparse universe (see golSparse.hpp). Chunks live in an open
+ addressing table (linear probing, backward shift deletion) and in a dense list used
+ for iteration. Chunks come from a BlockPool and released ones are reused, so a
+ pattern that has settled, or a spaceship that keeps leaving chunks behind, does not
+ touch the allocator. Each generation is three passes: add the empty neighbor chunks
+ that live edge cells could spill into, step every chunk with the scalar bit kernel
+ for the rule, then release chunks that died out. Without B0 a cell can only be born
+ next to a live one, so no other chunk can come to life.
+ *****************************************************************************************************/
+
+#include "golSparse.hpp"
+#include "golBitKernelImpl.hpp"
+#include "golCycle.hpp"
+#include "golStats.hpp"
+
+#include <cstring>
+#include <stdexcept>
+
+static inline std::size_t hashChunk(long long cy, long long cx)
+{
+  uint64_t h = (uint64_t)cy * 0x9E3779B97F4A7C15ULL ^ (uint64_t)cx;
+  h = (h ^ (h >> 31)) * 0xBF58476D1CE4E5B9ULL;
+  return (std::size_t)(h ^ (h >> 29));
+}
+
+/** chunk coordinate of a cell coordinate, rounding toward minus infinity **/
+static inline long long chunkOf(long long v)
+{
+  return v >= 0 ? v / CHUNK_SIZE : -((-v + CHUNK_SIZE - 1) / CHUNK_SIZE);
+}
+
+SparseLife::SparseLife(const Rule &rule)
+  : live(0), parity(0), rule(rule), hashing(false), universeHash(0)
+{
+  slots.assign(64, NULL);
+}
+
+Chunk *SparseLife::find(long long cy, long long cx) const
+{
+  const std::size_t mask = slots.size() - 1;
+
+  for (std::size_t slot = hashChunk(cy, cx) & mask; slots[slot] != NULL; slot = (slot + 1) & mask)
+    if (slots[slot]->cy == cy && slots[slot]->cx == cx)
+      return slots[slot];
+  return NULL;
+}
+
+void SparseLife::grow(std::size_t slotCount)
+{
+  slots.assign(slotCount, NULL);
+
+  const std::size_t mask = slotCount - 1;
+  for (std::size_t i = 0; i < chunks.size(); i++)
+  {
+    std::size_t slot = hashChunk(chunks[i]->cy, chunks[i]->cx) & mask;
+    while (slots[slot] != NULL)
+      slot = (slot + 1) & mask;
+    slots[slot] = chunks[i];
+  }
+}
+
+/** returns the chunk at (cy, cx), adding an empty one if there is none **/
+Chunk *SparseLife::create(long long cy, long long cx)
+{
+  Chunk *chunk = find(cy, cx);
+  if (chunk != NULL)
+    return chunk;
+
+  chunk = pool.allocate();
+  std::memset(chunk->cells, 0, sizeof(chunk->cells));
+  chunk->cy = cy;
+  chunk->cx = cx;
+  chunk->population = 0;
+  chunk->index = chunks.size();
+  chunks.push_back(chunk);
+
+  if (chunks.size() * 2 > slots.size())
+    grow(slots.size() * 2);
+  else
+  {
+    const std::size_t mask = slots.size() - 1;
+    std::size_t slot = hashChunk(cy, cx) & mask;
+    while (slots[slot] != NULL)
+      slot = (slot + 1) & mask;
+    slots[slot] = chunk;
+  }
+
+  return chunk;
+}
+
+void SparseLife::release(Chunk *chunk)
+{
+  const std::size_t mask = slots.size() - 1;
+  std::size_t slot = hashChunk(chunk->cy, chunk->cx) & mask;
+
+  while (slots[slot] != chunk)
+    slot = (slot + 1) & mask;
+
+  /** backward shift: pull later entries of the probe run into the hole **/
+  std::size_t hole = slot;
+  for (std::size_t next = (hole + 1) & mask; slots[next] != NULL; next = (next + 1) & mask)
+  {
+    std::size_t home = hashChunk(slots[next]->cy, slots[next]->cx) & mask;
+    if (((next - home) & mask) >= ((next - hole) & mask))
+    {
+      slots[hole] = slots[next];
+      hole = next;
+    }
+  }
+  slots[hole] = NULL;
+
+  chunks[chunk->index] = chunks.back();
+  chunks[chunk->index]->index = chunk->index;
+  chunks.pop_back();
+
+  pool.release(chunk);
+}
+
+void SparseLife::clear()
+{
+  while (!chunks.empty())
+    release(chunks.back());
+  live = 0;
+  universeHash = 0;
+}
+
+void SparseLife::set(long long y, long long x, bool alive)
+{
+  long long cy = chunkOf(y), cx = chunkOf(x);
+  Chunk *chunk = alive ? create(cy, cx) : find(cy, cx);
+  if (chunk == NULL)
+    return;
+
+  uint64_t &word = chunk->cells[parity][y - cy * CHUNK_SIZE];
+  uint64_t bit = (uint64_t)1 << (x - cx * CHUNK_SIZE);
+  bool was = (word & bit) != 0;
+
+  if (was == alive)
+    return;
+
+  if (hashing)
+  {
+    uint64_t seed = hashRowSeed(y);
+    universeHash ^= hashWordKey(seed, cx, word) ^ hashWordKey(seed, cx, word ^ bit);
+  }
+  word ^= bit;
+  chunk->population += alive ? 1 : -1;
+  live += alive ? 1 : -1;
+  if (chunk->population == 0)
+    release(chunk);
+}
+
+bool SparseLife::get(long long y, long long x) const
+{
+  long long cy = chunkOf(y), cx = chunkOf(x);
+  const Chunk *chunk = find(cy, cx);
+
+  return chunk != NULL
+         && ((chunk->cells[parity][y - cy * CHUNK_SIZE] >> (x - cx * CHUNK_SIZE)) & 1);
+}
+
+void SparseLife::liveCells(std::vector<LifeCell> &cells) const
+{
+  for (std::size_t i = 0; i < chunks.size(); i++)
+  {
+    const Chunk *chunk = chunks[i];
+    for (int r = 0; r < CHUNK_SIZE; r++)
+      for (uint64_t word = chunk->cells[parity][r]; word != 0; word &= word - 1)
+      {
+        LifeCell cell = { chunk->cy * CHUNK_SIZE + r,
+                          chunk->cx * CHUNK_SIZE + __builtin_ctzll(word) };
+        cells.push_back(cell);
+      }
+  }
+}
+
+/*********************************************************************
+ ** Function: SparseLife::load
+ ** Description: board words line up with chunk rows (both are 64 cells wide),
+ so non-empty words are copied straight into their chunk
+ *********************************************************************/
+void SparseLife::load(const BitGrid &board)
+{
+  clear();
+  hashing = false;
+
+  for (int r = 0; r < board.rows(); r++)
+  {
+    const uint64_t *words = board.row(r);
+    for (std::size_t w = 0; w < board.words(); w++)
+    {
+      uint64_t word = w + 1 == board.words() ? words[w] & board.lastWordMask() : words[w];
+      if (word == 0)
+        continue;
+
+      Chunk *chunk = create(r / CHUNK_SIZE, (long long)w);
+      chunk->cells[parity][r % CHUNK_SIZE] = word;
+      chunk->population += __builtin_popcountll(word);
+      live += __builtin_popcountll(word);
+    }
+  }
+}
+
+void SparseLife::store(BitGrid &board) const
+{
+  board.clear();
+
+  for (std::size_t i = 0; i < chunks.size(); i++)
+  {
+    const Chunk *chunk = chunks[i];
+    if (chunk->cy < 0 || chunk->cx < 0 || chunk->cx >= (long long)board.words()
+        || chunk->cy * CHUNK_SIZE >= board.rows())
+      continue;
+
+    for (int r = 0; r < CHUNK_SIZE; r++)
+    {
+      long long y = chunk->cy * CHUNK_SIZE + r;
+      if (y >= board.rows())
+        break;
+
+      uint64_t word = chunk->cells[parity][r];
+      if (chunk->cx + 1 == (long long)board.words())
+        word &= board.lastWordMask();
+      board.row((int)y)[chunk->cx] = word;
+    }
+  }
+}
+
+std::size_t SparseLife::memoryBytes() const
+{
+  return pool.memoryBytes()
+         + slots.capacity() * sizeof(Chunk *) + chunks.capacity() * sizeof(Chunk *);
+}
+
+/*********************************************************************
+ ** Function: Step Chunk
+ ** Description: next generation of the 64 rows of one chunk; rows[i] holds
+ row i - 1 as west, centre and east words
+ ** Post-Conditions: returns the chunk's population
+ *********************************************************************/
+template <int KERNEL>
+static long long stepChunk(const uint64_t rows[CHUNK_SIZE + 2][3], uint64_t *out,
+                           unsigned birth, unsigned survival)
+{
+  long long population = 0;
+
+  for (int r = 0; r < CHUNK_SIZE; r++)
+  {
+    out[r] = lifeWords<uint64_t, KERNEL>(&rows[r][1], &rows[r + 1][1], &rows[r + 2][1],
+                                         birth, survival);
+    population += __builtin_popcountll(out[r]);
+  }
+  return population;
+}
+
+void SparseLife::step(long long generations)
+{
+  for (long long g = 0; g < generations; g++)
+    stepOnce();
+}
+
+void SparseLife::stepOnce()
+{
+  const int from = parity, to = parity ^ 1;
+
+  /** 1) live cells on an edge or corner can give birth in the chunk beyond it **/
+  const std::size_t existing = chunks.size();
+  for (std::size_t i = 0; i < existing; i++)
+  {
+    const uint64_t *cells = chunks[i]->cells[from];
+    long long cy = chunks[i]->cy, cx = chunks[i]->cx;
+    uint64_t columns = 0;
+
+    /** bit 0 collects the west column, bit 63 the east column **/
+    for (int r = 0; r < CHUNK_SIZE; r++)
+      columns |= cells[r];
+    columns &= 1 | ((uint64_t)1 << 63);
+
+    if (cells[0])
+      create(cy - 1, cx);
+    if (cells[CHUNK_SIZE - 1])
+      create(cy + 1, cx);
+    if (columns & 1)
+      create(cy, cx - 1);
+    if (columns >> 63)
+      create(cy, cx + 1);
+    if (cells[0] & 1)
+      create(cy - 1, cx - 1);
+    if (cells[0] >> 63)
+      create(cy - 1, cx + 1);
+    if (cells[CHUNK_SIZE - 1] & 1)
+      create(cy + 1, cx - 1);
+    if (cells[CHUNK_SIZE - 1] >> 63)
+      create(cy + 1, cx + 1);
+  }
+
+  /** 2) step every chunk; rows[i] holds row i - 1 as west, centre, east words **/
+  static const uint64_t none[CHUNK_SIZE] = { 0 };
+  live = 0;
+  for (std::size_t i = 0; i < chunks.size(); i++)
+  {
+    Chunk *chunk = chunks[i];
+    long long cy = chunk->cy, cx = chunk->cx;
+    const Chunk *around[3][3];
+
+    for (int dy = -1; dy <= 1; dy++)
+      for (int dx = -1; dx <= 1; dx++)
+        around[dy + 1][dx + 1] = (dy == 0 && dx == 0) ? chunk : find(cy + dy, cx + dx);
+
+    uint64_t rows[CHUNK_SIZE + 2][3];
+    for (int dx = 0; dx < 3; dx++)
+    {
+      const uint64_t *above = around[0][dx] ? around[0][dx]->cells[from] : none;
+      const uint64_t *middle = around[1][dx] ? around[1][dx]->cells[from] : none;
+      const uint64_t *below = around[2][dx] ? around[2][dx]->cells[from] : none;
+
+      rows[0][dx] = above[CHUNK_SIZE - 1];
+      for (int r = 0; r < CHUNK_SIZE; r++)
+        rows[r + 1][dx] = middle[r];
+      rows[CHUNK_SIZE + 1][dx] = below[0];
+    }
+
+    long long population;
+    uint64_t *out = chunk->cells[to];
+    switch (rule.kernel())
+    {
+      case RULE_KERNEL_CONWAY:
+        population = stepChunk<RULE_KERNEL_CONWAY>(rows, out, 0, 0);
+        break;
+      case RULE_KERNEL_HIGHLIFE:
+        population = stepChunk<RULE_KERNEL_HIGHLIFE>(rows, out, 0, 0);
+        break;
+      case RULE_KERNEL_DAYNIGHT:
+        population = stepChunk<RULE_KERNEL_DAYNIGHT>(rows, out, 0, 0);
+        break;
+      case RULE_KERNEL_SEEDS:
+        population = stepChunk<RULE_KERNEL_SEEDS>(rows, out, 0, 0);
+        break;
+      default:
+        population = stepChunk<RULE_KERNEL_GENERIC>(rows, out, rule.birth(), rule.survival());
+        break;
+    }
+
+    if (hashing)
+    {
+      const uint64_t *before = chunk->cells[from];
+      for (int r = 0; r < CHUNK_SIZE; r++)
+        if (before[r] != out[r])
+        {
+          uint64_t seed = hashRowSeed(cy * CHUNK_SIZE + r);
+          universeHash ^= hashWordKey(seed, cx, before[r]) ^ hashWordKey(seed, cx, out[r]);
+        }
+    }
+
+    GOL_STAT_COUNT_WORDS(chunk->cells[from], out, 0, CHUNK_SIZE);
+    chunk->population = population;
+    live += population;
+  }
+
+  parity = to;
+
+  /** 3) empty chunks are released; they come back if life reaches them again **/
+  for (std::size_t i = chunks.size(); i-- > 0;)
+    if (chunks[i]->population == 0)
+      release(chunks[i]);
+}
+
+uint64_t SparseLife::hash()
+{
+  if (!hashing)
+  {
+    universeHash = 0;
+    for (std::size_t i = 0; i < chunks.size(); i++)
+      for (int r = 0; r < CHUNK_SIZE; r++)
+        universeHash ^= hashWordKey(hashRowSeed(chunks[i]->cy * CHUNK_SIZE + r), chunks[i]->cx,
+                                    chunks[i]->cells[parity][r]);
+    hashing = true;
+  }
+  return universeHash;
+}
+
+SparseEngine::SparseEngine(int rows, int columns, const Rule &rule)
+  : Engine(rows, columns, rule), life(rule)
+{
+}
+
+void SparseEngine::loadBits(const BitGrid &board)
+{
+  life.load(board);
+  generationCount = 0;
+}
+
+void SparseEngine::storeBits(BitGrid &board) const
+{
+  if (board.rows() != rowCount || board.columns() != columnCount)
+    board = BitGrid(rowCount, columnCount);
+  life.store(board);
+}
+
+void SparseEngine::step(long long generations)
+{
+  if (generations <= 0)
+    return;
+
+  life.step(generations);
+  generationCount += generations;
+}
+
+long long SparseEngine::population() const
+{
+  return life.population();
+}
+
+std::size_t SparseEngine::memoryBytes() const
+{
+  return life.memoryBytes();
+}
+
+uint64_t SparseEngine::hash()
+{
+  return life.hash();
+}
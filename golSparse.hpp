@@ -0,0 +1,124 @@
+/************************************************************************************************
+ ** Program       Filename: GameOfLife
+ ** Current       File: golSparse.hpp
+ ** Author:       Jordan Grant
+ ** Date:         10.17.26
+ ** Description: 	Unbounded sparse universe. Instead of one board with a dead border,
+ space is a hash map of 64x64 cell chunks keyed by chunk coordinates. A chunk is
+ allocated the generation live cells reach its edge and released again as soon as it
+ is empty, so memory follows the live area rather than the bounding box: a glider
+ that has flown a million cells away still costs a handful of chunks.
+ **************************************************************************************************/
+
+
+#ifndef GOLSPARSE_HPP
+#define GOLSPARSE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "golArena.hpp"
+#include "golEngine.hpp"
+
+#define CHUNK_SIZE 64
+#define CHUNK_BLOCK 256
+
+/*********************************************************************
+ ** Struct: Chunk
+ ** Description: 64 rows of 64 cells; cells[parity] is the current generation
+ and cells[parity ^ 1] the one being built
+ *********************************************************************/
+struct Chunk
+{
+  uint64_t cells[2][CHUNK_SIZE];
+  long long cy, cx;
+  long long population;
+  std::size_t index;
+  Chunk *nextFree;
+};
+
+/** a live cell's coordinates in an unbounded universe **/
+struct LifeCell
+{
+  long long y, x;
+};
+
+/*********************************************************************
+ ** Class: SparseLife
+ ** Description: unbounded universe of chunks. Cell coordinates may be any
+ long long, negative included. load() and store() place a board's top left
+ cell at (0, 0).
+ *********************************************************************/
+class SparseLife
+{
+public:
+  explicit SparseLife(const Rule &rule = Rule());
+
+  void clear();
+  void set(long long y, long long x, bool alive);
+  bool get(long long y, long long x) const;
+  /** appends every live cell to cells, in no particular order **/
+  void liveCells(std::vector<LifeCell> &cells) const;
+
+  void load(const BitGrid &board);
+  /** copies the board.rows() x board.columns() window at (0, 0) **/
+  void store(BitGrid &board) const;
+
+  void step(long long generations);
+
+  long long population() const { return live; }
+  std::size_t chunkCount() const { return chunks.size(); }
+  std::size_t memoryBytes() const;
+  /**
+   ** hash of the universe: a chunk row is hashed as the word (y, cx) of an
+   ** endless BitGrid, so a board loaded at (0, 0) hashes like hashBitGrid().
+   ** Kept up to date by step() and set() from the first call on.
+   **/
+  uint64_t hash();
+
+private:
+  SparseLife(const SparseLife &);
+  SparseLife &operator=(const SparseLife &);
+
+  Chunk *find(long long cy, long long cx) const;
+  Chunk *create(long long cy, long long cx);
+  void release(Chunk *chunk);
+  void grow(std::size_t slotCount);
+  void stepOnce();
+
+  std::vector<Chunk *> slots;
+  std::vector<Chunk *> chunks;
+  BlockPool<Chunk, &Chunk::nextFree, CHUNK_BLOCK> pool;
+  long long live;
+  int parity;
+  Rule rule;
+  bool hashing;
+  uint64_t universeHash;
+};
+
+/*********************************************************************
+ ** Class: SparseEngine
+ ** Description: Engine front end for SparseLife. Like HashLifeEngine it has no
+ edge; storeBits() shows the board sized window at (0, 0).
+ *********************************************************************/
+class SparseEngine : public Engine
+{
+public:
+  SparseEngine(int rows, int columns, const Rule &rule = Rule());
+
+  const char *name() const { return "sparse"; }
+  void loadBits(const BitGrid &board);
+  void storeBits(BitGrid &board) const;
+  void step(long long generations);
+  long long population() const;
+  std::size_t memoryBytes() const;
+  uint64_t hash();
+  bool unbounded() const { return true; }
+
+  SparseLife &universe() { return life; }
+
+private:
+  SparseLife life;
+};
+
+#endif
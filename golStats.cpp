@@ -0,0 +1,343 @@
+/**************************************************************************************************
+ ** Program       Filename: GameOfLife
+ ** Current       File: golStats.cpp
+ ** Author:       Jordan Grant
+ ** Date:         10.17.26
+ ** Description: 	Run statistics (see golStats.hpp). Without GOL_STATS only the
+ StatsSession is compiled, to turn away the options that need the statistics.
+ *****************************************************************************************************/
+
+#include "golStats.hpp"
+#include "golOptions.hpp"
+
+#include <stdexcept>
+
+#ifdef GOL_STATS
+
+#include "golEngine.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+/** gauges are refreshed from the engine at most this often **/
+#define STATS_GAUGE_NANOSECONDS 100000000ULL
+/** the dumper wakes this often to see whether it should stop **/
+#define STATS_POLL_MILLISECONDS 100
+
+static std::mutex shardLock;
+static std::vector<StatsShard *> shards;
+static std::atomic<long long> gauges[STAT_GAUGES];
+static std::atomic<uint64_t> lastGauges(0);
+static int traceFd = -1;
+
+static uint64_t nowNanoseconds()
+{
+  return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+           std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/** shards live as long as the program, so a thread's counts outlast the thread **/
+StatsShard *registerStatsShard()
+{
+  StatsShard *shard = new StatsShard;
+
+  for (int i = 0; i < STAT_COUNTERS; i++)
+    shard->counters[i].store(0, std::memory_order_relaxed);
+  for (int i = 0; i < STATS_BUCKETS; i++)
+    shard->buckets[i].store(0, std::memory_order_relaxed);
+
+  std::lock_guard<std::mutex> lock(shardLock);
+  shards.push_back(shard);
+  return shard;
+}
+
+void statsSet(StatGauge gauge, long long value)
+{
+  gauges[gauge].store(value, std::memory_order_relaxed);
+}
+
+static void traceMark(const char *text, int length)
+{
+  if (write(traceFd, text, (std::size_t)length) < 0)
+    traceFd = -1;
+}
+
+StatsScope::StatsScope(const char *name, long long generations)
+  : generations(generations), start(0)
+{
+  if (traceFd >= 0)
+  {
+    char text[128];
+    int length = std::snprintf(text, sizeof(text), "B|%d|%s", (int)getpid(), name);
+    traceMark(text, length < (int)sizeof(text) ? length : (int)sizeof(text) - 1);
+  }
+  start = nowNanoseconds();
+}
+
+StatsScope::~StatsScope()
+{
+  uint64_t elapsed = nowNanoseconds() - start;
+
+  if (traceFd >= 0)
+  {
+    char text[32];
+    int length = std::snprintf(text, sizeof(text), "E|%d", (int)getpid());
+    traceMark(text, length);
+  }
+  if (generations <= 0)
+    return;
+
+  statsAdd(STAT_GENERATIONS, (uint64_t)generations);
+  statsAdd(STAT_STEP_NANOSECONDS, elapsed);
+
+  uint64_t perGeneration = elapsed / (uint64_t)generations;
+  int bucket = perGeneration == 0 ? 0 : 64 - __builtin_clzll(perGeneration);
+  if (bucket < STATS_BUCKETS)
+  {
+    std::atomic<uint64_t> &value = statsShard().buckets[bucket];
+    value.store(value.load(std::memory_order_relaxed) + (uint64_t)generations,
+                std::memory_order_relaxed);
+  }
+}
+
+void statsEngineGauges(const Engine &engine)
+{
+  uint64_t now = nowNanoseconds();
+  if (now - lastGauges.load(std::memory_order_relaxed) < STATS_GAUGE_NANOSECONDS)
+    return;
+  lastGauges.store(now, std::memory_order_relaxed);
+
+  statsSet(STAT_POPULATION, engine.population());
+  statsSet(STAT_MEMORY_BYTES, (long long)engine.memoryBytes());
+}
+
+StatsSnapshot statsSnapshot()
+{
+  StatsSnapshot snapshot = StatsSnapshot();
+
+  {
+    std::lock_guard<std::mutex> lock(shardLock);
+    for (std::size_t s = 0; s < shards.size(); s++)
+    {
+      for (int i = 0; i < STAT_COUNTERS; i++)
+        snapshot.counters[i] += shards[s]->counters[i].load(std::memory_order_relaxed);
+      for (int i = 0; i < STATS_BUCKETS; i++)
+        snapshot.buckets[i] += shards[s]->buckets[i].load(std::memory_order_relaxed);
+    }
+  }
+  for (int i = 0; i < STAT_GAUGES; i++)
+    snapshot.gauges[i] = gauges[i].load(std::memory_order_relaxed);
+  return snapshot;
+}
+
+static void writeMetric(std::ostream &out, const char *name, const char *type, const char *help,
+                        long long value)
+{
+  out << "# HELP " << name << " " << help << "\n"
+      << "# TYPE " << name << " " << type << "\n"
+      << name << " " << value << "\n";
+}
+
+void writeStats(std::ostream &out, const StatsSnapshot &snapshot)
+{
+  writeMetric(out, "gol_generations_total", "counter", "Generations stepped.",
+              (long long)snapshot.counters[STAT_GENERATIONS]);
+  writeMetric(out, "gol_births_total", "counter", "Dead cells that came alive.",
+              (long long)snapshot.counters[STAT_BIRTHS]);
+  writeMetric(out, "gol_deaths_total", "counter", "Live cells that died.",
+              (long long)snapshot.counters[STAT_DEATHS]);
+  writeMetric(out, "gol_tile_steps_total", "counter", "Tiles stepped by the tiled engine.",
+              (long long)snapshot.counters[STAT_TILE_STEPS]);
+  writeMetric(out, "gol_soups_total", "counter", "Census soups run.",
+              (long long)snapshot.counters[STAT_SOUPS]);
+  writeMetric(out, "gol_population", "gauge", "Live cells at the last sample.",
+              snapshot.gauges[STAT_POPULATION]);
+  writeMetric(out, "gol_memory_bytes", "gauge", "Bytes the engine holds.",
+              snapshot.gauges[STAT_MEMORY_BYTES]);
+  writeMetric(out, "gol_active_tiles", "gauge", "Tiles the tiled engine stepped last generation.",
+              snapshot.gauges[STAT_ACTIVE_TILES]);
+
+  out << "# HELP gol_step_seconds Time to step one generation.\n"
+         "# TYPE gol_step_seconds histogram\n";
+  uint64_t cumulative = 0;
+  for (int i = 0; i < STATS_BUCKETS; i++)
+  {
+    cumulative += snapshot.buckets[i];
+    out << "gol_step_seconds_bucket{le=\"" << (double)((uint64_t)1 << i) * 1e-9 << "\"} "
+        << cumulative << "\n";
+  }
+  out << "gol_step_seconds_bucket{le=\"+Inf\"} " << snapshot.counters[STAT_GENERATIONS] << "\n"
+      << "gol_step_seconds_sum " << snapshot.counters[STAT_STEP_NANOSECONDS] * 1e-9 << "\n"
+      << "gol_step_seconds_count " << snapshot.counters[STAT_GENERATIONS] << "\n";
+}
+
+/*********************************************************************
+ ** Struct: StatsSession::Dumper
+ ** Description: the background thread behind --stats. A file is replaced
+ (written beside it and renamed over it) so a reader never sees half of
+ one; a socket answers every client that connects with the current text.
+ *********************************************************************/
+struct StatsSession::Dumper
+{
+  std::string path;
+  bool socket;
+  int listener;
+  uint64_t every;
+  std::atomic<bool> stopping;
+  std::thread thread;
+
+  Dumper() : socket(false), listener(-1), every(0), stopping(false) {}
+
+  std::string text() const
+  {
+    std::ostringstream out;
+    writeStats(out, statsSnapshot());
+    return out.str();
+  }
+
+  void writeFile() const
+  {
+    const std::string temporary = path + ".tmp";
+    {
+      std::ofstream out(temporary.c_str(), std::ios::trunc);
+      out << text();
+      if (!out)
+        return;
+    }
+    std::rename(temporary.c_str(), path.c_str());
+  }
+
+  void openListener()
+  {
+    struct sockaddr_un address = sockaddr_un();
+    if (path.empty() || path.size() >= sizeof(address.sun_path))
+      throw std::invalid_argument("--stats: unix socket path is empty or too long: " + path);
+
+    address.sun_family = AF_UNIX;
+    path.copy(address.sun_path, path.size());
+    unlink(path.c_str());
+
+    listener = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listener < 0 || bind(listener, (struct sockaddr *)&address, sizeof(address)) != 0
+        || ::listen(listener, 8) != 0)
+    {
+      if (listener >= 0)
+        close(listener);
+      throw std::runtime_error("--stats: cannot listen on " + path);
+    }
+  }
+
+  void serve() const
+  {
+    int client = accept(listener, NULL, NULL);
+    if (client < 0)
+      return;
+
+    const std::string reply = text();
+    std::size_t sent = 0;
+    while (sent < reply.size())
+    {
+      ssize_t count = send(client, reply.data() + sent, reply.size() - sent, MSG_NOSIGNAL);
+      if (count <= 0)
+        break;
+      sent += (std::size_t)count;
+    }
+    close(client);
+  }
+
+  void loop()
+  {
+    uint64_t due = nowNanoseconds() + every;
+
+    while (!stopping.load(std::memory_order_acquire))
+    {
+      if (socket)
+      {
+        struct pollfd wait = { listener, POLLIN, 0 };
+        if (poll(&wait, 1, STATS_POLL_MILLISECONDS) > 0)
+          serve();
+        continue;
+      }
+
+      std::this_thread::sleep_for(std::chrono::milliseconds(STATS_POLL_MILLISECONDS));
+      if (nowNanoseconds() >= due)
+      {
+        writeFile();
+        due = nowNanoseconds() + every;
+      }
+    }
+  }
+};
+
+StatsSession::StatsSession(const Options &options)
+{
+  if (options.traceMarkers && traceFd < 0)
+  {
+    traceFd = open("/sys/kernel/tracing/trace_marker", O_WRONLY | O_CLOEXEC);
+    if (traceFd < 0)
+      traceFd = open("/sys/kernel/debug/tracing/trace_marker", O_WRONLY | O_CLOEXEC);
+    if (traceFd < 0)
+      throw std::runtime_error("--trace-markers: cannot open the kernel's trace_marker file");
+  }
+
+  if (options.stats.empty())
+    return;
+
+  dumper.reset(new Dumper);
+  dumper->every = (uint64_t)(options.statsEvery * 1e9);
+  if (options.stats.compare(0, 5, "unix:") == 0)
+  {
+    dumper->socket = true;
+    dumper->path = options.stats.substr(5);
+    dumper->openListener();
+  }
+  else
+    dumper->path = options.stats;
+  dumper->thread = std::thread(&Dumper::loop, dumper.get());
+}
+
+/** the last numbers are written out on the way out, so short runs leave a file too **/
+StatsSession::~StatsSession()
+{
+  if (!dumper)
+    return;
+
+  dumper->stopping.store(true, std::memory_order_release);
+  dumper->thread.join();
+  if (dumper->socket)
+  {
+    close(dumper->listener);
+    unlink(dumper->path.c_str());
+  }
+  else
+    dumper->writeFile();
+}
+
+#else
+
+struct StatsSession::Dumper
+{
+};
+
+StatsSession::StatsSession(const Options &options)
+{
+  if (!options.stats.empty() || options.traceMarkers)
+    throw std::invalid_argument(std::string(options.stats.empty() ? "--trace-markers" : "--stats")
+                                + ": this build has no statistics; rebuild with make STATS=1");
+}
+
+StatsSession::~StatsSession()
+{
+}
+
+#endif
@@ -0,0 +1,196 @@
+/************************************************************************************************
+ ** Program       Filename: GameOfLife
+ ** Current       File: golStats.hpp
+ ** Author:       Jordan Grant
+ ** Date:         10.17.26
+ ** Description: 	Run statistics, compiled in only by make STATS=1 (-DGOL_STATS).
+ Otherwise every GOL_STAT_* macro below expands to nothing, so the
+ stepping code is the same as it was before it was instrumented. When compiled in,
+ each thread counts into a shard of its own: only the owning thread writes a
+ shard, and it does so with plain relaxed loads and stores, not locked
+ read-modify-writes. Readers add the shards up. A StatsSession started from the
+ command line can write the totals as Prometheus text to a file or a Unix socket
+ every few seconds. It can also write begin and end markers around each step to
+ the kernel's trace_marker file, where perf record -e ftrace:print sees them.
+ **************************************************************************************************/
+
+
+#ifndef GOLSTATS_HPP
+#define GOLSTATS_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+
+class Engine;
+struct Options;
+
+/*********************************************************************
+ ** Class: StatsSession
+ ** Description: starts what the command line asked for: --stats PATH dumps
+ the statistics to PATH (or, for unix:PATH, serves them to each client of a
+ Unix socket) every --stats-every seconds and once more when the session
+ ends; --trace-markers turns the step markers on.
+ ** Post-Conditions: throws std::invalid_argument if any of these is asked
+ for in a build without GOL_STATS, std::runtime_error if the socket or the
+ trace_marker file cannot be opened
+ *********************************************************************/
+class StatsSession
+{
+public:
+  explicit StatsSession(const Options &options);
+  ~StatsSession();
+
+private:
+  StatsSession(const StatsSession &);
+  StatsSession &operator=(const StatsSession &);
+
+  struct Dumper;
+  std::unique_ptr<Dumper> dumper;
+};
+
+#ifdef GOL_STATS
+
+/** counters only ever grow; gauges hold the latest value **/
+enum StatCounter
+{
+  STAT_GENERATIONS,
+  STAT_STEP_NANOSECONDS,
+  STAT_BIRTHS,
+  STAT_DEATHS,
+  STAT_TILE_STEPS,
+  STAT_SOUPS,
+  STAT_COUNTERS
+};
+
+enum StatGauge
+{
+  STAT_POPULATION,
+  STAT_MEMORY_BYTES,
+  STAT_ACTIVE_TILES,
+  STAT_GAUGES
+};
+
+/** histogram bucket i counts generations stepped in under 2^i nanoseconds **/
+#define STATS_BUCKETS 40
+
+/*********************************************************************
+ ** Struct: StatsShard
+ ** Description: one thread's counters, written by that thread only
+ *********************************************************************/
+struct alignas(64) StatsShard
+{
+  std::atomic<uint64_t> counters[STAT_COUNTERS];
+  std::atomic<uint64_t> buckets[STATS_BUCKETS];
+};
+
+/*********************************************************************
+ ** Struct: StatsSnapshot
+ ** Description: every shard added up, plus the gauges
+ *********************************************************************/
+struct StatsSnapshot
+{
+  uint64_t counters[STAT_COUNTERS];
+  uint64_t buckets[STATS_BUCKETS];
+  long long gauges[STAT_GAUGES];
+};
+
+/** the calling thread's shard, registered the first time the thread counts anything **/
+StatsShard *registerStatsShard();
+
+static inline StatsShard &statsShard()
+{
+  static thread_local StatsShard *shard = NULL;
+  if (shard == NULL)
+    shard = registerStatsShard();
+  return *shard;
+}
+
+static inline void statsAdd(StatCounter counter, uint64_t amount)
+{
+  std::atomic<uint64_t> &value = statsShard().counters[counter];
+  value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+void statsSet(StatGauge gauge, long long value);
+
+/** counts the births and deaths between two runs of words, or of byte cells (live = 1) **/
+static inline void statsCountWords(const uint64_t *before, const uint64_t *after,
+                                   std::size_t first, std::size_t last)
+{
+  uint64_t births = 0, deaths = 0;
+
+  for (std::size_t w = first; w < last; w++)
+  {
+    births += __builtin_popcountll(after[w] & ~before[w]);
+    deaths += __builtin_popcountll(before[w] & ~after[w]);
+  }
+  statsAdd(STAT_BIRTHS, births);
+  statsAdd(STAT_DEATHS, deaths);
+}
+
+static inline void statsCountCells(const unsigned char *before, const unsigned char *after,
+                                   int count)
+{
+  uint64_t births = 0, deaths = 0;
+
+  for (int c = 0; c < count; c++)
+  {
+    births += after[c] == 1 && before[c] != 1;
+    deaths += before[c] == 1 && after[c] != 1;
+  }
+  statsAdd(STAT_BIRTHS, births);
+  statsAdd(STAT_DEATHS, deaths);
+}
+
+/*********************************************************************
+ ** Class: StatsScope
+ ** Description: times the step it is declared around: on the way out the
+ generations go into the counters and the per generation time into the
+ histogram. With markers on it also writes "B|pid|name" on the way in and
+ "E|pid" on the way out, the begin / end form trace viewers understand.
+ *********************************************************************/
+class StatsScope
+{
+public:
+  StatsScope(const char *name, long long generations);
+  ~StatsScope();
+
+private:
+  long long generations;
+  uint64_t start;
+};
+
+/** refreshes the population and memory gauges from engine, at most every 100 ms **/
+void statsEngineGauges(const Engine &engine);
+
+StatsSnapshot statsSnapshot();
+
+/*********************************************************************
+ ** Function: Write Stats
+ ** Description: the snapshot in the Prometheus text format: gol_* counters
+ and gauges and the gol_step_seconds histogram
+ *********************************************************************/
+void writeStats(std::ostream &out, const StatsSnapshot &snapshot);
+
+#define GOL_STAT_ADD(counter, amount) statsAdd(counter, amount)
+#define GOL_STAT_SET(gauge, value) statsSet(gauge, value)
+#define GOL_STAT_COUNT_WORDS(before, after, first, last) statsCountWords(before, after, first, last)
+#define GOL_STAT_COUNT_CELLS(before, after, count) statsCountCells(before, after, count)
+#define GOL_STAT_ENGINE(engine) statsEngineGauges(engine)
+#define GOL_STAT_SCOPE(name, generations) StatsScope statsScope(name, generations)
+
+#else
+
+#define GOL_STAT_ADD(counter, amount) ((void)0)
+#define GOL_STAT_SET(gauge, value) ((void)0)
+#define GOL_STAT_COUNT_WORDS(before, after, first, last) ((void)0)
+#define GOL_STAT_COUNT_CELLS(before, after, count) ((void)0)
+#define GOL_STAT_ENGINE(engine) ((void)0)
+#define GOL_STAT_SCOPE(name, generations) ((void)0)
+
+#endif
+
+#endif
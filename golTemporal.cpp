@@ -0,0 +1,274 @@
+/**************************************************************************************************
+ ** Program       Filename: GameOfLife
+ ** Current       File: golTemporal.cpp
+ ** Author:       Jordan Grant
+ ** Date:         10.17.26
+ ** Description: 	Temporal blocking (see golTemporal.hpp).
+ *****************************************************************************************************/
+
+#include "golTemporal.hpp"
+#include "golCycle.hpp"
+
+#include <cstring>
+#include <linux/perf_event.h>
+#include <stdexcept>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+/** deepest pass depth 0 picks, and its cache budget when the L2 size is unknown **/
+#define AUTO_DEPTH_LIMIT 8
+#define DEFAULT_L2_BYTES (1 << 20)
+/** ring rows per generation: the rows above, at and below the one being stepped **/
+#define RING_ROWS 3
+
+/** the deepest pass whose ring fits in half the L2 cache, from 2 to AUTO_DEPTH_LIMIT **/
+static int autoDepth(std::size_t rowBytes)
+{
+  long cache = sysconf(_SC_LEVEL2_CACHE_SIZE);
+  const std::size_t budget = (cache > 0 ? (std::size_t)cache : DEFAULT_L2_BYTES) / 2;
+  std::size_t depth = budget / (RING_ROWS * rowBytes) + 1;
+
+  return depth < 2 ? 2 : depth > AUTO_DEPTH_LIMIT ? AUTO_DEPTH_LIMIT : (int)depth;
+}
+
+static inline long long wrapRow(long long row, int rows)
+{
+  row %= rows;
+  return row < 0 ? row + rows : row;
+}
+
+BlockedEngine::BlockedEngine(int rows, int columns, int depth, Topology topology, const Rule &rule)
+  : Engine(rows, columns, rule), current(0), topology(topology), passDepth(depth), streamed(0),
+    steppedGenerations(0), passCount(0)
+{
+  if (depth < 0 || depth > MAX_TEMPORAL_DEPTH)
+    throw std::invalid_argument("BlockedEngine: depth must be 0 to "
+                                + std::to_string(MAX_TEMPORAL_DEPTH) + ", got "
+                                + std::to_string(depth));
+
+  grids[0] = BitGrid(rows, columns);
+  grids[1] = BitGrid(rows, columns);
+  if (passDepth == 0)
+    passDepth = autoDepth(grids[0].stride() * sizeof(uint64_t));
+  levels = BitGrid(passDepth > 1 ? RING_ROWS * (passDepth - 1) : 1, columns);
+}
+
+void BlockedEngine::loadBits(const BitGrid &board)
+{
+  if (board.rows() != rowCount || board.columns() != columnCount)
+    throw std::invalid_argument("BlockedEngine::loadBits: board dimensions differ");
+
+  grids[current] = board;
+  grids[current].clearHalo();
+  generationCount = 0;
+  streamed = 0;
+  steppedGenerations = 0;
+  passCount = 0;
+  hashing = false;
+}
+
+/** takes board's buffer like BitEngine::adoptBits(), halo trusted to be dead **/
+void BlockedEngine::adoptBits(BitGrid &board)
+{
+  if (board.rows() != rowCount || board.columns() != columnCount)
+    throw std::invalid_argument("BlockedEngine::adoptBits: board dimensions differ");
+
+  grids[current].swap(board);
+  generationCount = 0;
+  streamed = 0;
+  steppedGenerations = 0;
+  passCount = 0;
+  hashing = false;
+}
+
+void BlockedEngine::storeBits(BitGrid &board) const
+{
+  board = grids[current];
+  board.clearHalo();
+}
+
+/*********************************************************************
+ ** Function: BlockedEngine::pass
+ ** Description: advances the board generations generations in one sweep.
+ At wavefront step s, generation j (1 to generations) steps its row s - j,
+ reading generation j - 1's rows s - j - 1 to s - j + 1: generation 0 is the
+ board itself, the last generation writes straight into the other buffer,
+ and the rest are ring rows, row r of generation j in slot r mod 3. Bounded,
+ every generation covers the board's rows and rows off the board read as
+ dead. On a torus generation j also covers generations - j rows past each
+ edge, reading generation 0's rows (wrapped around, their columns wrapped
+ as the wavefront reaches them) where the board has none; the last
+ generation is then exactly the board's rows. The hash is updated from the
+ words the last generation changes, as stepBitRows() does.
+ *********************************************************************/
+void BlockedEngine::pass(int generations)
+{
+  BitGrid &in = grids[current];
+  BitGrid &out = grids[current ^ 1];
+  const bool torus = topology == TOPOLOGY_TORUS;
+  const std::size_t words = in.words(),
+                    last = words - 1;
+  const uint64_t mask = in.lastWordMask();
+  const uint64_t *dead = levels.row(-1);
+  const long long rows = rowCount,
+                  firstStep = torus ? 2 - generations : 1,
+                  lastStep = rows + generations - 1;
+
+  /** the first step reads two rows above the one it wraps **/
+  for (long long r = firstStep - 2; torus && r < firstStep; r++)
+  {
+    const int wrapped = (int)wrapRow(r, rowCount);
+    wrapBitColumns(in, wrapped, wrapped + 1);
+  }
+
+  for (long long s = firstStep; s <= lastStep; s++)
+  {
+    if (torus)
+    {
+      const int fresh = (int)wrapRow(s, rowCount);
+      wrapBitColumns(in, fresh, fresh + 1);
+    }
+
+    for (int j = 1; j <= generations; j++)
+    {
+      const long long row = s - j,
+                      reach = torus ? generations - j : 0;
+      if (row < -reach || row >= rows + reach)
+        continue;
+
+      const uint64_t *source[3];
+      for (int k = 0; k < 3; k++)
+      {
+        const long long r = row - 1 + k;
+        if (j == 1)
+          source[k] = torus ? in.row((int)wrapRow(r, rowCount))
+                            : r >= 0 && r < rows ? in.row((int)r) : dead;
+        else if (!torus && (r < 0 || r >= rows))
+          source[k] = dead;
+        else
+          source[k] = levels.row(RING_ROWS * (j - 2) + (int)wrapRow(r, RING_ROWS));
+      }
+
+      if (j < generations)
+      {
+        const int slot = RING_ROWS * (j - 1) + (int)wrapRow(row, RING_ROWS);
+        stepBitWords(source[0], source[1], source[2], levels.row(slot), words, mask, lifeRule);
+        if (torus)
+          wrapBitColumns(levels, slot, slot + 1);
+        continue;
+      }
+
+      uint64_t *target = out.row((int)row);
+      stepBitWords(source[0], source[1], source[2], target, words, mask, lifeRule);
+      if (hashing)
+      {
+        const uint64_t *before = in.row((int)row);
+        const uint64_t seed = hashRowSeed(row);
+        uint64_t delta = 0;
+        for (std::size_t w = 0; w < words; w++)
+        {
+          const uint64_t was = w == last ? before[w] & mask : before[w];
+          if (was != target[w])
+            delta ^= hashWordKey(seed, (long long)w, was) ^ hashWordKey(seed, (long long)w, target[w]);
+        }
+        boardHash ^= delta;
+      }
+    }
+  }
+
+  /** a torus reads generations rows past each edge a second time **/
+  const std::size_t rowBytes = in.stride() * sizeof(uint64_t);
+  streamed += (double)rowBytes * (2 * rows + (torus ? 2 * generations : 0));
+  passCount++;
+  current ^= 1;
+}
+
+void BlockedEngine::step(long long generations)
+{
+  for (long long done = 0; done < generations;)
+  {
+    const int depth = generations - done < passDepth ? (int)(generations - done) : passDepth;
+    pass(depth);
+    done += depth;
+  }
+  if (generations > 0)
+  {
+    generationCount += generations;
+    steppedGenerations += generations;
+  }
+}
+
+long long BlockedEngine::population() const
+{
+  return grids[current].population();
+}
+
+std::size_t BlockedEngine::memoryBytes() const
+{
+  return grids[0].bufferBytes() + grids[1].bufferBytes() + levels.bufferBytes();
+}
+
+uint64_t BlockedEngine::hash()
+{
+  if (!hashing)
+  {
+    boardHash = hashBitGrid(grids[current]);
+    hashing = true;
+  }
+  return boardHash;
+}
+
+double BlockedEngine::bytesPerCellGeneration() const
+{
+  const double cellGenerations = (double)rowCount * columnCount * (double)steppedGenerations;
+  return cellGenerations > 0 ? streamed / cellGenerations : 0;
+}
+
+double BlockedEngine::generationsPerPass() const
+{
+  return passCount > 0 ? (double)steppedGenerations / (double)passCount : 0;
+}
+
+MemoryTraffic::MemoryTraffic() : fd(-1), misses(0), lineBytes(CACHE_LINE)
+{
+  struct perf_event_attr attributes;
+  std::memset(&attributes, 0, sizeof(attributes));
+  attributes.size = sizeof(attributes);
+  attributes.type = PERF_TYPE_HARDWARE;
+  attributes.config = PERF_COUNT_HW_CACHE_MISSES;
+  attributes.disabled = 1;
+  attributes.exclude_kernel = 1;
+  attributes.exclude_hv = 1;
+
+  fd = (int)syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0);
+  long line = sysconf(_SC_LEVEL3_CACHE_LINESIZE);
+  if (line > 0)
+    lineBytes = (double)line;
+}
+
+MemoryTraffic::~MemoryTraffic()
+{
+  if (fd >= 0)
+    close(fd);
+}
+
+void MemoryTraffic::start()
+{
+  misses = 0;
+  if (fd < 0)
+    return;
+  ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+  ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+}
+
+void MemoryTraffic::stop()
+{
+  if (fd < 0)
+    return;
+
+  uint64_t count = 0;
+  ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+  if (read(fd, &count, sizeof(count)) == (ssize_t)sizeof(count))
+    misses = (double)count;
+}
@@ -0,0 +1,106 @@
+/************************************************************************************************
+ ** Program       Filename: GameOfLife
+ ** Current       File: golTemporal.hpp
+ ** Author:       Jordan Grant
+ ** Date:         10.17.26
+ ** Description: 	Temporal blocking for bit packed boards too big for the cache. Stepping a
+ generation at a time streams the whole board in and out of memory every generation.
+ The blocked engine instead advances depth generations in one pass over the board:
+ a wavefront runs down the rows, and the rows of every generation but the last live
+ in a small ring of three rows per generation, a tile that stays in cache. Generation
+ j's row r is stepped as soon as generation j - 1 has row r + 1, so each board row is
+ read once and written once per pass and nothing is computed twice. On a torus the
+ rows wrapping around from the far edge are stepped alongside the board, a trapezoid
+ that narrows by one row each generation, so the pass never waits for rows it has not
+ reached yet. MemoryTraffic reads the hardware's last level cache misses where the
+ kernel allows it, to check the saving on boards far past the cache.
+ **************************************************************************************************/
+
+
+#ifndef GOLTEMPORAL_HPP
+#define GOLTEMPORAL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include "golEngine.hpp"
+
+/** most generations a pass may advance **/
+#define MAX_TEMPORAL_DEPTH 64
+
+/*********************************************************************
+ ** Class: BlockedEngine
+ ** Description: steps depth generations per pass over the board; step(n)
+ makes n / depth full passes and one shorter pass for what is left. A depth
+ of 0 picks the deepest ring (at most 8 generations) that fits in half the
+ L2 cache.
+ ** Pre-Conditions: depth is 0 to MAX_TEMPORAL_DEPTH; throws
+ std::invalid_argument otherwise
+ *********************************************************************/
+class BlockedEngine : public Engine
+{
+public:
+  BlockedEngine(int rows, int columns, int depth = 0, Topology topology = TOPOLOGY_BOUNDED,
+                const Rule &rule = Rule());
+
+  const char *name() const { return "blocked"; }
+  void loadBits(const BitGrid &board);
+  void storeBits(BitGrid &board) const;
+  void adoptBits(BitGrid &board);
+  void step(long long generations);
+  long long population() const;
+  std::size_t memoryBytes() const;
+  uint64_t hash();
+  int stepGrain() const { return passDepth; }
+
+  int depth() const { return passDepth; }
+  /** board bytes the passes since the last load read and wrote **/
+  double streamedBytes() const { return streamed; }
+  /** streamedBytes() over the cell generations stepped **/
+  double bytesPerCellGeneration() const;
+  /** passes made since the last load **/
+  long long passes() const { return passCount; }
+  /** generations stepped over passes(): depth() unless steps keep ending mid pass **/
+  double generationsPerPass() const;
+
+private:
+  void pass(int generations);
+
+  BitGrid grids[2];
+  BitGrid levels;            // three rows for each generation inside a pass
+  int current;
+  Topology topology;
+  int passDepth;
+  double streamed;
+  long long steppedGenerations;
+  long long passCount;
+};
+
+/*********************************************************************
+ ** Class: MemoryTraffic
+ ** Description: counts the last level cache misses of this thread between
+ start() and stop(), each a cache line to or from DRAM
+ ** Post-Conditions: available() is false, and bytes() 0, where the kernel
+ has no counter to give (perf_event_open() failed)
+ *********************************************************************/
+class MemoryTraffic
+{
+public:
+  MemoryTraffic();
+  ~MemoryTraffic();
+
+  bool available() const { return fd >= 0; }
+  void start();
+  void stop();
+  /** cache lines missed times the line size **/
+  double bytes() const { return misses * lineBytes; }
+
+private:
+  MemoryTraffic(const MemoryTraffic &);
+  MemoryTraffic &operator=(const MemoryTraffic &);
+
+  int fd;
+  double misses;
+  double lineBytes;
+};
+
+#endif
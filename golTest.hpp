@@ -0,0 +1,72 @@
+/************************************************************************************************
+ ** Program       Filename: GameOfLife
+ ** Current       File: golTest.hpp
+ ** Author:       Jordan Grant
+ ** Date:         10.17.26
+ ** Description: 	What every golTest*.cpp program shares: each check is reported once by
+ testReport(), which prints PASS or FAIL and a reason and keeps count, and main() ends
+ with testSummary(), which prints the total and gives the exit status `make check` reads.
+ Only the test programs include it.
+ **************************************************************************************************/
+
+
+#ifndef GOLTEST_HPP
+#define GOLTEST_HPP
+
+#include <iostream>
+#include <string>
+
+/*********************************************************************
+ ** Struct: TestTally
+ ** Description: checks reported so far and how many of them failed
+ *********************************************************************/
+struct TestTally
+{
+  int checks;
+  int failures;
+};
+
+inline TestTally &testTally()
+{
+  static TestTally tally = { 0, 0 };
+  return tally;
+}
+
+/*********************************************************************
+ ** Function: Test Report
+ ** Description: counts the check name, which failed if failure is not empty:
+ prints "FAIL name: failure", or "PASS name" unless quiet
+ *********************************************************************/
+inline void testReport(const std::string &name, const std::string &failure, bool quiet = false)
+{
+  testTally().checks++;
+  if (failure.empty())
+  {
+    if (!quiet)
+      std::cout << "PASS " << name << "\n";
+    return;
+  }
+  std::cout << "FAIL " << name << ": " << failure << "\n";
+  testTally().failures++;
+}
+
+/*********************************************************************
+ ** Function: Test Summary
+ ** Description: prints "all N what checks passed" or "F of N what checks
+ failed"
+ ** Post-Conditions: returns main()'s exit status, 1 if any check failed
+ *********************************************************************/
+inline int testSummary(const std::string &what)
+{
+  const TestTally &tally = testTally();
+
+  if (tally.failures > 0)
+  {
+    std::cout << tally.failures << " of " << tally.checks << " " << what << " checks failed\n";
+    return 1;
+  }
+  std::cout << "all " << tally.checks << " " << what << " checks passed\n";
+  return 0;
+}
+
+#endif
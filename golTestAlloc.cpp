@@ -0,0 +1,169 @@
+/**************************************************************************************************
+ ** Program       Filename: GameOfLife
+ ** Current       File: golTestAlloc.cpp
+ ** Author:       Jordan Grant
+ ** Date:         10.17.26
+ ** Description: 	Allocation test, built and run by `make check`. Every form of the global
+ operator new is replaced with one that counts, and the arena gets its memory through
+ operator new too, so the count covers every heap allocation the program makes. Each
+ case warms a run up until its buffers, pools and tables have grown to size, then steps
+ it again and fails if that took a single allocation. The cases cover every engine and
+ topology (for distributed, the front end; its workers are other processes), cycle
+ detection (whose history keeps turning over), an observer copying the board out
+ every generation, and the char array updateGame().
+ *****************************************************************************************************/
+
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+#include "golEngine.hpp"
+#include "golFunctions.hpp"
+#include "golPattern.hpp"
+#include "golTest.hpp"
+
+#define WARM_UP 600
+#define MEASURED 600
+
+static std::atomic<long long> allocations(0);
+
+static void *counted(std::size_t bytes, std::size_t alignment)
+{
+  allocations.fetch_add(1, std::memory_order_relaxed);
+
+  void *memory;
+  if (alignment <= alignof(std::max_align_t))
+    memory = std::malloc(bytes > 0 ? bytes : 1);
+  else
+    memory = std::aligned_alloc(alignment, (bytes + alignment - 1) / alignment * alignment);
+  if (memory == NULL)
+    throw std::bad_alloc();
+  return memory;
+}
+
+void *operator new(std::size_t bytes) { return counted(bytes, 0); }
+void *operator new[](std::size_t bytes) { return counted(bytes, 0); }
+void *operator new(std::size_t bytes, std::align_val_t alignment)
+{ return counted(bytes, (std::size_t)alignment); }
+void *operator new[](std::size_t bytes, std::align_val_t alignment)
+{ return counted(bytes, (std::size_t)alignment); }
+void operator delete(void *memory) noexcept { std::free(memory); }
+void operator delete[](void *memory) noexcept { std::free(memory); }
+void operator delete(void *memory, std::size_t) noexcept { std::free(memory); }
+void operator delete[](void *memory, std::size_t) noexcept { std::free(memory); }
+void operator delete(void *memory, std::align_val_t) noexcept { std::free(memory); }
+void operator delete[](void *memory, std::align_val_t) noexcept { std::free(memory); }
+void operator delete(void *memory, std::size_t, std::align_val_t) noexcept { std::free(memory); }
+void operator delete[](void *memory, std::size_t, std::align_val_t) noexcept { std::free(memory); }
+
+/*********************************************************************
+ ** Class: CopyObserver
+ ** Description: copies the board out of the engine every generation, the way
+ a display or a checkpoint writer does
+ *********************************************************************/
+class CopyObserver : public GenerationObserver
+{
+public:
+  void observe(const Engine &engine)
+  {
+    engine.storeBits(board);
+    live = engine.population();
+  }
+
+private:
+  BitGrid board;
+  long long live;
+};
+
+static void report(const std::string &name, long long count)
+{
+  testReport(name, count == 0 ? "" : std::to_string(count) + " allocations while stepping");
+}
+
+/*********************************************************************
+ ** Function: Check Engine
+ ** Description: runs pattern (a soup when empty) on a 256x256 board of the
+ named engine three ways: bare step() calls, a Simulation looking for cycles
+ in a 64 generation history, and a Simulation with a CopyObserver
+ *********************************************************************/
+static void checkEngine(const std::string &name, Topology topology, const std::string &rule,
+                        const std::string &pattern)
+{
+  const std::string label = name + "/" + topologyName(topology) + "/" + rule + "/"
+                            + (pattern.empty() ? "soup" : pattern);
+  BitGrid start(256, 256);
+
+  if (pattern.empty())
+    fillSoup(start, 0.4, 1);
+  else
+  {
+    BitGridSink sink(start, 96, 96);
+    loadPattern(pattern, sink);
+  }
+
+  std::unique_ptr<Engine> engine = makeEngine(name, 256, 256, 2, topology, Rule::parse(rule));
+  engine->loadBits(start);
+
+  for (int g = 0; g < WARM_UP; g++)
+    engine->step(1);
+  long long before = allocations.load();
+  for (int g = 0; g < MEASURED; g++)
+    engine->step(1);
+  report(label + " step", allocations.load() - before);
+
+  Simulation detecting(*engine);
+  detecting.detectCycles(64, CYCLE_STOP);
+  detecting.run(WARM_UP);
+  before = allocations.load();
+  detecting.run(MEASURED);
+  report(label + " cycles", allocations.load() - before);
+
+  CopyObserver observer;
+  Simulation observed(*engine);
+  observed.addObserver(&observer);
+  observed.run(WARM_UP);
+  before = allocations.load();
+  observed.run(MEASURED);
+  report(label + " observed", allocations.load() - before);
+}
+
+static char currentGen[ROWS][COLUMNS], nextGen[ROWS][COLUMNS];
+
+int main()
+{
+  const Topology topologies[] = { TOPOLOGY_BOUNDED, TOPOLOGY_TORUS };
+  const char *const gridEngines[] = { "char", "bit", "parallel", "blocked" };
+
+  for (int t = 0; t < 2; t++)
+  {
+    for (int e = 0; e < 4; e++)
+    {
+      checkEngine(gridEngines[e], topologies[t], "B3/S23", "");
+      checkEngine(gridEngines[e], topologies[t], "B36/S23", "gliders");
+    }
+    checkEngine("generations", topologies[t], "B2/S/C3", "");
+    checkEngine("generations", topologies[t], "B3/S23", "gun");
+  }
+  /** only the front end is counted: the workers are separate processes **/
+  checkEngine("distributed", TOPOLOGY_BOUNDED, "B3/S23", "");
+  checkEngine("distributed", TOPOLOGY_TORUS, "B36/S23", "gliders");
+  checkEngine("tiled", TOPOLOGY_BOUNDED, "B3/S23", "");
+  checkEngine("tiled", TOPOLOGY_BOUNDED, "B3/S23", "gun");
+  /** the gliders fly off the board, so chunks keep being made and released; a soup
+   ** is left out, as the gliders it sends off keep adding chunks for good **/
+  checkEngine("sparse", TOPOLOGY_BOUNDED, "B3/S23", "gliders");
+  checkEngine("sparse", TOPOLOGY_BOUNDED, "B3/S23", "pulsar");
+  /** hashlife only stops making nodes once the pattern repeats **/
+  checkEngine("hashlife", TOPOLOGY_BOUNDED, "B3/S23", "pulsar");
+
+  seedGameboard(currentGen, 1);
+  for (int g = 0; g < WARM_UP; g++)
+    updateGame(currentGen, nextGen);
+  long long before = allocations.load();
+  for (int g = 0; g < MEASURED; g++)
+    updateGame(currentGen, nextGen);
+  report("updateGame/char array", allocations.load() - before);
+
+  return testSummary("allocation");
+}
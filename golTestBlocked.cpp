@@ -0,0 +1,89 @@
+/**************************************************************************************************
+ ** Program       Filename: GameOfLife
+ ** Current       File: golTestBlocked.cpp
+ ** Author:       Jordan Grant
+ ** Date:         10.17.26
+ ** Description: 	Temporal blocking test, built and run by `make check`. The blocked engine
+ is run at several pass depths (including deeper than the board is tall) on boards from
+ one row or one column up, under each topology and a few rules, next to the bit engine
+ stepping one generation at a time. Runs of uneven lengths end mid pass, and after every
+ run the board, population and hash (kept up to date by the passes) must match exactly.
+ *****************************************************************************************************/
+
+#include <iostream>
+#include <string>
+#include "golTemporal.hpp"
+#include "golCycle.hpp"
+#include "golPattern.hpp"
+#include "golTest.hpp"
+
+#define RUNS 12
+
+static void report(const std::string &name, long long failed)
+{
+  testReport(name, failed < 0 ? "" : "differs from single steps at generation " + std::to_string(failed));
+}
+
+/*********************************************************************
+ ** Function: Check Blocked
+ ** Description: a rows x columns soup on a depth deep blocked engine against
+ the bit engine, RUNS runs of 1 to 3 passes and a bit each
+ *********************************************************************/
+static void checkBlocked(int rows, int columns, int depth, Topology topology,
+                         const std::string &rule)
+{
+  const Rule parsed = Rule::parse(rule);
+  const std::string name = std::to_string(rows) + "x" + std::to_string(columns) + "/depth "
+                           + std::to_string(depth) + "/" + topologyName(topology) + "/" + rule;
+  BitGrid soup(rows, columns), board, expected;
+
+  fillSoup(soup, 0.4, (uint64_t)(rows * 131 + columns * 7 + depth));
+  BlockedEngine blocked(rows, columns, depth, topology, parsed);
+  BitEngine reference(rows, columns, topology, parsed);
+  blocked.loadBits(soup);
+  reference.loadBits(soup);
+  blocked.hash();
+
+  long long failed = -1;
+  for (int run = 0; run < RUNS && failed < 0; run++)
+  {
+    const long long generations = (long long)blocked.depth() * (run % 3 + 1) + run % 5;
+    blocked.step(generations);
+    for (long long g = 0; g < generations; g++)
+      reference.step(1);
+
+    blocked.storeBits(board);
+    reference.storeBits(expected);
+    bool same = blocked.population() == reference.population()
+                && blocked.hash() == hashBitGrid(expected);
+    for (int r = 0; r < rows && same; r++)
+      for (int c = 0; c < columns && same; c++)
+        same = board.get(r, c) == expected.get(r, c);
+    if (!same)
+      failed = reference.generation();
+  }
+  report(name, failed);
+}
+
+int main()
+{
+  const Topology topologies[] = { TOPOLOGY_BOUNDED, TOPOLOGY_TORUS };
+  const int depths[] = { 1, 2, 3, 8, 64 };
+  const char *const rules[] = { "B3/S23", "B36/S23", "B2/S" };
+
+  for (int t = 0; t < 2; t++)
+  {
+    for (int d = 0; d < 5; d++)
+      for (int r = 0; r < 3; r++)
+        checkBlocked(50, 130, depths[d], topologies[t], rules[r]);
+
+    /** boards shorter than a pass is deep, a row or a column wide, a word wide **/
+    checkBlocked(1, 70, 4, topologies[t], "B3/S23");
+    checkBlocked(2, 9, 5, topologies[t], "B3/S23");
+    checkBlocked(5, 1, 3, topologies[t], "B3/S23");
+    checkBlocked(33, 64, 7, topologies[t], "B3/S23");
+    checkBlocked(17, 65, 0, topologies[t], "B3/S23");
+  }
+
+  return testSummary("blocked");
+}
@@ -0,0 +1,93 @@
+/**************************************************************************************************
+ ** Program       Filename: GameOfLife
+ ** Current       File: golTestCensus.cpp
+ ** Author:       Jordan Grant
+ ** Date:         10.17.26
+ ** Description: 	Census test, built and run by `make check`. wechslerCode() is checked on
+ cells whose codes use the run and strip letters, and classifyObject() must give the
+ known apgcodes for a block, a blinker, a glider, a beacon and a toad in any phase and
+ orientation. separateObjects() must split a block beside a blinker (close enough to be
+ grouped, never close enough to meet) into the two, and keep the phases of the beacon
+ and the toad whose cells fall into two pieces that do not touch as one object.
+ *****************************************************************************************************/
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include "golCensus.hpp"
+#include "golTest.hpp"
+
+/** cells from rows of text, 'x' alive, the first row at y = 0 **/
+static std::vector<LifeCell> cellsOf(const std::vector<std::string> &rows)
+{
+  std::vector<LifeCell> cells;
+
+  for (std::size_t y = 0; y < rows.size(); y++)
+    for (std::size_t x = 0; x < rows[y].size(); x++)
+      if (rows[y][x] == 'x')
+      {
+        LifeCell cell = { (long long)y, (long long)x };
+        cells.push_back(cell);
+      }
+  return cells;
+}
+
+static void checkCode(const std::string &name, const std::vector<std::string> &rows,
+                      const std::string &expected)
+{
+  const std::string code = wechslerCode(cellsOf(rows));
+  testReport("wechslerCode " + name, code == expected ? "" : code + ", should be " + expected);
+}
+
+static void checkObject(const std::string &name, const std::vector<std::string> &rows,
+                        const std::string &expected, SparseLife &scratch)
+{
+  const std::string object = classifyObject(cellsOf(rows), scratch);
+  testReport("classifyObject " + name, object == expected ? "" : object + ", should be " + expected);
+}
+
+/*********************************************************************
+ ** Function: Check Split
+ ** Description: separateObjects() on rows must give the objects expected,
+ named by classifyObject(), in the order their first cells come up
+ *********************************************************************/
+static void checkSplit(const std::string &name, const std::vector<std::string> &rows,
+                       const std::vector<std::string> &expected, SparseLife &scratch)
+{
+  std::vector<std::vector<LifeCell> > objects;
+  separateObjects(cellsOf(rows), 4, scratch, objects);
+
+  std::string found, wanted;
+  for (std::size_t i = 0; i < objects.size(); i++)
+    found += (i > 0 ? " " : "") + classifyObject(objects[i], scratch);
+  for (std::size_t i = 0; i < expected.size(); i++)
+    wanted += (i > 0 ? " " : "") + expected[i];
+  testReport("separateObjects " + name, found == wanted ? "" : found + ", should be " + wanted);
+}
+
+int main()
+{
+  SparseLife scratch;
+
+  checkCode("block", { "xx", "xx" }, "33");
+  checkCode("run of 4 empty columns", { "x....x" }, "1y01");
+  checkCode("run of 2 empty columns", { "x..x" }, "1w1");
+  checkCode("two strips", { "x", ".", ".", ".", ".", "x" }, "1z1");
+
+  checkObject("block", { "xx", "xx" }, "xs4_33", scratch);
+  checkObject("blinker", { "xxx" }, "xp2_7", scratch);
+  checkObject("blinker upright", { "x", "x", "x" }, "xp2_7", scratch);
+  checkObject("glider", { ".x.", "..x", "xxx" }, "xq4_153", scratch);
+  checkObject("glider turned", { "xx.", "x.x", "x.." }, "xq4_153", scratch);
+  checkObject("beacon", { "xx..", "xx..", "..xx", "..xx" }, "xp2_318c", scratch);
+  checkObject("beacon other phase", { "xx..", "x...", "...x", "..xx" }, "xp2_318c", scratch);
+  checkObject("toad", { ".xxx", "xxx." }, "xp2_7e", scratch);
+  checkObject("toad other phase", { "..x.", "x..x", "x..x", ".x.." }, "xp2_7e", scratch);
+
+  checkSplit("block and blinker", { "xx....", "xx....", "......", "...x..", "...x..", "...x.." },
+             { "xs4_33", "xp2_7" }, scratch);
+  checkSplit("beacon other phase", { "xx..", "x...", "...x", "..xx" }, { "xp2_318c" }, scratch);
+  checkSplit("toad other phase", { "..x.", "x..x", "x..x", ".x.." }, { "xp2_7e" }, scratch);
+
+  return testSummary("census");
+}
@@ -0,0 +1,263 @@
+/**************************************************************************************************
+ ** Program       Filename: GameOfLife
+ ** Current       File: golTestDistributed.cpp
+ ** Author:       Jordan Grant
+ ** Date:         10.17.26
+ ** Description: 	Distributed engine test, built and run by `make check`. Boards split
+ over 1 to 7 worker processes (more than the rows, too, and slabs of one or two rows)
+ are stepped next to a single process reference built on updateGame(): the Grid
+ version under each rule and topology (a torus is wrapped with wrapGrid() first), and
+ the original char array version on the four PATTERNS. Every generation the board,
+ its population and its hash must match the reference exactly. Engines are also built
+ while another thread allocates, which must not hang the workers forked for them, and
+ a worker is killed in the middle of a long step, which must throw, not hang.
+ *****************************************************************************************************/
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <stdexcept>
+#include <vector>
+#include <signal.h>
+#include <unistd.h>
+#include "golDistributed.hpp"
+#include "golCycle.hpp"
+#include "golFunctions.hpp"
+#include "golPattern.hpp"
+#include "golTest.hpp"
+
+#define GENERATIONS 60
+#define JUMP 50
+/** engines built while another thread allocates, and seconds before the test gives up on a hung worker **/
+#define BUSY_BUILDS 40
+#define BUSY_TIMEOUT 120
+
+/** true if the engine's board, population and hash all match the reference **/
+static bool sameBoard(DistributedEngine &engine, const Grid &reference)
+{
+  Grid board;
+  BitGrid bits(reference.rows(), reference.columns());
+
+  engine.store(board);
+  packGrid(reference, bits);
+  for (int r = 0; r < reference.rows(); r++)
+    for (int c = 0; c < reference.columns(); c++)
+      if (board.get(r, c) != reference.get(r, c))
+        return false;
+  return engine.population() == reference.population() && engine.hash() == hashBitGrid(bits);
+}
+
+static void report(const std::string &name, long long failed)
+{
+  testReport(name, failed < 0 ? "" : "differs from updateGame() at generation " + std::to_string(failed));
+}
+
+/*********************************************************************
+ ** Function: Check Soup
+ ** Description: a rows x columns soup on processes workers against the
+ Grid updateGame(), GENERATIONS single steps and then one JUMP step
+ *********************************************************************/
+static void checkSoup(int rows, int columns, int processes, Topology topology,
+                      const std::string &rule)
+{
+  const Rule parsed = Rule::parse(rule);
+  const std::string name = std::to_string(rows) + "x" + std::to_string(columns) + "/"
+                           + std::to_string(processes) + "/" + topologyName(topology) + "/" + rule;
+  BitGrid soup(rows, columns);
+  Grid reference(rows, columns), spare(rows, columns);
+
+  fillSoup(soup, 0.4, (uint64_t)(rows * 7919 + columns));
+  unpackGrid(soup, reference);
+
+  DistributedEngine engine(rows, columns, processes, topology, parsed);
+  engine.loadBits(soup);
+
+  long long failed = sameBoard(engine, reference) ? -1 : 0;
+  for (int g = 1; g <= GENERATIONS + JUMP && failed < 0; g++)
+  {
+    if (topology == TOPOLOGY_TORUS)
+      wrapGrid(reference);
+    updateGame(reference, spare, parsed);
+    if (g <= GENERATIONS)
+      engine.step(1);
+    else if (g == GENERATIONS + JUMP)
+      engine.step(JUMP);
+    else
+      continue;
+
+    if (!sameBoard(engine, reference))
+      failed = g;
+  }
+  report(name, failed);
+}
+
+static char currentGen[ROWS][COLUMNS], nextGen[ROWS][COLUMNS];
+
+/** the char array board as a Grid, 'x' alive **/
+static void toGrid(char board[ROWS][COLUMNS], Grid &grid)
+{
+  for (int r = 0; r < ROWS; r++)
+    for (int c = 0; c < COLUMNS; c++)
+      grid.set(r, c, board[r][c] == 'x');
+}
+
+/*********************************************************************
+ ** Function: Check Pattern
+ ** Description: PATTERNS entry choice on the char array board, stepped by the
+ original updateGame() and by processes workers
+ *********************************************************************/
+static void checkPattern(int choice, int processes)
+{
+  Grid reference(ROWS, COLUMNS);
+
+  seedGameboard(currentGen, choice);
+  toGrid(currentGen, reference);
+
+  DistributedEngine engine(ROWS, COLUMNS, processes);
+  engine.load(reference);
+
+  long long failed = -1;
+  for (int g = 1; g <= GENERATIONS && failed < 0; g++)
+  {
+    updateGame(currentGen, nextGen);
+    toGrid(currentGen, reference);
+    engine.step(1);
+    if (!sameBoard(engine, reference))
+      failed = g;
+  }
+  report("pattern " + std::to_string(choice) + "/" + std::to_string(processes), failed);
+}
+
+/** allocates and frees strings until done is set **/
+static void allocateUntil(const std::atomic<bool> *done)
+{
+  std::vector<std::string> garbage;
+
+  while (!done->load())
+  {
+    garbage.push_back(std::string(100 + garbage.size() % 900, 'x'));
+    if (garbage.size() > 1000)
+      garbage.clear();
+  }
+}
+
+/*********************************************************************
+ ** Function: Check Busy
+ ** Description: builds and steps BUSY_BUILDS engines while another thread
+ does nothing but allocate and free, the way a stats dumper or a parallel
+ engine's pool may be busy when a distributed engine is made. A worker that
+ allocated after the fork could find the heap locked by a thread it does not
+ have and hang, so the test gives up and fails after BUSY_TIMEOUT seconds.
+ *********************************************************************/
+static void checkBusy()
+{
+  std::atomic<bool> done(false);
+  std::thread busy(allocateUntil, &done);
+
+  alarm(BUSY_TIMEOUT);
+  long long failed = -1;
+  for (int build = 0; build < BUSY_BUILDS && failed < 0; build++)
+  {
+    BitGrid soup(30, 70);
+    Grid reference(30, 70), spare(30, 70);
+    fillSoup(soup, 0.4, (uint64_t)build + 1);
+    unpackGrid(soup, reference);
+
+    DistributedEngine engine(30, 70, 3);
+    engine.loadBits(soup);
+    for (int g = 1; g <= 5 && failed < 0; g++)
+    {
+      updateGame(reference, spare);
+      engine.step(1);
+      if (!sameBoard(engine, reference))
+        failed = g;
+    }
+  }
+  alarm(0);
+
+  done = true;
+  busy.join();
+  testReport("built while another thread allocates",
+             failed < 0 ? "" : "differs from updateGame() at generation " + std::to_string(failed));
+}
+
+/** kills worker after delay, standing in for a crash or the OOM killer **/
+static void killAfter(pid_t worker, int milliseconds)
+{
+  std::this_thread::sleep_for(std::chrono::milliseconds(milliseconds));
+  kill(worker, SIGKILL);
+}
+
+/*********************************************************************
+ ** Function: Check Killed
+ ** Description: the middle one of three workers is killed while the engine
+ steps far more generations than it could finish. Its neighbors are left
+ waiting for edge rows that never come; the step must still throw
+ std::runtime_error (and so must the next call) rather than hang, which the
+ alarm turns into a failure after BUSY_TIMEOUT seconds.
+ *********************************************************************/
+static void checkKilled()
+{
+  BitGrid soup(60, 130);
+  fillSoup(soup, 0.4, 7);
+
+  std::string failure;
+  {
+    DistributedEngine engine(60, 130, 3);
+    engine.loadBits(soup);
+
+    alarm(BUSY_TIMEOUT);
+    std::thread killer(killAfter, engine.workerProcess(1), 300);
+    try
+    {
+      engine.step(2000000000);
+      failure = "step finished with a worker killed";
+    }
+    catch (const std::runtime_error &)
+    {
+    }
+    killer.join();
+
+    try
+    {
+      engine.population();
+      if (failure.empty())
+        failure = "answered after a worker was killed";
+    }
+    catch (const std::runtime_error &)
+    {
+    }
+  }
+  alarm(0);
+  testReport("worker killed mid step", failure);
+}
+
+int main()
+{
+  const int processCounts[] = { 1, 2, 3, 7 };
+  const Topology topologies[] = { TOPOLOGY_BOUNDED, TOPOLOGY_TORUS };
+  const char *const rules[] = { "B3/S23", "B36/S23", "B2/S" };
+
+  for (int t = 0; t < 2; t++)
+    for (int r = 0; r < 3; r++)
+      for (int p = 0; p < 4; p++)
+        checkSoup(45, 130, processCounts[p], topologies[t], rules[r]);
+
+  /** slabs of one and two rows, and more processes than rows **/
+  checkSoup(7, 64, 7, TOPOLOGY_BOUNDED, "B3/S23");
+  checkSoup(7, 64, 7, TOPOLOGY_TORUS, "B3/S23");
+  checkSoup(9, 33, 4, TOPOLOGY_TORUS, "B3/S23");
+  checkSoup(3, 70, 5, TOPOLOGY_BOUNDED, "B3/S23");
+  checkSoup(3, 70, 5, TOPOLOGY_TORUS, "B3/S23");
+
+  for (int choice = 1; choice <= patternCount(); choice++)
+    for (int p = 1; p <= 4; p += 3)
+      checkPattern(choice, p);
+
+  checkBusy();
+  checkKilled();
+
+  return testSummary("distributed");
+}
@@ -0,0 +1,204 @@
+/**************************************************************************************************
+ ** Program       Filename: GameOfLife
+ ** Current       File: golTestOracle.cpp
+ ** Author:       Jordan Grant
+ ** Date:         10.17.26
+ ** Description: 	Differential test against the reference implementation (golOracle.hpp),
+ built and run by `make check`. First the reference is tied to the original program:
+ on the classic board the four built in patterns are stepped by referenceUpdate(), by
+ updateGame() and by an OracleBoard, which must agree. Then the patterns and random
+ soups (from a single row or column up) are run through every engine makeEngine()
+ builds, at 1 to 3 threads, under each rule and topology it accepts, next to an
+ OracleBoard; the wider soups run under every SIMD kernel the CPU has. The population,
+ the hash and the board must match after every generation, and again after steps of
+ several generations at once.
+ *****************************************************************************************************/
+
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include "golOracle.hpp"
+#include "golCycle.hpp"
+#include "golTest.hpp"
+
+/** generations stepped one at a time, then the sizes of the longer steps **/
+#define SINGLE_STEPS 32
+#define LONG_STEPS 5
+
+static const int longSteps[LONG_STEPS] = { 2, 3, 5, 8, 13 };
+/** generations in a whole run **/
+static const int RUN_GENERATIONS = SINGLE_STEPS + 2 + 3 + 5 + 8 + 13;
+
+/*********************************************************************
+ ** Struct: EngineCase
+ ** Description: an engine to build, with its threads (worker processes for
+ distributed) and blocked pass depth
+ *********************************************************************/
+struct EngineCase
+{
+  const char *name;
+  int threads;
+  int depth;
+};
+
+static const EngineCase engineCases[] = {
+  { "char", 1, 0 },
+  { "bit", 1, 0 },
+  { "parallel", 1, 0 },
+  { "parallel", 2, 0 },
+  { "parallel", 3, 0 },
+  { "distributed", 1, 0 },
+  { "distributed", 2, 0 },
+  { "distributed", 3, 0 },
+  { "blocked", 1, 1 },
+  { "blocked", 1, 4 },
+  { "blocked", 1, 0 },
+  { "tiled", 1, 0 },
+  { "hashlife", 1, 0 },
+  { "sparse", 1, 0 },
+  { "generations", 1, 0 }
+};
+
+static const char *const rules[] = { "B3/S23", "B36/S23", "B2/S", "B3678/S34678", "B2/S/C3",
+                                     "B2/S345/C4" };
+
+/** only failures are printed: there are over a thousand checks **/
+static void report(const std::string &name, const std::string &failure)
+{
+  testReport(name, failure, true);
+}
+
+/*********************************************************************
+ ** Function: Check Engine
+ ** Description: runs start through one engine case next to the oracle for
+ RUN_GENERATIONS generations. Combinations makeEngine() turns down (a
+ topology or rule the engine does not support) are skipped.
+ *********************************************************************/
+static void checkEngine(const EngineCase &engineCase, const Grid &start, Topology topology,
+                        const Rule &rule, const std::string &label)
+{
+  const std::string name = std::string(engineCase.name) + "/" + std::to_string(engineCase.threads)
+                           + " threads/depth " + std::to_string(engineCase.depth) + "/"
+                           + topologyName(topology) + "/" + rule.notation() + "/"
+                           + simdLevelName(activeSimdLevel()) + "/" + label;
+  std::unique_ptr<Engine> engine;
+
+  try
+  {
+    engine = makeEngine(engineCase.name, start.rows(), start.columns(), engineCase.threads,
+                        topology, rule, engineCase.depth);
+  }
+  catch (const std::invalid_argument &)
+  {
+    return;
+  }
+
+  OracleBoard oracle = OracleBoard::forEngine(engineCase.name, start.rows(), start.columns(),
+                                              topology, rule, RUN_GENERATIONS);
+  engine->load(start);
+  oracle.load(start);
+
+  std::string failure = oracleDifference(*engine, oracle);
+  for (int g = 0; g < SINGLE_STEPS && failure.empty(); g++)
+  {
+    engine->step(1);
+    oracle.step();
+    failure = oracleDifference(*engine, oracle);
+  }
+  for (int i = 0; i < LONG_STEPS && failure.empty(); i++)
+  {
+    engine->step(longSteps[i]);
+    for (int g = 0; g < longSteps[i]; g++)
+      oracle.step();
+    failure = oracleDifference(*engine, oracle);
+  }
+  report(name, failure);
+}
+
+/*********************************************************************
+ ** Function: Check Classic
+ ** Description: a built in pattern on the classic char board, stepped by the
+ original updateGame() (referenceUpdate()), by today's updateGame() and by an
+ OracleBoard; all three must agree every generation
+ *********************************************************************/
+static void checkClassic(int pattern)
+{
+  char reference[ROWS][COLUMNS], referenceNext[ROWS][COLUMNS],
+       current[ROWS][COLUMNS], next[ROWS][COLUMNS];
+  Grid start(ROWS, COLUMNS);
+  OracleBoard oracle(ROWS, COLUMNS, TOPOLOGY_BOUNDED, Rule());
+
+  seedGameboard(reference, pattern);
+  seedGameboard(current, pattern);
+  seedGameboard(start, pattern);
+  oracle.load(start);
+
+  std::string failure;
+  for (int g = 1; g <= 100 && failure.empty(); g++)
+  {
+    referenceUpdate(reference, referenceNext);
+    updateGame(current, next);
+    oracle.step();
+
+    for (int r = 0; r < ROWS && failure.empty(); r++)
+      for (int c = 0; c < COLUMNS && failure.empty(); c++)
+        if (current[r][c] != reference[r][c] || (oracle.get(r, c) == 1) != (reference[r][c] == 'x'))
+          failure = "cell (" + std::to_string(r) + ", " + std::to_string(c)
+                    + ") differs at generation " + std::to_string(g);
+  }
+  report(std::string("classic/") + patternEntry(pattern - 1).name, failure);
+}
+
+/** every engine case under every rule and topology **/
+static void checkBoard(const Grid &start, const std::string &label)
+{
+  const Topology topologies[] = { TOPOLOGY_BOUNDED, TOPOLOGY_TORUS };
+
+  for (int t = 0; t < 2; t++)
+    for (std::size_t r = 0; r < sizeof(rules) / sizeof(rules[0]); r++)
+      for (std::size_t e = 0; e < sizeof(engineCases) / sizeof(engineCases[0]); e++)
+        checkEngine(engineCases[e], start, topologies[t], Rule::parse(rules[r]), label);
+}
+
+/** a rows x columns soup as a Grid **/
+static Grid soup(int rows, int columns, double density, uint64_t seed)
+{
+  BitGrid bits(rows, columns);
+  Grid grid(rows, columns);
+
+  fillSoup(bits, density, seed);
+  unpackGrid(bits, grid);
+  return grid;
+}
+
+int main()
+{
+  for (int p = 1; p <= patternCount(); p++)
+    checkClassic(p);
+
+  /** the narrower SIMD kernels on the soups that span several words **/
+  const SimdLevel widest = detectSimdLevel();
+  for (int level = SIMD_SCALAR; level < widest; level++)
+  {
+    setSimdLevel((SimdLevel)level);
+    checkBoard(soup(20, 130, 0.35, 1), "soup 20x130");
+    checkBoard(soup(16, 64, 0.5, 2), "soup 16x64");
+  }
+  setSimdLevel(widest);
+
+  for (int p = 1; p <= patternCount(); p++)
+  {
+    Grid start(ROWS, COLUMNS);
+    seedGameboard(start, p);
+    checkBoard(start, patternEntry(p - 1).name);
+  }
+
+  /** soups: two words and a bit wide, a word wide, one row, one column, smaller than a cell's neighborhood **/
+  checkBoard(soup(20, 130, 0.35, 1), "soup 20x130");
+  checkBoard(soup(16, 64, 0.5, 2), "soup 16x64");
+  checkBoard(soup(1, 70, 0.6, 3), "soup 1x70");
+  checkBoard(soup(70, 1, 0.6, 4), "soup 70x1");
+  checkBoard(soup(2, 3, 0.7, 5), "soup 2x3");
+
+  return testSummary("oracle");
+}
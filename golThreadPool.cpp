@@ -0,0 +1,224 @@
+/**************************************************************************************************
+ ** Program       Filename: GameOfLife
+ ** Current       File: golThreadPool.cpp
+ ** Author:       Jordan Grant
+ ** Date:         10.17.26
+ ** Description: 	Persistent worker threads and a generation barrier (see golThreadPool.hpp).
+ *****************************************************************************************************/
+
+#include "golThreadPool.hpp"
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdexcept>
+
+Barrier::Barrier(int count)
+  : count(count), waiting(0), phase(0)
+{
+}
+
+/*********************************************************************
+ ** Function: Barrier::wait
+ ** Description: the last thread to arrive resets the count and flips the phase,
+ releasing everyone who is waiting on the old phase
+ *********************************************************************/
+void Barrier::wait()
+{
+  unsigned current = phase.load(std::memory_order_acquire);
+
+  if (waiting.fetch_add(1, std::memory_order_acq_rel) + 1 == count)
+  {
+    waiting.store(0, std::memory_order_relaxed);
+    phase.fetch_add(1, std::memory_order_release);
+    return;
+  }
+
+  for (int spins = 0; phase.load(std::memory_order_acquire) == current; spins++)
+  {
+    if (spins >= 128)
+      std::this_thread::yield();
+  }
+}
+
+int hardwareThreads()
+{
+  cpu_set_t set;
+
+  if (sched_getaffinity(0, sizeof(set), &set) == 0)
+  {
+    int count = CPU_COUNT(&set);
+    if (count > 0)
+      return count;
+  }
+
+  unsigned count = std::thread::hardware_concurrency();
+  return count > 0 ? (int)count : 1;
+}
+
+/** binds a thread to the index-th CPU in this process's affinity mask **/
+static void pinThread(std::thread &thread, int index)
+{
+  cpu_set_t allowed, target;
+
+  if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0)
+    return;
+
+  int cpus = CPU_COUNT(&allowed);
+  if (cpus <= 0)
+    return;
+
+  int wanted = index % cpus;
+  for (int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+  {
+    if (!CPU_ISSET(cpu, &allowed))
+      continue;
+    if (wanted-- == 0)
+    {
+      CPU_ZERO(&target);
+      CPU_SET(cpu, &target);
+      pthread_setaffinity_np(thread.native_handle(), sizeof(target), &target);
+      return;
+    }
+  }
+}
+
+ThreadPool::ThreadPool(int threads, bool pin)
+  : task(NULL), context(NULL), job(0), remaining(0), stopping(false)
+{
+  if (threads <= 0)
+    throw std::invalid_argument("ThreadPool needs at least one thread");
+
+  workers.reserve(threads);
+  for (int i = 0; i < threads; i++)
+  {
+    workers.push_back(std::thread(&ThreadPool::workerLoop, this, i));
+    if (pin)
+      pinThread(workers.back(), i);
+  }
+}
+
+ThreadPool::~ThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  wake.notify_all();
+
+  for (std::size_t i = 0; i < workers.size(); i++)
+    workers[i].join();
+}
+
+/*********************************************************************
+ ** Function: ThreadPool::run
+ ** Description: publishes a new job, wakes every worker and blocks until the
+ last one reports back
+ *********************************************************************/
+void ThreadPool::run(Task newTask, void *newContext)
+{
+  std::unique_lock<std::mutex> lock(mutex);
+
+  task = newTask;
+  context = newContext;
+  remaining = size();
+  job++;
+  wake.notify_all();
+
+  while (remaining > 0)
+    done.wait(lock);
+}
+
+void ThreadPool::workerLoop(int index)
+{
+  unsigned seen = 0;
+
+  for (;;)
+  {
+    Task current;
+    void *currentContext;
+
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      while (!stopping && job == seen)
+        wake.wait(lock);
+      if (stopping)
+        return;
+      seen = job;
+      current = task;
+      currentContext = context;
+    }
+
+    current(currentContext, index);
+
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (--remaining == 0)
+        done.notify_one();
+    }
+  }
+}
+
+WorkStealer::WorkStealer(long long count, int workers)
+  : ranges(new Range[workers > 0 ? workers : 1]), workerCount(workers), steals(0)
+{
+  if (workers <= 0)
+    throw std::invalid_argument("WorkStealer needs at least one worker");
+
+  for (int i = 0; i < workers; i++)
+  {
+    ranges[i].first = count * i / workers;
+    ranges[i].end = count * (i + 1) / workers;
+  }
+}
+
+bool WorkStealer::next(int worker, long long &index)
+{
+  for (;;)
+  {
+    {
+      Range &own = ranges[worker];
+      std::lock_guard<std::mutex> lock(own.lock);
+      if (own.first < own.end)
+      {
+        index = own.first++;
+        return true;
+      }
+    }
+    if (!steal(worker))
+      return false;
+  }
+}
+
+/*********************************************************************
+ ** Function: WorkStealer::steal
+ ** Description: moves the back half (rounded up) of the first other range
+ with work left into worker's empty range. Only one lock is held at a time:
+ the stolen indices are taken out of the victim before they are put in the
+ thief's range, so no index is in two ranges at once. Returns false when no
+ range has work left.
+ *********************************************************************/
+bool WorkStealer::steal(int worker)
+{
+  for (int offset = 1; offset < workerCount; offset++)
+  {
+    Range &victim = ranges[(worker + offset) % workerCount];
+    long long first, end;
+    {
+      std::lock_guard<std::mutex> lock(victim.lock);
+      long long left = victim.end - victim.first;
+      if (left <= 0)
+        continue;
+      end = victim.end;
+      first = end - (left + 1) / 2;
+      victim.end = first;
+    }
+
+    Range &own = ranges[worker];
+    std::lock_guard<std::mutex> lock(own.lock);
+    own.first = first;
+    own.end = end;
+    steals.fetch_add(1, std::memory_order_relaxed);
+    return true;
+  }
+  return false;
+}
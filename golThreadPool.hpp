@@ -0,0 +1,125 @@
+/************************************************************************************************
+ ** Program       Filename: GameOfLife
+ ** Current       File: golThreadPool.hpp
+ ** Author:       Jordan Grant
+ ** Date:         10.17.26
+ ** Description: 	Persistent worker threads and a generation barrier. The workers are
+ started once and parked between jobs, so stepping many generations costs one wake up
+ per job rather than one thread launch per generation. Jobs made of many uneven
+ pieces share them out through a WorkStealer.
+ **************************************************************************************************/
+
+
+#ifndef GOLTHREADPOOL_HPP
+#define GOLTHREADPOOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*********************************************************************
+ ** Class: Barrier
+ ** Description: reusable sense-reversing barrier for a fixed number of threads.
+ Waiters spin briefly and then yield, which keeps the hand-off between
+ generations short without starving an oversubscribed machine.
+ *********************************************************************/
+class Barrier
+{
+public:
+  explicit Barrier(int count);
+
+  void wait();
+
+private:
+  const int count;
+  std::atomic<int> waiting;
+  std::atomic<unsigned> phase;
+};
+
+/*********************************************************************
+ ** Class: ThreadPool
+ ** Description: fixed set of worker threads. run() hands the same task to every
+ worker (each gets its own index) and returns when all of them have finished.
+ When pinning is requested, worker i is bound to the i-th CPU this process may
+ run on.
+ ** Pre-Conditions: threads must be positive; run() must not be called from
+ inside a task
+ *********************************************************************/
+class ThreadPool
+{
+public:
+  typedef void (*Task)(void *context, int worker);
+
+  ThreadPool(int threads, bool pin);
+  ~ThreadPool();
+
+  int size() const { return (int)workers.size(); }
+  void run(Task task, void *context);
+
+private:
+  ThreadPool(const ThreadPool &);
+  ThreadPool &operator=(const ThreadPool &);
+
+  void workerLoop(int index);
+
+  std::vector<std::thread> workers;
+  std::mutex mutex;
+  std::condition_variable wake;
+  std::condition_variable done;
+  Task task;
+  void *context;
+  unsigned job;
+  int remaining;
+  bool stopping;
+};
+
+/*********************************************************************
+ ** Class: WorkStealer
+ ** Description: hands out the indices 0 .. count - 1 to a fixed number of
+ workers for jobs that take uneven time. Each worker starts with an equal
+ share as a range of its own and takes indices from the front of it; a
+ worker whose range runs out steals the back half of the first other range
+ with work left, so a slow share is split up instead of finished alone.
+ Every index is handed out exactly once.
+ ** Pre-Conditions: workers must be positive; each worker index is used by
+ one thread at a time
+ *********************************************************************/
+class WorkStealer
+{
+public:
+  WorkStealer(long long count, int workers);
+
+  /** the next index for worker, or false once every index is handed out **/
+  bool next(int worker, long long &index);
+
+  long long stolen() const { return steals.load(std::memory_order_relaxed); }
+
+private:
+  WorkStealer(const WorkStealer &);
+  WorkStealer &operator=(const WorkStealer &);
+
+  /** [first, end) left to do, padded to a cache line so owners do not contend **/
+  struct alignas(64) Range
+  {
+    std::mutex lock;
+    long long first;
+    long long end;
+  };
+
+  bool steal(int worker);
+
+  std::unique_ptr<Range[]> ranges;
+  int workerCount;
+  std::atomic<long long> steals;
+};
+
+/*********************************************************************
+ ** Function: Hardware Threads
+ ** Description: number of CPUs this process is allowed to run on (at least 1)
+ *********************************************************************/
+int hardwareThreads();
+
+#endif
@@ -0,0 +1,159 @@
+/**************************************************************************************************
+ ** Program       Filename: GameOfLife
+ ** Current       File: golTiles.cpp
+ ** Author:       Jordan Grant
+ ** Date:         10.17.26
+ ** Description: 	Active region tracking (see golTiles.hpp). Each generation walks only
+ the list of tiles that changed last time, marks them and their neighbors active
+ (deduplicated with a generation stamp instead of clearing a flag array), and steps
+ just those tiles. Work is proportional to the active area, not the board.
+ *****************************************************************************************************/
+
+#include "golTiles.hpp"
+#include "golCycle.hpp"
+#include "golStats.hpp"
+
+#include <stdexcept>
+
+TiledEngine::TiledEngine(int rows, int columns, const Rule &rule)
+  : Engine(rows, columns, rule), current(0), tileRows(0), tileColumns(0), stamp(0),
+    computed(0), skipped(0), lastActive(0)
+{
+  grids[0] = BitGrid(rows, columns);
+  grids[1] = BitGrid(rows, columns);
+
+  tileRows = (rows + TILE_ROWS - 1) / TILE_ROWS;
+  tileColumns = (int)((grids[0].words() + TILE_WORDS - 1) / TILE_WORDS);
+
+  changedTiles.reserve(tileCount());
+  activeTiles.reserve(tileCount());
+  activeStamp.assign(tileCount(), 0);
+}
+
+/*********************************************************************
+ ** Function: TiledEngine::loadBits
+ ** Description: both buffers get the board and every tile starts out changed,
+ so the first generation is a full recompute
+ *********************************************************************/
+void TiledEngine::loadBits(const BitGrid &board)
+{
+  if (board.rows() != rowCount || board.columns() != columnCount)
+    throw std::invalid_argument("TiledEngine::loadBits: board dimensions differ");
+
+  grids[0] = board;
+  grids[1] = board;
+  current = 0;
+
+  changedTiles.clear();
+  for (int tile = 0; tile < tileCount(); tile++)
+    changedTiles.push_back(tile);
+
+  generationCount = 0;
+  computed = skipped = lastActive = 0;
+  hashing = false;
+}
+
+void TiledEngine::storeBits(BitGrid &board) const
+{
+  board = grids[current];
+}
+
+long long TiledEngine::population() const
+{
+  return grids[current].population();
+}
+
+std::size_t TiledEngine::memoryBytes() const
+{
+  return grids[0].bufferBytes() + grids[1].bufferBytes()
+         + (changedTiles.capacity() + activeTiles.capacity()) * sizeof(int)
+         + activeStamp.capacity() * sizeof(unsigned);
+}
+
+/** skipped tiles did not change, so the computed ones carry the whole hash change **/
+uint64_t TiledEngine::hash()
+{
+  if (!hashing)
+  {
+    boardHash = hashBitGrid(grids[current]);
+    hashing = true;
+  }
+  return boardHash;
+}
+
+void TiledEngine::step(long long generations)
+{
+  for (long long g = 0; g < generations; g++)
+    stepOnce();
+}
+
+/*********************************************************************
+ ** Function: TiledEngine::computeTile
+ ** Description: steps one tile into the other buffer
+ ** Post-Conditions: returns true if any of its cells changed
+ *********************************************************************/
+bool TiledEngine::computeTile(int tile)
+{
+  const BitGrid &from = grids[current];
+  BitGrid &to = grids[current ^ 1];
+
+  int firstRow = tile / tileColumns * TILE_ROWS,
+      lastRow = firstRow + TILE_ROWS < rowCount ? firstRow + TILE_ROWS : rowCount;
+  std::size_t firstWord = (std::size_t)(tile % tileColumns) * TILE_WORDS,
+              lastWord = firstWord + TILE_WORDS < from.words() ? firstWord + TILE_WORDS
+                                                               : from.words();
+  uint64_t changed = 0;
+
+  for (int r = firstRow; r < lastRow; r++)
+    changed |= stepBitSpan(from, to, r, firstWord, lastWord, lifeRule,
+                           hashing ? &boardHash : NULL);
+
+  return changed != 0;
+}
+
+void TiledEngine::stepOnce()
+{
+  /** stamp 0 means "never active", so skip it when the counter wraps **/
+  if (++stamp == 0)
+  {
+    activeStamp.assign(activeStamp.size(), 0);
+    stamp = 1;
+  }
+
+  activeTiles.clear();
+  for (std::size_t i = 0; i < changedTiles.size(); i++)
+  {
+    int ty = changedTiles[i] / tileColumns,
+        tx = changedTiles[i] % tileColumns;
+
+    for (int y = ty - 1; y <= ty + 1; y++)
+    {
+      if (y < 0 || y >= tileRows)
+        continue;
+      for (int x = tx - 1; x <= tx + 1; x++)
+      {
+        if (x < 0 || x >= tileColumns)
+          continue;
+        int tile = y * tileColumns + x;
+        if (activeStamp[tile] != stamp)
+        {
+          activeStamp[tile] = stamp;
+          activeTiles.push_back(tile);
+        }
+      }
+    }
+  }
+
+  changedTiles.clear();
+  for (std::size_t i = 0; i < activeTiles.size(); i++)
+    if (computeTile(activeTiles[i]))
+      changedTiles.push_back(activeTiles[i]);
+
+  current ^= 1;
+  generationCount++;
+  lastActive = (long long)activeTiles.size();
+  GOL_STAT_ADD(STAT_TILE_STEPS, (uint64_t)lastActive);
+  GOL_STAT_SET(STAT_ACTIVE_TILES, lastActive);
+  computed += lastActive;
+  skipped += tileCount() - lastActive;
+}
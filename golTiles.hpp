@@ -0,0 +1,66 @@
+/************************************************************************************************
+ ** Program       Filename: GameOfLife
+ ** Current       File: golTiles.hpp
+ ** Author:       Jordan Grant
+ ** Date:         10.17.26
+ ** Description: 	Active region tracking for bit packed boards. The board is divided into
+ tiles of TILE_ROWS rows by TILE_WORDS words. A tile is recomputed only if it, or one
+ of its eight neighbors, changed in the previous generation; every other tile is
+ known to be unchanged and is skipped. A skipped tile already holds the right cells
+ in both generation buffers (it was last computed without changing), so skipping is
+ exact and the result matches a full recompute.
+ **************************************************************************************************/
+
+
+#ifndef GOLTILES_HPP
+#define GOLTILES_HPP
+
+#include <vector>
+#include "golEngine.hpp"
+
+#define TILE_ROWS 64
+#define TILE_WORDS 8
+
+/*********************************************************************
+ ** Class: TiledEngine
+ ** Description: BitEngine that only steps active tiles, with counters of how
+ many tiles were computed and skipped
+ *********************************************************************/
+class TiledEngine : public Engine
+{
+public:
+  TiledEngine(int rows, int columns, const Rule &rule = Rule());
+
+  const char *name() const { return "tiled"; }
+  void loadBits(const BitGrid &board);
+  void storeBits(BitGrid &board) const;
+  void step(long long generations);
+  long long population() const;
+  std::size_t memoryBytes() const;
+  uint64_t hash();
+
+  /** totals since the last load **/
+  long long tilesComputed() const { return computed; }
+  long long tilesSkipped() const { return skipped; }
+  /** tiles computed by the most recent generation **/
+  long long tilesActive() const { return lastActive; }
+  long long tileCount() const { return (long long)tileRows * tileColumns; }
+
+private:
+  void stepOnce();
+  bool computeTile(int tile);
+
+  BitGrid grids[2];
+  int current;
+  int tileRows;
+  int tileColumns;
+  std::vector<int> changedTiles;
+  std::vector<int> activeTiles;
+  std::vector<unsigned> activeStamp;
+  unsigned stamp;
+  long long computed;
+  long long skipped;
+  long long lastActive;
+};
+
+#endif